@@ -0,0 +1,180 @@
+#include "AsyncLogger.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QThread>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+AsyncLogger& AsyncLogger::instance()
+{
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger()
+    : m_slots(new Slot[Capacity])
+{
+    for (size_t i = 0; i < Capacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    stop();
+}
+
+const char* AsyncLogger::levelName(LogLevel level)
+{
+    switch (level) {
+        case LOG_DEBUG: return "DEBUG";
+        case LOG_INFO:  return "INFO";
+        case LOG_WARN:  return "WARN";
+        case LOG_ERROR: return "ERROR";
+        default:        return "INFO";
+    }
+}
+
+bool AsyncLogger::start(const QString& filePath)
+{
+    if (m_running.load(std::memory_order_acquire)) {
+        return true;
+    }
+
+    auto file = std::make_unique<QFile>(filePath);
+    if (!file->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    m_file = std::move(file);
+
+    m_running.store(true, std::memory_order_release);
+    try {
+        m_writer = std::thread(&AsyncLogger::writerLoop, this);
+    } catch (const std::exception&) {
+        m_running.store(false, std::memory_order_release);
+        m_file.reset();
+        return false;
+    }
+    return true;
+}
+
+void AsyncLogger::stop()
+{
+    if (!m_running.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wake.notify_one();
+    if (m_writer.joinable()) {
+        m_writer.join();
+    }
+    m_file.reset();
+}
+
+void AsyncLogger::log(LogLevel level, const QString& message)
+{
+    if (!isEnabled(level) || !m_running.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    Record record;
+    record.level = level;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.threadId = reinterpret_cast<quintptr>(QThread::currentThreadId());
+    record.message = message;
+
+    if (!tryEnqueue(std::move(record))) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Errors should reach the file before a possible crash
+    if (level >= LOG_ERROR) {
+        m_wake.notify_one();
+    }
+}
+
+bool AsyncLogger::tryEnqueue(Record&& record)
+{
+    size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_slots[pos & Mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            // Slot is free for this position; claim it
+            if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                slot.record = std::move(record);
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (diff < 0) {
+            // The writer has not consumed this slot yet: ring is full
+            return false;
+        } else {
+            pos = m_enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool AsyncLogger::tryDequeue(Record& out)
+{
+    Slot& slot = m_slots[m_dequeuePos & Mask];
+    const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != m_dequeuePos + 1) {
+        return false;
+    }
+    out = std::move(slot.record);
+    slot.record.message = QString();
+    slot.sequence.store(m_dequeuePos + Capacity, std::memory_order_release);
+    ++m_dequeuePos;
+    return true;
+}
+
+void AsyncLogger::writerLoop()
+{
+    QByteArray batch;
+    quint64 reportedDropped = 0;
+    Record record;
+
+    auto drain = [&]() {
+        batch.clear();
+        while (tryDequeue(record)) {
+            const QString line = QString("[%1] [Thread:0x%2] %3: %4\n")
+                .arg(QDateTime::fromMSecsSinceEpoch(record.timestamp).toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                .arg(record.threadId, 0, 16)
+                .arg(QString::fromLatin1(levelName(record.level)), record.message);
+            batch += line.toUtf8();
+        }
+
+        const quint64 dropped = m_dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped) {
+            batch += QString("[%1] WARN: %2 log messages dropped (queue full)\n")
+                .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                .arg(dropped - reportedDropped).toUtf8();
+            reportedDropped = dropped;
+        }
+
+        if (!batch.isEmpty()) {
+            m_file->write(batch);
+            m_file->flush();
+            // Output to console for debugging (only in debug builds)
+            #ifdef _DEBUG
+            std::cout << batch.constData() << std::flush;
+            #endif
+        }
+    };
+
+    while (m_running.load(std::memory_order_acquire)) {
+        drain();
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, std::chrono::milliseconds(FlushIntervalMs));
+    }
+
+    // Producers that raced with stop() may still have published records
+    drain();
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+// Undefine Windows macros that conflict with our enum
+#ifdef _WIN32
+    #ifdef ERROR
+        #undef ERROR
+    #endif
+    #ifdef DEBUG
+        #undef DEBUG
+    #endif
+    #ifdef INFO
+        #undef INFO
+    #endif
+    #ifdef WARN
+        #undef WARN
+    #endif
+#endif
+
+#include <QString>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class QFile;
+
+// Log Level Enumeration for filtering
+enum LogLevel {
+    LOG_DEBUG = 0,
+    LOG_INFO = 1,
+    LOG_WARN = 2,
+    LOG_ERROR = 3
+};
+
+// Default log level - can be overridden by CMake
+#ifdef FORCE_DEBUG_LOGS
+    #define DEFAULT_LOG_LEVEL LOG_DEBUG
+#else
+    #ifdef NDEBUG
+        #define DEFAULT_LOG_LEVEL LOG_INFO
+    #else
+        #define DEFAULT_LOG_LEVEL LOG_DEBUG
+    #endif
+#endif
+
+// Levels below this are compiled out of LOG_AT call sites
+constexpr LogLevel CompiledMinLogLevel = DEFAULT_LOG_LEVEL;
+
+/**
+ * @brief Process-wide log writer with a lock-free front end
+ *
+ * log() stamps the message and pushes it into a bounded multi-producer ring
+ * (per-slot sequence numbers, no locks on the calling thread). A single
+ * writer thread keeps the log file open, drains the ring in batches and
+ * flushes once per batch. If the ring is full the message is dropped and
+ * counted; the writer reports the count in the file.
+ *
+ * Messages logged before start() or after stop() are discarded.
+ */
+class AsyncLogger
+{
+public:
+    static AsyncLogger& instance();
+
+    /**
+     * @brief Open the log file for appending and start the writer thread
+     */
+    bool start(const QString& filePath);
+
+    /**
+     * @brief Write everything still queued, close the file and join the writer
+     */
+    void stop();
+
+    /**
+     * @brief Queue one line; never blocks on file I/O
+     */
+    void log(LogLevel level, const QString& message);
+
+    static constexpr bool isEnabled(LogLevel level) { return level >= CompiledMinLogLevel; }
+    static const char* levelName(LogLevel level);
+
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    AsyncLogger();
+    ~AsyncLogger();
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    // Power of two so positions map to slots with a mask
+    static constexpr size_t Capacity = 8192;
+    static constexpr size_t Mask = Capacity - 1;
+    // Writer wakes at least this often to drain the ring
+    static constexpr int FlushIntervalMs = 50;
+
+    struct Record
+    {
+        LogLevel level = LOG_INFO;
+        qint64 timestamp = 0;           // ms since epoch
+        quintptr threadId = 0;
+        QString message;
+    };
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence{0};
+        Record record;
+    };
+
+    bool tryEnqueue(Record&& record);
+    bool tryDequeue(Record& out);
+    void writerLoop();
+
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<size_t> m_enqueuePos{0};
+    alignas(64) size_t m_dequeuePos = 0;   // Writer thread only
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<bool> m_running{false};
+
+    std::unique_ptr<QFile> m_file;      // Written by the writer thread only
+    std::thread m_writer;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+};
+
+/**
+ * @brief Log through AsyncLogger; levels below CompiledMinLogLevel are
+ *        discarded at compile time, so their message is never built
+ */
+#define LOG_AT(level, message) \
+    do { \
+        if constexpr (AsyncLogger::isEnabled(level)) { \
+            AsyncLogger::instance().log((level), (message)); \
+        } \
+    } while (0)
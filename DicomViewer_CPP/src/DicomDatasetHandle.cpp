@@ -0,0 +1,121 @@
+#include "DicomDatasetHandle.h"
+#include "PerfTrace.h"
+#include <QFileInfo>
+#include <QMutexLocker>
+
+QMutex DicomDatasetHandle::s_registryMutex;
+QWaitCondition DicomDatasetHandle::s_loadFinished;
+QHash<QString, DicomDatasetHandle::RegistryEntry> DicomDatasetHandle::s_registry;
+
+DicomDatasetHandle::DicomDatasetHandle(const QString& filePath)
+    : m_filePath(filePath)
+{
+}
+
+DicomDatasetHandle::~DicomDatasetHandle()
+{
+}
+
+std::shared_ptr<DicomDatasetHandle> DicomDatasetHandle::open(const QString& filePath)
+{
+    if (filePath.isEmpty()) {
+        return nullptr;
+    }
+
+    QString key = QFileInfo(filePath).absoluteFilePath();
+
+    QMutexLocker locker(&s_registryMutex);
+    for (;;) {
+        auto it = s_registry.find(key);
+        if (it == s_registry.end()) {
+            break;
+        }
+        if (it->loading) {
+            // Another thread is parsing this file - share its result
+            s_loadFinished.wait(&s_registryMutex);
+            continue;
+        }
+        std::shared_ptr<DicomDatasetHandle> existing = it->handle.lock();
+        if (existing) {
+            return existing;
+        }
+        s_registry.erase(it);
+        break;
+    }
+
+    pruneExpiredLocked();
+
+    // Claim the path, then parse without holding the registry lock so
+    // opens of other files are not held up by this one
+    RegistryEntry pending;
+    pending.loading = true;
+    s_registry.insert(key, pending);
+    locker.unlock();
+
+    std::shared_ptr<DicomDatasetHandle> handle(new DicomDatasetHandle(filePath));
+    const bool loaded = handle->load();
+
+    locker.relock();
+    if (loaded) {
+        RegistryEntry entry;
+        entry.handle = handle;
+        s_registry.insert(key, entry);
+    } else {
+        // Waiters find no entry and try the file themselves
+        s_registry.remove(key);
+    }
+    s_loadFinished.wakeAll();
+    return loaded ? handle : nullptr;
+}
+
+std::shared_ptr<DicomDatasetHandle> DicomDatasetHandle::openPrivate(const QString& filePath)
+{
+    if (filePath.isEmpty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<DicomDatasetHandle> handle(new DicomDatasetHandle(filePath));
+    if (!handle->load()) {
+        return nullptr;
+    }
+    return handle;
+}
+
+void DicomDatasetHandle::pruneExpiredLocked()
+{
+    for (auto it = s_registry.begin(); it != s_registry.end();) {
+        if (!it->loading && it->handle.expired()) {
+            it = s_registry.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool DicomDatasetHandle::load()
+{
+#ifdef HAVE_DCMTK
+    PerfSpan span("DicomDatasetHandle::load", PerfStage::Parse);
+    
+    try {
+        m_fileFormat.reset(new DcmFileFormat());
+        OFCondition status = m_fileFormat->loadFile(m_filePath.toLocal8Bit().constData());
+
+        if (status.bad() || !m_fileFormat->getDataset()) {
+            m_fileFormat.reset();
+            return false;
+        }
+
+        return true;
+
+    } catch (const std::exception& e) {
+        m_fileFormat.reset();
+        return false;
+    } catch (...) {
+        m_fileFormat.reset();
+        return false;
+    }
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <QString>
+#include <QMutex>
+#include <QRecursiveMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <memory>
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmdata/dcfilefo.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+#endif
+
+/**
+ * @brief Reference-counted, thread-safe handle to a parsed DICOM file
+ *
+ * Opening an image used to parse the same file five or six times (viewer,
+ * overlay extraction, frame processor, progressive loader, playback setup).
+ * A handle parses the file once and is shared by all of them through
+ * std::shared_ptr. While any consumer still holds a handle, open() on the
+ * same path returns that instance instead of parsing again.
+ *
+ * Parsing runs outside the registry lock. A second open() of a path that is
+ * being parsed waits for that parse; opens of other paths never wait.
+ *
+ * The file is loaded with DCMTK's default lazy value loading, so large values
+ * such as Pixel Data are only read from disk when a consumer accesses them.
+ *
+ * DCMTK datasets are not safe for concurrent access. Callers must hold the
+ * handle's mutex while touching fileFormat() or dataset():
+ *
+ *     QMutexLocker locker(handle->mutex());
+ *     handle->dataset()->findAndGetUint16(DCM_Rows, rows);
+ */
+class DicomDatasetHandle
+{
+public:
+    ~DicomDatasetHandle();
+
+    /**
+     * @brief Open (or reuse) the parsed dataset for a file
+     * @param filePath Path to the DICOM file
+     * @return Shared handle, or nullptr if the file could not be parsed
+     */
+    static std::shared_ptr<DicomDatasetHandle> open(const QString& filePath);
+
+    /**
+     * @brief Parse a file into a handle of the caller's own
+     *
+     * The handle is not registered: it never waits on, or is shared with,
+     * other openers of the same path. For background work such as thumbnails
+     * that should not contend with the viewer for a dataset or its mutex.
+     *
+     * @param filePath Path to the DICOM file
+     * @return Handle, or nullptr if the file could not be parsed
+     */
+    static std::shared_ptr<DicomDatasetHandle> openPrivate(const QString& filePath);
+
+    const QString& filePath() const { return m_filePath; }
+
+    // Recursive so that helpers called with the lock held may lock again
+    QRecursiveMutex* mutex() const { return &m_mutex; }
+
+#ifdef HAVE_DCMTK
+    DcmFileFormat* fileFormat() const { return m_fileFormat.get(); }
+    DcmDataset* dataset() const { return m_fileFormat ? m_fileFormat->getDataset() : nullptr; }
+#endif
+
+private:
+    explicit DicomDatasetHandle(const QString& filePath);
+    bool load();
+
+    QString m_filePath;
+    mutable QRecursiveMutex m_mutex;
+
+#ifdef HAVE_DCMTK
+    std::unique_ptr<DcmFileFormat> m_fileFormat;
+#endif
+
+    struct RegistryEntry
+    {
+        std::weak_ptr<DicomDatasetHandle> handle;
+        bool loading = false;           // Parse in flight; other openers wait for it
+    };
+
+    // Drop entries whose handles have all been released
+    static void pruneExpiredLocked();
+
+    // Live handles by path so concurrent consumers share one parse
+    static QMutex s_registryMutex;
+    static QWaitCondition s_loadFinished;
+    static QHash<QString, RegistryEntry> s_registry;
+};
@@ -0,0 +1,118 @@
+#include "DicomFrameIterator.h"
+#include <QMutexLocker>
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#endif
+
+DicomFrameIterator::DicomFrameIterator()
+    :
+#ifdef HAVE_DCMTK
+      m_pixelData(nullptr),
+#endif
+      m_frameSize(0)
+    , m_frameCount(0)
+    , m_nextFrame(0)
+    , m_nextStartFragment(0)
+{
+}
+
+DicomFrameIterator::~DicomFrameIterator()
+{
+}
+
+bool DicomFrameIterator::open(const std::shared_ptr<DicomDatasetHandle>& dataset)
+{
+    m_dataset = dataset;
+    m_frameSize = 0;
+    m_frameCount = 0;
+    m_nextFrame = 0;
+    m_nextStartFragment = 0;
+    m_colorModel.clear();
+
+#ifdef HAVE_DCMTK
+    m_pixelData = nullptr;
+    if (!m_dataset) {
+        return false;
+    }
+
+    try {
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* ds = m_dataset->dataset();
+        DcmElement* element = nullptr;
+        if (!ds || ds->findAndGetElement(DCM_PixelData, element).bad() || !element ||
+            element->ident() != EVR_PixelData) {
+            return false;
+        }
+        m_pixelData = static_cast<DcmPixelData*>(element);
+
+        Sint32 frames = 1;
+        if (ds->findAndGetSint32(DCM_NumberOfFrames, frames).bad() || frames < 1) {
+            frames = 1;
+        }
+        m_frameCount = static_cast<unsigned long>(frames);
+
+        // Computed from the image attributes; no pixel data is read here
+        Uint32 frameSize = 0;
+        if (m_pixelData->getUncompressedFrameSize(ds, frameSize).bad() || frameSize == 0) {
+            m_pixelData = nullptr;
+            return false;
+        }
+        m_frameSize = frameSize;
+        return true;
+
+    } catch (...) {
+        m_pixelData = nullptr;
+        m_frameSize = 0;
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+bool DicomFrameIterator::decodeFrame(unsigned long frameNumber, QByteArray& samples)
+{
+#ifdef HAVE_DCMTK
+    if (!m_dataset || !m_pixelData || frameNumber >= m_frameCount) {
+        return false;
+    }
+
+    try {
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* ds = m_dataset->dataset();
+        if (!ds) {
+            return false;
+        }
+
+        // 0 lets the codec locate the frame itself (offset table or fragment count)
+        Uint32 startFragment = frameNumber == m_nextFrame ? static_cast<Uint32>(m_nextStartFragment) : 0;
+
+        samples.resize(static_cast<qsizetype>(m_frameSize));
+        OFString colorModel;
+        if (m_pixelData->getUncompressedFrame(ds, static_cast<Uint32>(frameNumber), startFragment,
+                                              samples.data(), static_cast<Uint32>(m_frameSize),
+                                              colorModel, &m_fileCache).bad()) {
+            m_nextFrame = 0;
+            m_nextStartFragment = 0;
+            return false;
+        }
+
+        // DCMTK advanced startFragment to the first fragment of the next frame
+        m_nextFrame = frameNumber + 1;
+        m_nextStartFragment = startFragment;
+        m_colorModel = QString::fromLatin1(colorModel.c_str());
+        return true;
+
+    } catch (...) {
+        m_nextFrame = 0;
+        m_nextStartFragment = 0;
+        return false;
+    }
+#else
+    Q_UNUSED(frameNumber)
+    Q_UNUSED(samples)
+    return false;
+#endif
+}
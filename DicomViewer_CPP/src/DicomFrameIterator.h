@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <memory>
+#include "DicomDatasetHandle.h"
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmdata/dcfcache.h"
+#include "dcmtk/dcmdata/dcpixel.h"
+#endif
+
+/**
+ * @brief Frame-by-frame decoder for pixel data DCMTK decompresses itself
+ *
+ * Covers the transfer syntaxes without a dedicated frame decoder (RLE,
+ * JPEG-LS, JPEG 2000 and any other codec registered with DCMTK). Frames are
+ * pulled from the already parsed dataset with DCMTK's partial-access API
+ * (DcmPixelData::getUncompressedFrame), so the file is neither reopened nor
+ * parsed again per frame:
+ * - the DcmFileCache keeps the file stream open between calls
+ * - the fragment that follows the last decoded frame is remembered, so
+ *   frames requested in increasing order skip the fragment search
+ * - the caller's sample buffer keeps its allocation from frame to frame
+ *
+ * Not safe for concurrent use: decodeFrame() holds the dataset lock for the
+ * whole decode, which also serializes access to the iterator's own state.
+ */
+class DicomFrameIterator
+{
+public:
+    DicomFrameIterator();
+    ~DicomFrameIterator();
+
+    /**
+     * @brief Prepare frame access for a dataset
+     * @return true if the dataset has Pixel Data with a known frame size
+     */
+    bool open(const std::shared_ptr<DicomDatasetHandle>& dataset);
+
+    bool isOpen() const { return m_frameSize > 0; }
+    unsigned long frameCount() const { return m_frameCount; }
+
+    /**
+     * @brief Decode one frame to stored values
+     * @param frameNumber Frame number (0-based)
+     * @param samples Receives the frame in host byte order, laid out as
+     *        decompressed (see decompressedColorModel())
+     * @return true if successful, false otherwise
+     */
+    bool decodeFrame(unsigned long frameNumber, QByteArray& samples);
+
+    /**
+     * @brief Photometric interpretation of the samples from the last decode
+     */
+    const QString& decompressedColorModel() const { return m_colorModel; }
+
+private:
+    std::shared_ptr<DicomDatasetHandle> m_dataset;
+
+#ifdef HAVE_DCMTK
+    DcmPixelData* m_pixelData;      // Owned by the dataset
+    DcmFileCache m_fileCache;
+#endif
+
+    unsigned long m_frameSize;      // Bytes per decompressed frame
+    unsigned long m_frameCount;
+
+    // First fragment of m_nextFrame, known after decoding the frame before it
+    unsigned long m_nextFrame;
+    unsigned long m_nextStartFragment;
+
+    QString m_colorModel;
+};
@@ -1,28 +1,28 @@
 ﻿#include "DicomFrameProcessor.h"
+#include "MappedPixelData.h"
+#include "PerfTrace.h"
 #include <QDebug>
+#include <QMutexLocker>
 #include <algorithm>
 #include <cmath>
-#include <chrono>
+#include <cstring>
 
 DicomFrameProcessor::DicomFrameProcessor()
-    : m_rawPixelData(nullptr)
-    , m_currentFrame(0)
+    : m_currentFrame(0)
     , m_rows(0)
     , m_cols(0)
     , m_bitsAllocated(8)
     , m_bitsStored(8)
     , m_highBit(7)
     , m_pixelRepresentation(0)
+    , m_samplesPerPixel(1)
     , m_numberOfFrames(1)
     , m_defaultWindowCenter(0.0)     // Medical imaging default instead of 8-bit display default
     , m_defaultWindowWidth(2000.0)   // Medical imaging default instead of 8-bit display default
     , m_rescaleSlope(1.0)
     , m_rescaleIntercept(0.0)
     , m_useGdcmMode(false)
-    , m_batchDecompressed(false)
-#ifdef HAVE_DCMTK
-    , m_fileFormat(nullptr)
-#endif
+    , m_isNativePixelData(false)
 #ifdef HAVE_GDCM
     , m_gdcmReader(nullptr)
     , m_gdcmImage(nullptr)
@@ -32,34 +32,38 @@ DicomFrameProcessor::DicomFrameProcessor()
 
 DicomFrameProcessor::~DicomFrameProcessor()
 {
-#ifdef HAVE_DCMTK
-    delete m_fileFormat;
-#endif
-
 #ifdef HAVE_GDCM
     delete m_gdcmReader;
     delete m_gdcmImage;
 #endif
 }
     
-bool DicomFrameProcessor::loadDicomFile(const QString& filePath)
+bool DicomFrameProcessor::loadDicomFile(const QString& filePath, LoadScope scope)
+{
+    std::shared_ptr<DicomDatasetHandle> dataset = DicomDatasetHandle::open(filePath);
+    if (!dataset) {
+        m_dataset.reset();
+        return false;
+    }
+    return loadDicomFile(dataset, scope);
+}
+
+bool DicomFrameProcessor::loadDicomFile(const std::shared_ptr<DicomDatasetHandle>& dataset, LoadScope scope)
 {
 #ifdef HAVE_DCMTK
-    auto loadStart = std::chrono::high_resolution_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(loadStart.time_since_epoch()).count();
+    // Metadata and frame index; the dataset itself was parsed by the handle
+    PerfSpan span("DicomFrameProcessor::loadDicomFile", PerfStage::Parse);
     
     try {
-        // Clean up any existing data
-        delete m_fileFormat;
-        m_fileFormat = nullptr;
-        m_rawPixelData = nullptr;
-        
-        // CRITICAL: Clean up batch decompression state when loading new file
-        m_batchDecompressed = false;
-        m_preDecompressedFrames.clear();
+        // Release any previously attached dataset
+        m_dataset.reset();
         
-        // Clear frame cache when loading new file
-        m_frameCache.clear();
+        // Drop the frame index, frame iterator and mapping of the previous file
+        m_frameDecoder.reset();
+        m_frameIterator.reset();
+        m_mappedPixels.reset();
+        m_useGdcmMode = false;
+        m_isNativePixelData = false;
         
 #ifdef HAVE_GDCM
         // Clean up GDCM resources properly
@@ -70,40 +74,53 @@ bool DicomFrameProcessor::loadDicomFile(const QString& filePath)
         m_gdcmPixelBuffer.clear();
 #endif
         
-        // Store the current file path for frame access
-        m_currentFilePath = filePath;
-        
-        // Load DICOM file
-        m_fileFormat = new DcmFileFormat();
-        OFCondition status = m_fileFormat->loadFile(filePath.toLocal8Bit().constData());
-        
-        if (status.bad()) {
-            delete m_fileFormat;
-            m_fileFormat = nullptr;
+        if (!dataset) {
             return false;
         }
         
+        // Attach the shared dataset - the file was already parsed by the handle
+        m_dataset = dataset;
+        m_currentFilePath = dataset->filePath();
+        const QString& filePath = m_currentFilePath;
+        
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        
         // Extract metadata
         if (!extractMetadata()) {
-            delete m_fileFormat;
-            m_fileFormat = nullptr;
+            m_dataset.reset();
             return false;
         }
         
         // Check transfer syntax for debugging and TurboJPEG compatibility
-        auto syntaxStart = std::chrono::high_resolution_clock::now();
-        auto syntaxTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(syntaxStart.time_since_epoch()).count();
-        
         OFString transferSyntax;
-        if (m_fileFormat->getMetaInfo()->findAndGetOFString(DCM_TransferSyntaxUID, transferSyntax).good()) {
+        if (m_dataset->fileFormat()->getMetaInfo()->findAndGetOFString(DCM_TransferSyntaxUID, transferSyntax).good()) {
+            
+            m_isNativePixelData = transferSyntax == "1.2.840.10008.1.2" ||
+                                  transferSyntax == "1.2.840.10008.1.2.1" ||
+                                  transferSyntax == "1.2.840.10008.1.2.2";
+            
+            // Little endian native frames are served as views of the mapped file
+            if (m_isNativePixelData && transferSyntax != "1.2.840.10008.1.2.2") {
+                mapNativePixelData(transferSyntax != "1.2.840.10008.1.2");
+            }
+            
+            // Index encapsulated JPEG frames so each one can be decoded on its own
+            if (EncapsulatedFrameDecoder::isSupportedTransferSyntax(QString::fromLatin1(transferSyntax.c_str()))) {
+                const bool firstFrameOnly = scope == LoadScope::FirstFrame;
+                m_frameDecoder.reset(new EncapsulatedFrameDecoder());
+                if (!m_frameDecoder->open(m_dataset, firstFrameOnly ? 1 : 0) ||
+                    (firstFrameOnly ? m_frameDecoder->frameCount() < 1
+                                    : m_frameDecoder->frameCount() != m_numberOfFrames)) {
+                    m_frameDecoder.reset();
+                }
+            }
             
             // Check specific JPEG formats and select optimal decoder
             if (transferSyntax == "1.2.840.10008.1.2.4.70") {
 #ifdef HAVE_GDCM
-                auto gdcmInitStart = std::chrono::high_resolution_clock::now();
-                auto gdcmTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(gdcmInitStart.time_since_epoch()).count();
-                
-                if (initializeGdcm(filePath)) {
+                // GDCM decodes the whole volume at once - only used when no frame index could be built,
+                // and never for a first-frame-only load
+                if (!m_frameDecoder && scope == LoadScope::AllFrames && initializeGdcm(filePath)) {
                     m_useGdcmMode = true;
                 } else {
                     m_useGdcmMode = false;
@@ -111,12 +128,10 @@ bool DicomFrameProcessor::loadDicomFile(const QString& filePath)
 #else
                 m_useGdcmMode = false;
 #endif
-            } else if (transferSyntax == "1.2.840.10008.1.2.4.50") {
-#ifdef HAVE_TURBOJPEG
-#endif
-            } else if (transferSyntax == "1.2.840.10008.1.2.4.51") {
-#ifdef HAVE_TURBOJPEG
-#endif
+            } else if (transferSyntax == "1.2.840.10008.1.2.4.50" ||
+                       transferSyntax == "1.2.840.10008.1.2.4.51") {
+                // Baseline/extended: the frame decoder indexed the fragments once above and
+                // decodes 8-bit frames with TurboJPEG when available
             } else if (transferSyntax.find("1.2.840.10008.1.2.4") != OFString_npos) {
 #ifdef HAVE_GDCM
 #endif
@@ -128,29 +143,26 @@ bool DicomFrameProcessor::loadDicomFile(const QString& filePath)
             m_useGdcmMode = false;
         }
         
-        auto loadEnd = std::chrono::high_resolution_clock::now();
-        auto loadDuration = std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd - loadStart).count();
-        auto endTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(loadEnd.time_since_epoch()).count();
-        
-        // For GDCM mode with multiple frames, pre-decompress all frames for optimal performance
-        if (m_useGdcmMode && m_numberOfFrames > 1) {
-            if (preDecompressAllFrames()) {
+        // Everything else DCMTK decompresses itself, one frame at a time from this dataset
+        if (!m_frameDecoder && !m_isNativePixelData && !m_useGdcmMode && m_samplesPerPixel == 1 &&
+            (m_bitsAllocated == 8 || m_bitsAllocated == 16)) {
+            m_frameIterator.reset(new DicomFrameIterator());
+            if (!m_frameIterator->open(m_dataset) || m_frameIterator->frameCount() != m_numberOfFrames) {
+                m_frameIterator.reset();
             }
         }
         
         return true;
         
     } catch (const std::exception& e) {
-        delete m_fileFormat;
-        m_fileFormat = nullptr;
+        m_dataset.reset();
         return false;
     } catch (...) {
-        delete m_fileFormat;
-        m_fileFormat = nullptr;
+        m_dataset.reset();
         return false;
     }
 #else
-    Q_UNUSED(filePath)
+    Q_UNUSED(dataset)
     return false;
 #endif
 }
@@ -158,37 +170,22 @@ bool DicomFrameProcessor::loadDicomFile(const QString& filePath)
 QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
 {
 #ifdef HAVE_DCMTK
-    auto totalStart = std::chrono::high_resolution_clock::now();
+    PerfSpan span("DicomFrameProcessor::getFrameAsQImage", PerfStage::None);
     
-    if (!m_fileFormat || frameNumber >= m_numberOfFrames) {
+    if (!m_dataset || frameNumber >= m_numberOfFrames) {
         return QImage();
     }
     
-    // Check batch decompressed frames first (fastest path)
-    if (m_batchDecompressed && 
-        frameNumber < static_cast<unsigned long>(m_preDecompressedFrames.size()) &&
-        frameNumber < m_numberOfFrames) {
-        
-        // Additional safety check for valid frame
-        const QImage& batchFrame = m_preDecompressedFrames[frameNumber];
-        if (!batchFrame.isNull()) {
-            auto batchTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(totalStart.time_since_epoch()).count();
-            return batchFrame;
-        } else {
-        }
-    }
-    
-    // Check frame cache second for performance
-    if (m_frameCache.contains(frameNumber)) {
-        const CachedFrame& cachedFrame = m_frameCache[frameNumber];
-        if (cachedFrame.isValid) {
-            auto cacheTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(totalStart.time_since_epoch()).count();
-            return cachedFrame.image;
-        }
-    }
-    
     try {
-        auto frameTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(totalStart.time_since_epoch()).count();
+        // Native data, encapsulated JPEG or the DCMTK frame iterator: read/decode just this frame
+        if (canDecodeConcurrently() || m_frameIterator) {
+            DicomPixelFrame pixels = decodePixelFrame(frameNumber);
+            if (!pixels.isNull()) {
+                m_currentFrame = frameNumber;
+                return pixelFrameToGrayscale8(pixels);
+            }
+            // Fall through to DCMTK processing
+        }
         
         // **CRITICAL FIX**: Use GDCM decompression when GDCM mode is active
         if (m_useGdcmMode) {
@@ -198,12 +195,14 @@ QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
             unsigned long outputSize = 0;
             if (decompressGdcmFrame(frameNumber, &frameBuffer, &outputSize)) {
                 // Create QImage from GDCM-decompressed data
-                QImage frameImage(m_cols, m_rows, QImage::Format_Grayscale8);
-                memcpy(frameImage.bits(), frameBuffer, m_cols * m_rows);
-                
-                auto totalEnd = std::chrono::high_resolution_clock::now();
-                auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(totalEnd - totalStart).count();
-                auto totalTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(totalEnd.time_since_epoch()).count();
+                QImage frameImage;
+                {
+                    PerfSpan convertSpan("samplesToGrayscale8", PerfStage::Convert);
+                    frameImage = samplesToGrayscale8(frameBuffer, m_bitsAllocated > 8 ? 2 : 1, m_cols, m_rows,
+                                                     m_bitsStored, m_pixelRepresentation == 1,
+                                                     m_photometricInterpretation == "MONOCHROME1");
+                }
+                delete[] frameBuffer;
                 
                 return frameImage;
             } else {
@@ -214,27 +213,20 @@ QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
 #endif
         }
         
-        // DCMTK processing (original code or GDCM fallback)
-        auto stepStart = std::chrono::high_resolution_clock::now();
-        // Use DicomImage constructor that takes file path for better compressed data handling
-        // This creates a fresh DicomImage instance for each frame, ensuring proper decompression
-        QString currentPath = m_currentFilePath;
-        
+        // DCMTK processing (colour data or GDCM fallback)
+        // Built on the already parsed dataset rather than the file path, so the file is not
+        // opened and parsed again; partial access reads only this frame's pixel data and
+        // leaves the shared dataset's representation untouched
+        QMutexLocker datasetLocker(m_dataset->mutex());
         DicomImage* dicomImage = nullptr;
         
-        if (m_numberOfFrames > 1) {
-            // For multi-frame images, specify the frame number
-            dicomImage = new DicomImage(currentPath.toLocal8Bit().constData(), 
-                                      CIF_AcrNemaCompatibility, frameNumber, frameNumber + 1);
-        } else {
-            // For single frame images
-            dicomImage = new DicomImage(currentPath.toLocal8Bit().constData(), CIF_AcrNemaCompatibility);
+        {
+            PerfSpan createSpan("DicomImage::DicomImage", PerfStage::Parse);
+            dicomImage = new DicomImage(m_dataset->fileFormat(), m_dataset->dataset()->getOriginalXfer(),
+                                        CIF_AcrNemaCompatibility | CIF_UsePartialAccessToPixelData,
+                                        frameNumber, 1);
         }
         
-        auto createTime = std::chrono::high_resolution_clock::now();
-        auto createDuration = std::chrono::duration_cast<std::chrono::milliseconds>(createTime - stepStart).count();
-        auto createTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(createTime.time_since_epoch()).count();
-        
         if (dicomImage == nullptr) {
             return QImage();
         }
@@ -245,10 +237,6 @@ QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
             return QImage();
         }
         
-        auto statusTime = std::chrono::high_resolution_clock::now();
-        auto statusDuration = std::chrono::duration_cast<std::chrono::milliseconds>(statusTime - createTime).count();
-        auto statusTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(statusTime.time_since_epoch()).count();
-        
         // Verify the image dimensions match our metadata
         unsigned long imageWidth = dicomImage->getWidth();
         unsigned long imageHeight = dicomImage->getHeight();
@@ -264,16 +252,12 @@ QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
         // if (dicomImage->setWindow(m_defaultWindowCenter, m_defaultWindowWidth) == 0) {
         // }
         
-        auto windowTime = std::chrono::high_resolution_clock::now();
-        auto windowDuration = std::chrono::duration_cast<std::chrono::milliseconds>(windowTime - statusTime).count();
-        auto windowTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(windowTime.time_since_epoch()).count();
-        
         // Get the processed pixel data as 8-bit grayscale - THIS IS THE DECOMPRESSION STEP
-        auto decompressionStart = std::chrono::high_resolution_clock::now();
-        const void* pixelData = dicomImage->getOutputData(8 /* bits per sample */);
-        auto decompressionEnd = std::chrono::high_resolution_clock::now();
-        auto decompressionDuration = std::chrono::duration_cast<std::chrono::milliseconds>(decompressionEnd - decompressionStart).count();
-        auto decompressionTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(decompressionEnd.time_since_epoch()).count();
+        const void* pixelData = nullptr;
+        {
+            PerfSpan decodeSpan("DicomImage::getOutputData", PerfStage::Decode);
+            pixelData = dicomImage->getOutputData(8 /* bits per sample */);
+        }
         
         if (pixelData == nullptr) {
             delete dicomImage;
@@ -281,50 +265,32 @@ QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
         }
         
         // Create QImage from the processed data - OPTIMIZED: use direct buffer when possible
-        auto qimageStart = std::chrono::high_resolution_clock::now();
         const unsigned char* srcData = static_cast<const unsigned char*>(pixelData);
         
         // Try to create QImage directly from buffer to avoid memcpy (zero-copy optimization)
         QImage frameImage;
-        if (dicomImage->getOutputDataSize(8) == imageWidth * imageHeight) {
-            // Direct buffer usage - no memory copy needed
-            frameImage = QImage(srcData, imageWidth, imageHeight, imageWidth, QImage::Format_Grayscale8);
-            // Create a deep copy to ensure data persistence after DicomImage deletion
-            frameImage = frameImage.copy();
-        } else {
-            // Fallback to memcpy if sizes don't match
-            frameImage = QImage(imageWidth, imageHeight, QImage::Format_Grayscale8);
-            memcpy(frameImage.bits(), srcData, imageWidth * imageHeight);
-        }
-        
-        auto qimageEnd = std::chrono::high_resolution_clock::now();
-        auto qimageDuration = std::chrono::duration_cast<std::chrono::milliseconds>(qimageEnd - qimageStart).count();
-        auto qimageTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(qimageEnd.time_since_epoch()).count();
-        
-        m_currentFrame = frameNumber;
-        
-        // Cache the processed frame for future use
-        if (m_frameCache.size() >= MAX_CACHED_FRAMES) {
-            // Remove oldest cached frame
-            auto oldestIt = std::min_element(m_frameCache.begin(), m_frameCache.end(),
-                [](const CachedFrame& a, const CachedFrame& b) {
-                    return a.timestamp < b.timestamp;
-                });
-            if (oldestIt != m_frameCache.end()) {
-                m_frameCache.erase(oldestIt);
+        {
+            PerfSpan convertSpan("DicomImage to QImage", PerfStage::Convert);
+            if (!dicomImage->isMonochrome()) {
+                // Colour photometric (RGB/YBR): DCMTK delivers interleaved 8-bit RGB
+                frameImage = QImage(srcData, imageWidth, imageHeight, imageWidth * 3, QImage::Format_RGB888).copy();
+            } else if (dicomImage->getOutputDataSize(8) == imageWidth * imageHeight) {
+                // Direct buffer usage - no memory copy needed
+                frameImage = QImage(srcData, imageWidth, imageHeight, imageWidth, QImage::Format_Grayscale8);
+                // Create a deep copy to ensure data persistence after DicomImage deletion
+                frameImage = frameImage.copy();
+            } else {
+                // Fallback to memcpy if sizes don't match
+                frameImage = QImage(imageWidth, imageHeight, QImage::Format_Grayscale8);
+                memcpy(frameImage.bits(), srcData, imageWidth * imageHeight);
             }
         }
         
-        CachedFrame& cache = m_frameCache[frameNumber];
-        cache.image = frameImage.copy(); // Deep copy for cache safety
-        cache.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(totalStart.time_since_epoch()).count();
-        cache.isValid = true;
-        
         delete dicomImage;
+        dicomImage = nullptr;
+        datasetLocker.unlock();
         
-        auto totalEnd = std::chrono::high_resolution_clock::now();
-        auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(totalEnd - totalStart).count();
-        auto finalTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(totalEnd.time_since_epoch()).count();
+        m_currentFrame = frameNumber;
         
         return frameImage;
         
@@ -339,69 +305,405 @@ QImage DicomFrameProcessor::getFrameAsQImage(unsigned long frameNumber)
 #endif
 }
     
-QImage DicomFrameProcessor::applyWindowingAndCreateQImage(double windowCenter, double windowWidth)
+QImage DicomFrameProcessor::decodeFrame(unsigned long frameNumber)
+{
+    if (!canDecodeConcurrently()) {
+        return getFrameAsQImage(frameNumber);
+    }
+    
+    if (frameNumber >= m_numberOfFrames) {
+        return QImage();
+    }
+    
+    return pixelFrameToGrayscale8(decodePixelFrame(frameNumber));
+}
+
+DicomPixelFrame DicomFrameProcessor::decodePixelFrame(unsigned long frameNumber) const
+{
+    DicomPixelFrame frame;
+    if ((!canDecodeConcurrently() && !m_frameIterator) || frameNumber >= m_numberOfFrames) {
+        return frame;
+    }
+    
+    PerfSpan span("DicomFrameProcessor::decodePixelFrame", PerfStage::Decode);
+    
+    // Only reads immutable members; the decoders and readNativeFrame lock the dataset themselves
+    bool ok = false;
+    if (canDecodeConcurrently()) {
+        ok = m_frameDecoder ? m_frameDecoder->decodeFrame(frameNumber, frame.samples)
+                            : readNativeFrame(frameNumber, frame.samples);
+        if (!m_frameDecoder) {
+            frame.mapping = m_mappedPixels;
+        }
+    } else {
+        ok = m_frameIterator->decodeFrame(frameNumber, frame.samples);
+    }
+    if (!ok) {
+        return DicomPixelFrame();
+    }
+    
+    frame.width = static_cast<int>(m_cols);
+    frame.height = static_cast<int>(m_rows);
+    frame.bitsAllocated = static_cast<int>(m_bitsAllocated);
+    frame.bitsStored = static_cast<int>(m_bitsStored);
+    frame.isSigned = m_pixelRepresentation == 1;
+    frame.samplesPerPixel = static_cast<int>(m_samplesPerPixel);
+    frame.monochrome1 = m_photometricInterpretation == "MONOCHROME1";
+    frame.rescaleSlope = m_rescaleSlope;
+    frame.rescaleIntercept = m_rescaleIntercept;
+    
+    if (frame.samples.size() < frame.pixelCount() * frame.bytesPerSample()) {
+        return DicomPixelFrame();
+    }
+    return frame;
+}
+
+QImage DicomFrameProcessor::pixelFrameToGrayscale8(const DicomPixelFrame& frame)
 {
-    if (!m_rawPixelData) {
+    if (frame.isNull()) {
         return QImage();
     }
+    PerfSpan span("DicomFrameProcessor::pixelFrameToGrayscale8", PerfStage::Convert);
+    return samplesToGrayscale8(reinterpret_cast<const unsigned char*>(frame.samples.constData()),
+                               static_cast<unsigned int>(frame.bytesPerSample()),
+                               static_cast<unsigned int>(frame.width), static_cast<unsigned int>(frame.height),
+                               static_cast<unsigned int>(qMax(frame.bitsStored, 0)), frame.isSigned, frame.monochrome1);
+}
+
+DicomPixelFrame DicomFrameProcessor::decodePixelFrameForSize(unsigned long frameNumber,
+                                                             int targetWidth, int targetHeight) const
+{
+    DicomPixelFrame frame;
+    if (!canDecodeConcurrently() || frameNumber >= m_numberOfFrames || targetWidth <= 0 || targetHeight <= 0) {
+        return frame;
+    }
+    
+    PerfSpan span("DicomFrameProcessor::decodePixelFrameForSize", PerfStage::Decode);
+    
+    const unsigned int step = decimationStep(targetWidth, targetHeight);
+    bool ok = false;
     
-    QImage image(m_cols, m_rows, QImage::Format_Grayscale8);
-    unsigned char* outputPixels = image.bits();
+    if (m_frameDecoder) {
+#ifdef HAVE_TURBOJPEG
+        ok = m_bitsAllocated == 8 && step > 1 &&
+             decodeJpegScaled(m_frameDecoder->frameBitstream(frameNumber), targetWidth, targetHeight,
+                              frame.samples, frame.width, frame.height);
+#endif
+        if (!ok) {
+            // No DCT-domain scaling for this process - decode in full, then keep every step-th sample
+            QByteArray full;
+            ok = m_frameDecoder->decodeFrame(frameNumber, full);
+            if (ok) {
+                const unsigned int bytesPerSample = m_frameDecoder->bytesPerSample();
+                frame.width = static_cast<int>((m_cols + step - 1) / step);
+                frame.height = static_cast<int>((m_rows + step - 1) / step);
+                if (step == 1) {
+                    frame.samples = full;
+                } else {
+                    frame.samples.resize(static_cast<qsizetype>(frame.width) * frame.height * bytesPerSample);
+                    const char* src = full.constData();
+                    char* dst = frame.samples.data();
+                    for (unsigned int y = 0; y < m_rows; y += step) {
+                        const char* row = src + static_cast<size_t>(y) * m_cols * bytesPerSample;
+                        for (unsigned int x = 0; x < m_cols; x += step) {
+                            memcpy(dst, row + static_cast<size_t>(x) * bytesPerSample, bytesPerSample);
+                            dst += bytesPerSample;
+                        }
+                    }
+                }
+            }
+        }
+    } else {
+        ok = readNativeFrameDecimated(frameNumber, step, frame.samples, frame.width, frame.height);
+        if (step == 1) {
+            // Full size is a view of the mapping; decimated rows are copies
+            frame.mapping = m_mappedPixels;
+        }
+    }
     
-    // Calculate window bounds
-    double minValue = windowCenter - windowWidth / 2.0;
-    double maxValue = windowCenter + windowWidth / 2.0;
-    double range = maxValue - minValue;
+    if (!ok) {
+        return DicomPixelFrame();
+    }
     
-    if (range == 0) range = 1.0; // Avoid division by zero
+    frame.bitsAllocated = static_cast<int>(m_bitsAllocated);
+    frame.bitsStored = static_cast<int>(m_bitsStored);
+    frame.isSigned = m_pixelRepresentation == 1;
+    frame.samplesPerPixel = static_cast<int>(m_samplesPerPixel);
+    frame.monochrome1 = m_photometricInterpretation == "MONOCHROME1";
+    frame.rescaleSlope = m_rescaleSlope;
+    frame.rescaleIntercept = m_rescaleIntercept;
     
-    unsigned long pixelCount = m_cols * m_rows;
+    if (frame.samples.size() < frame.pixelCount() * frame.bytesPerSample()) {
+        return DicomPixelFrame();
+    }
+    return frame;
+}
+
+QImage DicomFrameProcessor::decodeFrameForSize(unsigned long frameNumber, int targetWidth, int targetHeight)
+{
+    DicomPixelFrame frame = decodePixelFrameForSize(frameNumber, targetWidth, targetHeight);
+    if (!frame.isNull()) {
+        return pixelFrameToGrayscale8(frame);
+    }
     
+    // GDCM, colour or DicomImage-only data - full-size decode
+    return getFrameAsQImage(frameNumber);
+}
+
+unsigned int DicomFrameProcessor::decimationStep(int targetWidth, int targetHeight) const
+{
+    if (targetWidth <= 0 || targetHeight <= 0 || m_cols == 0 || m_rows == 0) {
+        return 1;
+    }
+    
+    // Fitting keeps the aspect ratio, so the tighter dimension decides the scale
+    const unsigned int byWidth = m_cols / static_cast<unsigned int>(targetWidth);
+    const unsigned int byHeight = m_rows / static_cast<unsigned int>(targetHeight);
+    return std::max(1u, std::max(byWidth, byHeight));
+}
+
+bool DicomFrameProcessor::readNativeFrameDecimated(unsigned long frameNumber, unsigned int step,
+                                                   QByteArray& samples, int& width, int& height) const
+{
 #ifdef HAVE_DCMTK
-    if (m_bitsAllocated == 8) {
-        // 8-bit pixel data
-        Uint8* pixels = m_rawPixelData;
-        
-        for (unsigned long i = 0; i < pixelCount; ++i) {
-            double pixelValue = pixels[i] * m_rescaleSlope + m_rescaleIntercept;
-            outputPixels[i] = applyWindowLevel(pixelValue, minValue, maxValue, range);
-        }
-    } 
-    else if (m_bitsAllocated == 16) {
-        // 16-bit pixel data
-        if (m_pixelRepresentation == 0) {
-            // Unsigned 16-bit
-            Uint16* pixels = reinterpret_cast<Uint16*>(m_rawPixelData);
-            
-            for (unsigned long i = 0; i < pixelCount; ++i) {
-                double pixelValue = pixels[i] * m_rescaleSlope + m_rescaleIntercept;
-                outputPixels[i] = applyWindowLevel(pixelValue, minValue, maxValue, range);
+    if (!m_dataset || step == 0) {
+        return false;
+    }
+    if (step == 1) {
+        width = static_cast<int>(m_cols);
+        height = static_cast<int>(m_rows);
+        return readNativeFrame(frameNumber, samples);
+    }
+    
+    try {
+        const unsigned int bytesPerSample = m_bitsAllocated / 8;
+        const Uint32 rowBytes = m_cols * bytesPerSample;
+        const Uint32 frameBytes = m_rows * rowBytes;
+        
+        width = static_cast<int>((m_cols + step - 1) / step);
+        height = static_cast<int>((m_rows + step - 1) / step);
+        
+        if (m_mappedPixels) {
+            // Skipped rows are never touched, so their pages are never read
+            const QByteArray mapped = m_mappedPixels->view(static_cast<quint64>(frameBytes) * frameNumber, frameBytes);
+            if (mapped.isEmpty()) {
+                return false;
             }
-        } else {
-            // Signed 16-bit
-            Sint16* pixels = reinterpret_cast<Sint16*>(m_rawPixelData);
-            
-            for (unsigned long i = 0; i < pixelCount; ++i) {
-                double pixelValue = pixels[i] * m_rescaleSlope + m_rescaleIntercept;
-                outputPixels[i] = applyWindowLevel(pixelValue, minValue, maxValue, range);
+            samples.resize(static_cast<qsizetype>(width) * height * bytesPerSample);
+            char* dst = samples.data();
+            for (unsigned int y = 0; y < m_rows; y += step) {
+                const char* row = mapped.constData() + static_cast<size_t>(y) * rowBytes;
+                for (unsigned int x = 0; x < m_cols; x += step) {
+                    memcpy(dst, row + static_cast<size_t>(x) * bytesPerSample, bytesPerSample);
+                    dst += bytesPerSample;
+                }
+            }
+            return true;
+        }
+        
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* dataset = m_dataset->dataset();
+        DcmElement* pixelElement = nullptr;
+        if (!dataset || dataset->findAndGetElement(DCM_PixelData, pixelElement).bad() || !pixelElement) {
+            return false;
+        }
+        if (static_cast<quint64>(frameBytes) * (frameNumber + 1) > pixelElement->getLength()) {
+            return false;
+        }
+        
+        samples.resize(static_cast<qsizetype>(width) * height * bytesPerSample);
+        
+        // Read only the rows that are kept, then keep every step-th sample of each
+        QByteArray row(static_cast<int>(rowBytes), Qt::Uninitialized);
+        char* dst = samples.data();
+        const Uint32 frameOffset = frameBytes * static_cast<Uint32>(frameNumber);
+        for (unsigned int y = 0; y < m_rows; y += step) {
+            if (pixelElement->getPartialValue(row.data(), frameOffset + y * rowBytes, rowBytes).bad()) {
+                return false;
+            }
+            for (unsigned int x = 0; x < m_cols; x += step) {
+                memcpy(dst, row.constData() + static_cast<size_t>(x) * bytesPerSample, bytesPerSample);
+                dst += bytesPerSample;
+            }
+        }
+        return true;
+        
+    } catch (...) {
+        return false;
+    }
+#else
+    Q_UNUSED(frameNumber)
+    Q_UNUSED(step)
+    Q_UNUSED(samples)
+    Q_UNUSED(width)
+    Q_UNUSED(height)
+    return false;
+#endif
+}
+
+#ifdef HAVE_TURBOJPEG
+bool DicomFrameProcessor::decodeJpegScaled(const QByteArray& bitstream, int targetWidth, int targetHeight,
+                                           QByteArray& samples, int& width, int& height) const
+{
+    if (bitstream.size() < 4) {
+        return false;
+    }
+    
+    // The calling thread's own handle, so concurrent decodes share nothing
+    tjhandle handle = TurboJpegDecoder::decompressor();
+    if (!handle) {
+        return false;
+    }
+    
+    bool ok = false;
+    unsigned char* jpegData = reinterpret_cast<unsigned char*>(const_cast<char*>(bitstream.constData()));
+    const unsigned long jpegSize = static_cast<unsigned long>(bitstream.size());
+    int jpegWidth = 0, jpegHeight = 0, subsampling = 0, colorspace = 0;
+    
+    // Fails for 12-bit and lossless bitstreams, which the caller decodes another way
+    if (tjDecompressHeader3(handle, jpegData, jpegSize, &jpegWidth, &jpegHeight, &subsampling, &colorspace) == 0 &&
+        jpegWidth == static_cast<int>(m_cols) && jpegHeight == static_cast<int>(m_rows)) {
+        
+        // Smallest scaling factor (1/8 .. 1) whose output still covers the fitted target size
+        const double needed = std::min(static_cast<double>(targetWidth) / jpegWidth,
+                                       static_cast<double>(targetHeight) / jpegHeight);
+        int factorCount = 0;
+        tjscalingfactor* factors = tjGetScalingFactors(&factorCount);
+        tjscalingfactor chosen = {1, 1};
+        for (int i = 0; factors && i < factorCount; ++i) {
+            const double scale = static_cast<double>(factors[i].num) / factors[i].denom;
+            if (scale <= 1.0 && scale >= needed &&
+                scale < static_cast<double>(chosen.num) / chosen.denom) {
+                chosen = factors[i];
             }
         }
+        
+        width = TJSCALED(jpegWidth, chosen);
+        height = TJSCALED(jpegHeight, chosen);
+        samples.resize(static_cast<qsizetype>(width) * height);
+        ok = tjDecompress2(handle, jpegData, jpegSize, reinterpret_cast<unsigned char*>(samples.data()),
+                           width, width, height, TJPF_GRAY, TJFLAG_FASTDCT) == 0;
     }
+    
+    return ok;
+}
 #endif
+
+bool DicomFrameProcessor::readNativeFrame(unsigned long frameNumber, QByteArray& samples) const
+{
+#ifdef HAVE_DCMTK
+    if (!m_dataset) {
+        return false;
+    }
     
-    return image;
+    try {
+        const Uint32 frameBytes = m_rows * m_cols * (m_bitsAllocated / 8);
+        
+        if (m_mappedPixels) {
+            // No copy and no lock: the view points into the mapped file
+            samples = m_mappedPixels->view(static_cast<quint64>(frameBytes) * frameNumber, frameBytes);
+            return !samples.isEmpty();
+        }
+        
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* dataset = m_dataset->dataset();
+        DcmElement* pixelElement = nullptr;
+        if (!dataset || dataset->findAndGetElement(DCM_PixelData, pixelElement).bad() || !pixelElement) {
+            return false;
+        }
+        if (static_cast<quint64>(frameBytes) * (frameNumber + 1) > pixelElement->getLength()) {
+            return false;
+        }
+        
+        // Reads only this frame from file (or memory if already loaded), swapped to host order
+        samples.resize(static_cast<int>(frameBytes));
+        return pixelElement->getPartialValue(samples.data(), frameBytes * static_cast<Uint32>(frameNumber),
+                                             frameBytes).good();
+        
+    } catch (...) {
+        return false;
+    }
+#else
+    Q_UNUSED(frameNumber)
+    Q_UNUSED(samples)
+    return false;
+#endif
 }
 
-QImage DicomFrameProcessor::createQImageWithDefaultWindowing()
+void DicomFrameProcessor::mapNativePixelData(bool explicitVR)
 {
-    return applyWindowingAndCreateQImage(m_defaultWindowCenter, m_defaultWindowWidth);
+#ifdef HAVE_DCMTK
+    if (m_samplesPerPixel != 1 || (m_bitsAllocated != 8 && m_bitsAllocated != 16)) {
+        return;
+    }
+    
+    DcmDataset* dataset = m_dataset->dataset();
+    DcmElement* pixelElement = nullptr;
+    if (!dataset || dataset->findAndGetElement(DCM_PixelData, pixelElement).bad() || !pixelElement) {
+        return;
+    }
+    const Uint32 length = pixelElement->getLength();
+    if (length == 0 || length == DCM_UndefinedLength) {
+        return;
+    }
+    
+    // The first bytes as DCMTK reads them confirm the located value; only these are read now
+    QByteArray leadingBytes(static_cast<int>(std::min<Uint32>(length, 64)), Qt::Uninitialized);
+    if (pixelElement->getPartialValue(leadingBytes.data(), 0, static_cast<Uint32>(leadingBytes.size())).bad()) {
+        return;
+    }
+    m_mappedPixels = MappedPixelData::map(m_currentFilePath, explicitVR, length, leadingBytes);
+#else
+    Q_UNUSED(explicitVR)
+#endif
+}
+
+QImage DicomFrameProcessor::samplesToGrayscale8(const unsigned char* samples, unsigned int bytesPerSample,
+                                                unsigned int width, unsigned int height,
+                                                unsigned int bitsStored, bool isSigned, bool invert)
+{
+    if (!samples || height == 0 || width == 0) {
+        return QImage();
+    }
+    
+    QImage image(width, height, QImage::Format_Grayscale8);
+    
+    for (unsigned int y = 0; y < height; ++y) {
+        uchar* dst = image.scanLine(y);
+        
+        if (bytesPerSample == 1) {
+            const unsigned char* src = samples + static_cast<size_t>(y) * width;
+            for (unsigned int x = 0; x < width; ++x) {
+                dst[x] = invert ? 255 - src[x] : src[x];
+            }
+        } else {
+            // Map the full stored range to 8 bits, as DCMTK does without a VOI window
+            const quint16* src = reinterpret_cast<const quint16*>(samples) + static_cast<size_t>(y) * width;
+            const unsigned int bits = std::min(std::max(bitsStored, 8u), 16u);
+            const unsigned int shift = bits - 8;
+            const quint32 mask = (1u << bits) - 1;
+            const quint32 signBit = 1u << (bits - 1);
+            
+            for (unsigned int x = 0; x < width; ++x) {
+                quint32 value = src[x] & mask;
+                if (isSigned) {
+                    value ^= signBit; // Two's complement to offset binary
+                }
+                unsigned char out = static_cast<unsigned char>(value >> shift);
+                dst[x] = invert ? 255 - out : out;
+            }
+        }
+    }
+    
+    return image;
 }
     
 bool DicomFrameProcessor::extractMetadata()
 {
 #ifdef HAVE_DCMTK
     try {
-        DcmDataset* dataset = m_fileFormat->getDataset();
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* dataset = m_dataset->dataset();
         if (!dataset) {
             return false;
         }
@@ -444,6 +746,19 @@ bool DicomFrameProcessor::extractMetadata()
             m_pixelRepresentation = 0; // Default unsigned
         }
         
+        if (dataset->findAndGetUint16(DCM_SamplesPerPixel, tempValue).good()) {
+            m_samplesPerPixel = tempValue;
+        } else {
+            m_samplesPerPixel = 1;
+        }
+        
+        OFString photometric;
+        if (dataset->findAndGetOFString(DCM_PhotometricInterpretation, photometric).good()) {
+            m_photometricInterpretation = QString::fromLatin1(photometric.c_str()).trimmed();
+        } else {
+            m_photometricInterpretation.clear();
+        }
+        
         // Get number of frames
         OFString numFramesStr;
         m_numberOfFrames = 1;
@@ -505,46 +820,22 @@ bool DicomFrameProcessor::extractMetadata()
 #endif
 }
 
-inline unsigned char DicomFrameProcessor::applyWindowLevel(double pixelValue, double minValue, 
-                                                          double maxValue, double range)
-{
-    if (pixelValue <= minValue) {
-        return 0;
-    } else if (pixelValue >= maxValue) {
-        return 255;
-    } else {
-        return static_cast<unsigned char>(((pixelValue - minValue) / range) * 255.0);
-    }
-}
-
 #ifdef HAVE_GDCM
 bool DicomFrameProcessor::initializeGdcm(const QString& filePath)
 {
-    auto gdcmStart = std::chrono::high_resolution_clock::now();
-    auto startTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(gdcmStart.time_since_epoch()).count();
+    PerfSpan span("DicomFrameProcessor::initializeGdcm", PerfStage::Parse);
     
     try {
         // Clean up any existing GDCM objects
-        auto cleanupStart = std::chrono::high_resolution_clock::now();
         delete m_gdcmReader;
         delete m_gdcmImage;
-        auto cleanupEnd = std::chrono::high_resolution_clock::now();
-        auto cleanupDuration = std::chrono::duration_cast<std::chrono::milliseconds>(cleanupEnd - cleanupStart).count();
         
         // Initialize GDCM reader
-        auto readerStart = std::chrono::high_resolution_clock::now();
-        auto readerTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(readerStart.time_since_epoch()).count();
-        
         m_gdcmReader = new gdcm::ImageReader();
         m_gdcmReader->SetFileName(filePath.toLocal8Bit().constData());
         
         // Try to read the file
-        auto readStart = std::chrono::high_resolution_clock::now();
         bool readResult = m_gdcmReader->Read();
-        auto readEnd = std::chrono::high_resolution_clock::now();
-        auto readDuration = std::chrono::duration_cast<std::chrono::milliseconds>(readEnd - readStart).count();
-        auto readTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(readEnd.time_since_epoch()).count();
-        
         
         if (!readResult) {
             delete m_gdcmReader;
@@ -553,13 +844,9 @@ bool DicomFrameProcessor::initializeGdcm(const QString& filePath)
         }
         
         // Get the image object
-        auto imageStart = std::chrono::high_resolution_clock::now();
-        auto imageTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(imageStart.time_since_epoch()).count();
-        
         m_gdcmImage = new gdcm::Image(m_gdcmReader->GetImage());
         
         // Verify this is a compressed JPEG format that GDCM can handle
-        auto verifyStart = std::chrono::high_resolution_clock::now();
         const gdcm::PhotometricInterpretation& pi = m_gdcmImage->GetPhotometricInterpretation();
         const gdcm::PixelFormat& pf = m_gdcmImage->GetPixelFormat();
         
@@ -567,35 +854,19 @@ bool DicomFrameProcessor::initializeGdcm(const QString& filePath)
         unsigned int numFrames = m_gdcmImage->GetNumberOfDimensions() > 2 ? 
                                 m_gdcmImage->GetDimension(2) : 1;
         
-        auto verifyEnd = std::chrono::high_resolution_clock::now();
-        auto verifyDuration = std::chrono::duration_cast<std::chrono::milliseconds>(verifyEnd - verifyStart).count();
-        auto verifyTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(verifyEnd.time_since_epoch()).count();
-        
-        
         // Don't pre-allocate pixel buffer - use lazy loading for better initial performance
-        auto bufferStart = std::chrono::high_resolution_clock::now();
         size_t bufferSize = m_gdcmImage->GetBufferLength();
         // m_gdcmPixelBuffer.resize(bufferSize);  // Remove pre-allocation
-        auto bufferEnd = std::chrono::high_resolution_clock::now();
-        auto bufferDuration = std::chrono::duration_cast<std::chrono::milliseconds>(bufferEnd - bufferStart).count();
-        auto bufferTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(bufferEnd.time_since_epoch()).count();
-        
-        
-        auto gdcmEnd = std::chrono::high_resolution_clock::now();
-        auto totalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(gdcmEnd - gdcmStart).count();
-        auto endTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(gdcmEnd.time_since_epoch()).count();
         
         return true;
         
     } catch (const std::exception& e) {
-        auto errorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
         delete m_gdcmReader;
         delete m_gdcmImage;
         m_gdcmReader = nullptr;
         m_gdcmImage = nullptr;
         return false;
     } catch (...) {
-        auto errorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
         delete m_gdcmReader;
         delete m_gdcmImage;
         m_gdcmReader = nullptr;
@@ -612,9 +883,9 @@ bool DicomFrameProcessor::decompressGdcmFrame(unsigned long frameNumber,
         return false;
     }
     
+    PerfSpan span("DicomFrameProcessor::decompressGdcmFrame", PerfStage::Decode);
+    
     try {
-        auto gdcmStart = std::chrono::high_resolution_clock::now();
-        auto stepStart = std::chrono::high_resolution_clock::now();
         // Calculate frame size
         const gdcm::PixelFormat& pf = m_gdcmImage->GetPixelFormat();
         unsigned int bytesPerPixel = pf.GetBitsAllocated() / 8;
@@ -623,18 +894,14 @@ bool DicomFrameProcessor::decompressGdcmFrame(unsigned long frameNumber,
         // Allocate output buffer
         *outputBuffer = new unsigned char[*outputSize];
         
-        auto allocTime = std::chrono::high_resolution_clock::now();
-        auto allocDuration = std::chrono::duration_cast<std::chrono::milliseconds>(allocTime - stepStart).count();
-        
         // Extract the specific frame using GDCM
-        auto decompressStart = std::chrono::high_resolution_clock::now();
         if (m_numberOfFrames > 1) {
             // Multi-frame: lazy decompression approach
             size_t frameSize = *outputSize;
             
             // Check if we need to decompress the entire sequence
             if (m_gdcmPixelBuffer.empty()) {
-                auto decompressionStart = std::chrono::high_resolution_clock::now();
+                PerfSpan volumeSpan("GDCM decode all frames", PerfStage::None);
                 
                 // Allocate buffer for all frames
                 m_gdcmPixelBuffer.resize(m_gdcmImage->GetBufferLength());
@@ -645,17 +912,11 @@ bool DicomFrameProcessor::decompressGdcmFrame(unsigned long frameNumber,
                     *outputBuffer = nullptr;
                     return false;
                 }
-                
-                auto decompressionEnd = std::chrono::high_resolution_clock::now();
-                auto decompressionDuration = std::chrono::duration_cast<std::chrono::milliseconds>(decompressionEnd - decompressionStart).count();
             }
             
-            auto copyStart = std::chrono::high_resolution_clock::now();
             // Copy the specific frame from the pre-decompressed buffer
             char* frameData = &m_gdcmPixelBuffer[frameNumber * frameSize];
             memcpy(*outputBuffer, frameData, frameSize);
-            auto copyEnd = std::chrono::high_resolution_clock::now();
-            auto copyDuration = std::chrono::duration_cast<std::chrono::milliseconds>(copyEnd - copyStart).count();
         } else {
             // Single frame: direct decompression
             if (!m_gdcmImage->GetBuffer(reinterpret_cast<char*>(*outputBuffer))) {
@@ -664,11 +925,6 @@ bool DicomFrameProcessor::decompressGdcmFrame(unsigned long frameNumber,
                 return false;
             }
         }
-        auto decompressEnd = std::chrono::high_resolution_clock::now();
-        auto decompressDuration = std::chrono::duration_cast<std::chrono::milliseconds>(decompressEnd - decompressStart).count();
-        
-        auto gdcmEnd = std::chrono::high_resolution_clock::now();
-        auto gdcmTotalDuration = std::chrono::duration_cast<std::chrono::milliseconds>(gdcmEnd - gdcmStart).count();
         
         return true;
         
@@ -688,90 +944,13 @@ bool DicomFrameProcessor::decompressGdcmFrame(unsigned long frameNumber,
 }
 #endif
 
-bool DicomFrameProcessor::preDecompressAllFrames()
-{
-#ifdef HAVE_GDCM
-    if (!m_useGdcmMode || m_numberOfFrames <= 1) {
-        return false;
-    }
-    
-    // Safety check: ensure GDCM resources are valid
-    if (!m_gdcmReader || !m_gdcmImage) {
-        return false;
-    }
-    
-    auto startTime = std::chrono::high_resolution_clock::now();
-    
-    try {
-        // Clear and prepare storage
-        m_preDecompressedFrames.clear();
-        m_preDecompressedFrames.resize(m_numberOfFrames);
-        
-        // Safety check: validate frame count
-        if (m_numberOfFrames > 1000) { // Reasonable safety limit
-            return false;
-        }
-        
-        // Decompress all frames at once using GDCM's batch capability
-        for (unsigned long i = 0; i < m_numberOfFrames; ++i) {
-            // Safety check: ensure we don't go out of bounds
-            if (i >= static_cast<unsigned long>(m_preDecompressedFrames.size())) {
-                return false;
-            }
-            
-            unsigned char* frameBuffer = nullptr;
-            unsigned long outputSize = 0;
-            
-            try {
-                if (decompressGdcmFrame(i, &frameBuffer, &outputSize)) {
-                    // Validate frame buffer and size
-                    if (!frameBuffer || outputSize < m_cols * m_rows) {
-                        if (frameBuffer) delete[] frameBuffer;
-                        return false;
-                    }
-                    
-                    // Convert to QImage and store
-                    QImage frameImage(m_cols, m_rows, QImage::Format_Grayscale8);
-                    memcpy(frameImage.bits(), frameBuffer, m_cols * m_rows);
-                    m_preDecompressedFrames[i] = frameImage.copy();
-                    
-                    // Clean up
-                    delete[] frameBuffer;
-                    frameBuffer = nullptr;
-                } else {
-                    return false;
-                }
-            } catch (const std::exception& e) {
-                if (frameBuffer) delete[] frameBuffer;
-                return false;
-            } catch (...) {
-                if (frameBuffer) delete[] frameBuffer;
-                return false;
-            }
-        }
-        
-        m_batchDecompressed = true;
-        
-        auto endTime = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
-        // Batch decompression completed
-        
-        return true;
-        
-    } catch (const std::exception& e) {
-        return false;
-    }
-#else
-    return false;
-#endif
-}
-
 QString DicomFrameProcessor::getDicomTagValue(const QString& tag) const
 {
 #ifdef HAVE_DCMTK
-    if (!m_fileFormat) return QString();
+    if (!m_dataset) return QString();
     
-    DcmDataset* dataset = m_fileFormat->getDataset();
+    QMutexLocker datasetLocker(m_dataset->mutex());
+    DcmDataset* dataset = m_dataset->dataset();
     if (!dataset) return QString();
     
     // Parse tag string (e.g., "0020,0013")
@@ -4,8 +4,12 @@
 #include <QString>
 #include <QMap>
 #include <memory>
-#include <chrono>
 #include <algorithm>
+#include "DicomDatasetHandle.h"
+#include "EncapsulatedFrameDecoder.h"
+#include "DicomFrameIterator.h"
+#include "MappedPixelData.h"
+#include "DicomPixelFrame.h"
 
 #ifdef HAVE_DCMTK
 #include "dcmtk/config/osconfig.h"
@@ -19,7 +23,7 @@
 #endif
 
 #ifdef HAVE_TURBOJPEG
-#include <turbojpeg.h>
+#include "TurboJpegDecoder.h"
 #endif
 
 #ifdef HAVE_GDCM
@@ -44,22 +48,34 @@
 class DicomFrameProcessor
 {
 public:
+    /**
+     * @brief Which frames a loaded file will be asked for
+     *
+     * FirstFrame is for thumbnails. The header is parsed as usual, but
+     * nothing is prepared that reads or decodes the whole run: the GDCM
+     * whole-volume reader is not created, and an encapsulated frame index
+     * without an offset table is only built up to frame 0.
+     */
+    enum class LoadScope { AllFrames, FirstFrame };
+
     DicomFrameProcessor();
     ~DicomFrameProcessor();
 
     /**
      * @brief Load DICOM file and prepare for frame access
      * @param filePath Path to the DICOM file
+     * @param scope Frames that will be accessed
      * @return true if successful, false otherwise
      */
-    bool loadDicomFile(const QString& filePath);
+    bool loadDicomFile(const QString& filePath, LoadScope scope = LoadScope::AllFrames);
 
     /**
-     * @brief Get direct access to pixel data for a specific frame
-     * @param frameNumber Frame number (0-based)
+     * @brief Prepare for frame access on an already parsed dataset
+     * @param dataset Shared dataset handle (not re-parsed)
+     * @param scope Frames that will be accessed
      * @return true if successful, false otherwise
      */
-    bool getFramePixelData(unsigned long frameNumber);
+    bool loadDicomFile(const std::shared_ptr<DicomDatasetHandle>& dataset, LoadScope scope = LoadScope::AllFrames);
 
     /**
      * @brief Get a specific frame as QImage with proper DCMTK handling
@@ -69,18 +85,68 @@ public:
     QImage getFrameAsQImage(unsigned long frameNumber);
 
     /**
-     * @brief Apply windowing and create QImage for display
-     * @param windowCenter Window center value
-     * @param windowWidth Window width value
-     * @return QImage ready for display
+     * @brief Decode a frame without touching the frame cache
+     *
+     * Safe to call from several threads at once when canDecodeConcurrently()
+     * is true. Otherwise it forwards to getFrameAsQImage() and callers must
+     * serialize access themselves.
+     * @param frameNumber Frame number (0-based)
+     * @return QImage ready for display, or null QImage on error
+     */
+    QImage decodeFrame(unsigned long frameNumber);
+
+    /**
+     * @brief Decode a frame keeping its native stored bit depth
+     *
+     * Available for native (uncompressed) data, for encapsulated JPEG frames
+     * reachable through the frame index, and for other monochrome data through
+     * the DCMTK frame iterator. Thread-safe like decodeFrame(); iterator decodes
+     * are serialized on the dataset lock.
+     * @param frameNumber Frame number (0-based)
+     * @return Native frame, or a null frame if not available for this file
+     */
+    DicomPixelFrame decodePixelFrame(unsigned long frameNumber) const;
+
+    /**
+     * @brief Decode a frame at reduced resolution for display at a target size
+     *
+     * Returns the smallest frame that still covers targetWidth x targetHeight
+     * when fitted with the aspect ratio kept, so the caller's final smooth
+     * scale has enough detail. Baseline 8-bit JPEG is decoded by TurboJPEG at
+     * 1/2, 1/4 or 1/8 scale in the DCT domain; native data reads only every
+     * k-th row and takes every k-th column; other JPEG processes are decoded
+     * in full and decimated. Thread-safe like decodePixelFrame().
+     * @param frameNumber Frame number (0-based)
+     * @return Reduced native frame (stored values), or a null frame if not
+     *         available for this file
+     */
+    DicomPixelFrame decodePixelFrameForSize(unsigned long frameNumber, int targetWidth, int targetHeight) const;
+
+    /**
+     * @brief Decode a frame to 8-bit at reduced resolution for a target size
+     *
+     * Uses decodePixelFrameForSize() where possible and falls back to a full
+     * decode otherwise, so the result may be larger than needed but is never
+     * smaller. Native frames are mapped over their full stored range.
+     * @return QImage ready for scaling to the target size, or null QImage on error
      */
-    QImage applyWindowingAndCreateQImage(double windowCenter, double windowWidth);
+    QImage decodeFrameForSize(unsigned long frameNumber, int targetWidth, int targetHeight);
 
     /**
-     * @brief Create QImage with default DICOM windowing values
-     * @return QImage ready for display
+     * @brief Map a native frame's full stored range to 8-bit grayscale
+     *
+     * Uses only the frame's own attributes, so no file needs to be loaded.
      */
-    QImage createQImageWithDefaultWindowing();
+    static QImage pixelFrameToGrayscale8(const DicomPixelFrame& frame);
+
+    /**
+     * @brief True if frames are read or decoded independently of each other
+     */
+    bool canDecodeConcurrently() const
+    {
+        return (m_frameDecoder != nullptr || m_isNativePixelData) && m_samplesPerPixel == 1 &&
+               (m_bitsAllocated == 8 || m_bitsAllocated == 16);
+    }
 
     // Getters for DICOM properties
     unsigned long getNumberOfFrames() const { return m_numberOfFrames; }
@@ -93,15 +159,14 @@ public:
     // Get DICOM tag value as string
     QString getDicomTagValue(const QString& tag) const;
     
+    // Shared dataset this processor reads from
+    std::shared_ptr<DicomDatasetHandle> dataset() const { return m_dataset; }
+    
     // Check if processor is ready
-    bool isValid() const { return m_fileFormat != nullptr && m_rawPixelData != nullptr; }
+    bool isValid() const { return m_dataset != nullptr; }
 
 private:
-#ifdef HAVE_DCMTK
-    DcmFileFormat* m_fileFormat;
-#endif
-    
-    unsigned char* m_rawPixelData;
+    std::shared_ptr<DicomDatasetHandle> m_dataset;
     QString m_currentFilePath;
     
     // Image properties
@@ -111,6 +176,8 @@ private:
     unsigned int m_bitsStored;
     unsigned int m_highBit;
     unsigned int m_pixelRepresentation; // 0 = unsigned, 1 = signed
+    unsigned int m_samplesPerPixel;
+    QString m_photometricInterpretation;
     unsigned long m_numberOfFrames;
     unsigned long m_currentFrame;
     
@@ -123,49 +190,17 @@ private:
     // Performance mode flags
     bool m_useGdcmMode;
     
-    // Frame-level decompression cache to avoid repeated decompression
-    struct CachedFrame {
-        QImage image;
-        qint64 timestamp;
-        bool isValid;
-        CachedFrame() : timestamp(0), isValid(false) {}
-    };
-    
-    mutable QMap<unsigned long, CachedFrame> m_frameCache;
-    static constexpr int MAX_CACHED_FRAMES = 20; // Limit cache size
-    
-    // Batch decompression for GDCM mode
-    bool m_batchDecompressed;
-    QVector<QImage> m_preDecompressedFrames;
-
-#ifdef HAVE_TURBOJPEG
-    // Hybrid performance mode members
-    tjhandle m_tjInstance;
-    bool m_useHybridMode;
-    bool m_isCompressedJpeg;
+    // Per-frame decoder for encapsulated JPEG (null for native or unsupported data)
+    std::unique_ptr<EncapsulatedFrameDecoder> m_frameDecoder;
     
-    struct JpegFrameInfo {
-        unsigned char* jpegData;
-        unsigned long jpegSize;
-        bool extracted;
-        
-        JpegFrameInfo() : jpegData(nullptr), jpegSize(0), extracted(false) {}
-        ~JpegFrameInfo() { if (jpegData) delete[] jpegData; }
-    };
+    // Uncompressed transfer syntax - frames are read straight from Pixel Data
+    bool m_isNativePixelData;
     
-    std::vector<std::unique_ptr<JpegFrameInfo>> m_jpegFrames;
+    // Little endian native Pixel Data mapped read-only; frames are views into it
+    std::shared_ptr<const MappedPixelData> m_mappedPixels;
     
-    /**
-     * @brief Extract JPEG data from DICOM pixel sequence for hybrid mode
-     */
-    bool extractJpegFrames();
-    
-    /**
-     * @brief Decompress JPEG data using TurboJPEG for maximum performance
-     */
-    bool decompressJpegFrame(int frameNumber, unsigned char** outputBuffer, 
-                            unsigned long* outputSize);
-#endif
+    // Per-frame DCMTK decompression (RLE, JPEG-LS, ...) for monochrome data without a frame decoder
+    std::unique_ptr<DicomFrameIterator> m_frameIterator;
 
 #ifdef HAVE_GDCM
     // GDCM performance mode members
@@ -185,19 +220,57 @@ private:
                             unsigned long* outputSize);
 #endif
 
-    /**
-     * @brief Apply window/level to a single pixel value
-     */
-    inline unsigned char applyWindowLevel(double pixelValue, double minValue, 
-                                          double maxValue, double range);
-
     /**
      * @brief Extract DICOM metadata needed for processing
      */
     bool extractMetadata();
     
     /**
-     * @brief Pre-decompress all frames for optimal GDCM performance
+     * @brief Convert one frame of native grayscale samples to 8-bit for display
+     * @param samples width*height samples, 1 or 2 bytes each (host order)
+     * @param bytesPerSample 1 or 2
+     * @param bitsStored Significant bits per sample
+     * @param isSigned Pixel Representation 1
+     * @param invert MONOCHROME1
      */
-    bool preDecompressAllFrames();
+    static QImage samplesToGrayscale8(const unsigned char* samples, unsigned int bytesPerSample,
+                                      unsigned int width, unsigned int height,
+                                      unsigned int bitsStored, bool isSigned, bool invert);
+    
+    /**
+     * @brief Map the file's native Pixel Data value, if it can be located
+     *
+     * Called with the dataset lock held. Leaves m_mappedPixels null when the
+     * value cannot be mapped; frames are then read through DCMTK.
+     */
+    void mapNativePixelData(bool explicitVR);
+    
+    /**
+     * @brief Read one uncompressed frame's stored values from Pixel Data
+     *
+     * With a mapping the samples are a zero-copy view into the mapped file.
+     */
+    bool readNativeFrame(unsigned long frameNumber, QByteArray& samples) const;
+    
+    /**
+     * @brief Read every step-th row and column of one uncompressed frame
+     * @param width Receives the decimated width
+     * @param height Receives the decimated height
+     */
+    bool readNativeFrameDecimated(unsigned long frameNumber, unsigned int step, QByteArray& samples,
+                                  int& width, int& height) const;
+    
+    /**
+     * @brief Largest decimation step whose output still covers the target size
+     */
+    unsigned int decimationStep(int targetWidth, int targetHeight) const;
+
+#ifdef HAVE_TURBOJPEG
+    /**
+     * @brief Decode an 8-bit grayscale JPEG bitstream with TurboJPEG DCT-domain scaling
+     * @return false if TurboJPEG cannot decode this bitstream (12-bit, lossless)
+     */
+    bool decodeJpegScaled(const QByteArray& bitstream, int targetWidth, int targetHeight,
+                          QByteArray& samples, int& width, int& height) const;
+#endif
 };
@@ -0,0 +1,168 @@
+#include "DicomFrameStore.h"
+#include <QMutexLocker>
+#include <iterator>
+
+DicomFrameStore::DicomFrameStore(int budgetMB)
+    : m_budgetBytes(static_cast<qint64>(qMax(1, budgetMB)) * 1024 * 1024)
+    , m_bytesUsed(0)
+    , m_playhead(-1)
+    , m_direction(1)
+    , m_frameCount(0)
+{
+}
+
+void DicomFrameStore::setBudgetMB(int budgetMB)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budgetBytes = static_cast<qint64>(qMax(1, budgetMB)) * 1024 * 1024;
+    evictLocked(-1);
+}
+
+int DicomFrameStore::budgetMB() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_budgetBytes / (1024 * 1024));
+}
+
+void DicomFrameStore::insert(int frameIndex, const DicomPixelFrame& pixels, const QImage& image)
+{
+    StoredFrame frame;
+    frame.pixels = pixels;
+    frame.image = image;
+    if (frame.isNull()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_frames.find(frameIndex);
+    if (it != m_frames.end()) {
+        removeLocked(it);
+    }
+
+    m_lru.push_front(frameIndex);
+    Entry entry;
+    entry.frame = frame;
+    entry.lruPosition = m_lru.begin();
+    m_frames.emplace(frameIndex, entry);
+    m_bytesUsed += frame.sizeInBytes();
+
+    evictLocked(frameIndex);
+}
+
+StoredFrame DicomFrameStore::frame(int frameIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_frames.find(frameIndex);
+    if (it == m_frames.end()) {
+        return StoredFrame();
+    }
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lruPosition);
+    return it->second.frame;
+}
+
+bool DicomFrameStore::contains(int frameIndex) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_frames.find(frameIndex) != m_frames.end();
+}
+
+bool DicomFrameStore::isEmpty() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_frames.empty();
+}
+
+void DicomFrameStore::setPlayhead(int frameIndex, int frameCount)
+{
+    QMutexLocker locker(&m_mutex);
+    if (frameCount > 0 && m_playhead >= 0 && frameCount == m_frameCount) {
+        if (frameIndex == (m_playhead + frameCount - 1) % frameCount) {
+            m_direction = -1;
+        } else if (frameIndex == (m_playhead + 1) % frameCount) {
+            m_direction = 1;
+        }
+    }
+    m_playhead = frameIndex;
+    m_frameCount = frameCount;
+}
+
+void DicomFrameStore::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_frames.clear();
+    m_lru.clear();
+    m_bytesUsed = 0;
+    m_playhead = -1;
+    m_direction = 1;
+    m_frameCount = 0;
+}
+
+qint64 DicomFrameStore::bytesUsed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytesUsed;
+}
+
+int DicomFrameStore::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return static_cast<int>(m_frames.size());
+}
+
+void DicomFrameStore::evictLocked(int keepFrame)
+{
+    while (m_bytesUsed > m_budgetBytes) {
+        int victim = pickVictimLocked(keepFrame);
+        if (victim < 0) {
+            return;
+        }
+        removeLocked(m_frames.find(victim));
+    }
+}
+
+int DicomFrameStore::pickVictimLocked(int keepFrame) const
+{
+    if (m_playhead < 0) {
+        // No playhead yet: least recently used
+        for (auto it = m_lru.rbegin(); it != m_lru.rend(); ++it) {
+            if (*it != keepFrame) {
+                return *it;
+            }
+        }
+        return -1;
+    }
+
+    // Furthest ahead of the playhead in playback direction (wrapping) goes first.
+    // Forward: frames just behind the playhead, then the far end of the run.
+    // Backward: frames just after the playhead, then the start of the run.
+    const auto split = m_frames.lower_bound(m_playhead);
+    const auto after = m_frames.upper_bound(m_playhead);
+    if (m_direction >= 0) {
+        for (auto it = std::make_reverse_iterator(split); it != m_frames.rend(); ++it) {
+            if (it->first != keepFrame) return it->first;
+        }
+        for (auto it = m_frames.rbegin(); it != std::make_reverse_iterator(after); ++it) {
+            if (it->first != keepFrame) return it->first;
+        }
+    } else {
+        for (auto it = after; it != m_frames.end(); ++it) {
+            if (it->first != keepFrame) return it->first;
+        }
+        for (auto it = m_frames.begin(); it != split; ++it) {
+            if (it->first != keepFrame) return it->first;
+        }
+    }
+
+    // Only the playhead frame itself is left
+    if (split != after && split->first != keepFrame) {
+        return split->first;
+    }
+    return -1;
+}
+
+void DicomFrameStore::removeLocked(std::map<int, Entry>::iterator it)
+{
+    m_bytesUsed -= it->second.frame.sizeInBytes();
+    m_lru.erase(it->second.lruPosition);
+    m_frames.erase(it);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <list>
+#include <map>
+#include "DicomPixelFrame.h"
+
+/**
+ * @brief One decoded frame as held by DicomFrameStore
+ *
+ * Native frames carry their stored samples in pixels. Frames that only exist
+ * as 8-bit output (colour photometrics, DicomImage fallback decodes) carry
+ * image instead. Both members are implicitly shared, so copies are views of
+ * the stored pixels. Frames viewing a memory-mapped file hold no memory of
+ * their own (the OS pages them in and out), so they do not count against
+ * the budget.
+ */
+struct StoredFrame
+{
+    DicomPixelFrame pixels;
+    QImage image;
+
+    bool isNull() const { return pixels.isNull() && image.isNull(); }
+    qint64 sizeInBytes() const
+    {
+        const qint64 sampleBytes = pixels.isMapped() ? 0 : static_cast<qint64>(pixels.samples.size());
+        return sampleBytes + static_cast<qint64>(image.sizeInBytes());
+    }
+};
+
+/**
+ * @brief Decoded frames of the open image under a memory budget
+ *
+ * Replaces the separate per-component frame caches: the loader inserts, and
+ * the viewer and frame processor read. All methods are thread-safe.
+ *
+ * When the budget is exceeded, frames are evicted in order of how far ahead
+ * of the playhead (in the playback direction, wrapping around) they are, so
+ * a looping cine run drops the frame it will need last. Until a playhead is
+ * set, the least recently used frame goes first. The frame being inserted is
+ * never evicted.
+ */
+class DicomFrameStore
+{
+public:
+    static constexpr int DefaultBudgetMB = 2048;
+
+    explicit DicomFrameStore(int budgetMB = DefaultBudgetMB);
+
+    void setBudgetMB(int budgetMB);
+    int budgetMB() const;
+
+    /**
+     * @brief Add or replace a frame, evicting others if over budget
+     */
+    void insert(int frameIndex, const DicomPixelFrame& pixels, const QImage& image = QImage());
+
+    /**
+     * @brief Look up a frame and mark it as recently used
+     * @return Shared view of the frame, or a null frame if not stored
+     */
+    StoredFrame frame(int frameIndex);
+
+    bool contains(int frameIndex) const;
+    bool isEmpty() const;
+
+    /**
+     * @brief Tell the store which frame is displayed
+     *
+     * A step of -1 (wrapping) switches to backward playback, a step of +1
+     * back to forward; jumps keep the current direction.
+     */
+    void setPlayhead(int frameIndex, int frameCount);
+
+    void clear();
+    qint64 bytesUsed() const;
+    int count() const;
+
+private:
+    struct Entry
+    {
+        StoredFrame frame;
+        std::list<int>::iterator lruPosition;
+    };
+
+    void evictLocked(int keepFrame);
+    int pickVictimLocked(int keepFrame) const;
+    void removeLocked(std::map<int, Entry>::iterator it);
+
+    mutable QMutex m_mutex;
+    std::map<int, Entry> m_frames;
+    std::list<int> m_lru;           // Most recently used first
+    qint64 m_budgetBytes;
+    qint64 m_bytesUsed;
+    int m_playhead;                 // -1 until the viewer reports one
+    int m_direction;                // +1 forward, -1 backward
+    int m_frameCount;
+};
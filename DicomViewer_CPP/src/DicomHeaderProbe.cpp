@@ -0,0 +1,107 @@
+#include "DicomHeaderProbe.h"
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmdata/dcfilefo.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcmetinf.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#endif
+
+#ifdef HAVE_DCMTK
+namespace {
+
+QString stringTag(DcmItem* item, const DcmTagKey& key)
+{
+    OFString value;
+    if (item && item->findAndGetOFString(key, value).good()) {
+        return QString::fromLatin1(value.c_str()).trimmed();
+    }
+    return QString();
+}
+
+double doubleTag(DcmItem* item, const DcmTagKey& key, double defaultValue)
+{
+    Float64 value = 0.0;
+    if (item && item->findAndGetFloat64(key, value).good()) {
+        return value;
+    }
+    return defaultValue;
+}
+
+} // namespace
+#endif
+
+DicomHeaderInfo DicomHeaderProbe::read(const QString& filePath)
+{
+    DicomHeaderInfo info;
+
+#ifdef HAVE_DCMTK
+    try {
+        DcmFileFormat fileFormat;
+        OFCondition status = fileFormat.loadFileUntilTag(filePath.toLocal8Bit().constData(),
+                                                         EXS_Unknown, EGL_noChange,
+                                                         DCM_MaxReadLength, ERM_autoDetect,
+                                                         DCM_PixelData);
+        if (status.bad()) {
+            return info;
+        }
+
+        DcmDataset* dataset = fileFormat.getDataset();
+        if (!dataset) {
+            return info;
+        }
+
+        Uint16 value16 = 0;
+        if (dataset->findAndGetUint16(DCM_Rows, value16).good()) info.rows = value16;
+        if (dataset->findAndGetUint16(DCM_Columns, value16).good()) info.columns = value16;
+        if (dataset->findAndGetUint16(DCM_BitsAllocated, value16).good()) info.bitsAllocated = value16;
+        if (dataset->findAndGetUint16(DCM_BitsStored, value16).good()) info.bitsStored = value16;
+        if (dataset->findAndGetUint16(DCM_SamplesPerPixel, value16).good()) info.samplesPerPixel = value16;
+
+        Sint32 value32 = 0;
+        if (dataset->findAndGetSint32(DCM_NumberOfFrames, value32).good() && value32 > 0) {
+            info.numberOfFrames = value32;
+        }
+        if (dataset->findAndGetSint32(DCM_InstanceNumber, value32).good()) {
+            info.instanceNumber = value32;
+        }
+
+        info.photometricInterpretation = stringTag(dataset, DCM_PhotometricInterpretation);
+        info.transferSyntaxUID = stringTag(fileFormat.getMetaInfo(), DCM_TransferSyntaxUID);
+        info.sopClassUID = stringTag(dataset, DCM_SOPClassUID);
+        info.sopInstanceUID = stringTag(dataset, DCM_SOPInstanceUID);
+        info.modality = stringTag(dataset, DCM_Modality);
+        info.seriesDescription = stringTag(dataset, DCM_SeriesDescription);
+
+        info.frameTime = doubleTag(dataset, DCM_FrameTime, 0.0);
+        info.recommendedFrameRate = doubleTag(dataset, DCM_RecommendedDisplayFrameRate, 0.0);
+        info.cineRate = doubleTag(dataset, DCM_CineRate, 0.0);
+
+        Float64 center = 0.0, width = 0.0;
+        if (dataset->findAndGetFloat64(DCM_WindowCenter, center).good() &&
+            dataset->findAndGetFloat64(DCM_WindowWidth, width).good() && width > 0.0) {
+            info.hasWindow = true;
+            info.windowCenter = center;
+            info.windowWidth = width;
+        }
+
+        info.rescaleSlope = doubleTag(dataset, DCM_RescaleSlope, 1.0);
+        info.rescaleIntercept = doubleTag(dataset, DCM_RescaleIntercept, 0.0);
+        if (info.rescaleSlope == 0.0) {
+            info.rescaleSlope = 1.0;
+        }
+
+        info.valid = true;
+
+    } catch (const std::exception& e) {
+        info.valid = false;
+    } catch (...) {
+        info.valid = false;
+    }
+#else
+    Q_UNUSED(filePath)
+#endif
+
+    return info;
+}
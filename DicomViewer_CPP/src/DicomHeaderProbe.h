@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QString>
+
+/**
+ * @brief Tag values read from a DICOM header without touching Pixel Data
+ *
+ * Filled by DicomHeaderProbe::read(). Numeric fields keep their defaults when
+ * the corresponding tag is absent.
+ */
+struct DicomHeaderInfo
+{
+    bool valid = false;                 // Header parsed successfully
+
+    quint16 rows = 0;
+    quint16 columns = 0;
+    int numberOfFrames = 1;
+    quint16 bitsAllocated = 0;
+    quint16 bitsStored = 0;
+    quint16 samplesPerPixel = 1;
+    QString photometricInterpretation;
+
+    QString transferSyntaxUID;
+    QString sopClassUID;
+    QString sopInstanceUID;
+    QString modality;
+    QString seriesDescription;
+    int instanceNumber = 0;
+
+    // Cine timing (0 when absent)
+    double frameTime = 0.0;             // (0018,1063) in milliseconds
+    double recommendedFrameRate = 0.0;  // (0008,2144)
+    double cineRate = 0.0;              // (0018,0040)
+
+    // First value of Window Center/Width when present
+    bool hasWindow = false;
+    double windowCenter = 0.0;
+    double windowWidth = 0.0;
+
+    double rescaleSlope = 1.0;
+    double rescaleIntercept = 0.0;
+
+    bool isImage() const { return rows > 0 && columns > 0; }
+    bool isStructuredReport() const { return sopClassUID.startsWith("1.2.840.10008.5.1.4.1.1.88."); }
+    bool isRadiationDoseSR() const { return sopClassUID == "1.2.840.10008.5.1.4.1.1.88.67"; }
+};
+
+/**
+ * @brief Reads header tags only, stopping before Pixel Data (7FE0,0010)
+ *
+ * Use this wherever a caller needs a handful of tags (frame count, SOP class,
+ * timing, windowing) rather than a full DcmFileFormat::loadFile(). Only the
+ * bytes up to the Pixel Data element are read, which on a multi-frame file
+ * is a few kilobytes instead of the whole file.
+ */
+class DicomHeaderProbe
+{
+public:
+    /**
+     * @brief Read the header of a DICOM file
+     * @param filePath Path to the DICOM file
+     * @return Header info; valid is false if the file could not be parsed
+     */
+    static DicomHeaderInfo read(const QString& filePath);
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+#include <memory>
+
+class MappedPixelData;
+
+/**
+ * @brief One decoded frame in its native stored bit depth
+ *
+ * Samples are the stored pixel values (BitsStored significant bits inside
+ * BitsAllocated-sized words) in host byte order. Modality rescale is not
+ * applied; slope and intercept travel with the frame so window/level can map
+ * stored values straight to display values. The QByteArray is implicitly
+ * shared, so copying a frame does not copy its pixels.
+ *
+ * Native frames of a memory-mapped file point straight into the mapping;
+ * mapping then keeps it alive for as long as any copy of the frame exists.
+ */
+struct DicomPixelFrame
+{
+    QByteArray samples;
+    int width = 0;
+    int height = 0;
+    int bitsAllocated = 8;
+    int bitsStored = 8;
+    bool isSigned = false;
+    int samplesPerPixel = 1;
+    bool monochrome1 = false;           // Photometric MONOCHROME1: low values display white
+    double rescaleSlope = 1.0;
+    double rescaleIntercept = 0.0;
+    std::shared_ptr<const MappedPixelData> mapping;   // Set when samples view a mapped file
+
+    bool isNull() const { return samples.isEmpty() || width <= 0 || height <= 0; }
+    int bytesPerSample() const { return bitsAllocated > 8 ? 2 : 1; }
+    qsizetype pixelCount() const { return static_cast<qsizetype>(width) * height; }
+    bool isMapped() const { return mapping != nullptr; }
+};
@@ -0,0 +1,457 @@
+#include "DicomSRDocument.h"
+#include <QFileInfo>
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmdata/dcfilefo.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcsequen.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#endif
+
+namespace {
+
+const char* const RadiationDoseSRClassUID = "1.2.840.10008.5.1.4.1.1.88.67";
+const char* const StructuredReportClassPrefix = "1.2.840.10008.5.1.4.1.1.88.";
+
+// Deeper content trees are cut off; real dose reports nest three or four levels
+constexpr int MaxContentDepth = 32;
+
+#ifdef HAVE_DCMTK
+bool readString(DcmItem* item, const DcmTagKey& key, QString& value)
+{
+    OFString text;
+    if (item && item->findAndGetOFString(key, text).good()) {
+        value = QString(text.c_str());
+        return true;
+    }
+    return false;
+}
+
+QString stringTag(DcmItem* item, const DcmTagKey& key)
+{
+    QString value;
+    readString(item, key, value);
+    return value;
+}
+
+// First item of a code/value sequence, or null
+DcmItem* firstSequenceItem(DcmItem* item, const DcmTagKey& key)
+{
+    DcmSequenceOfItems* sequence = nullptr;
+    if (item && item->findAndGetSequence(key, sequence).good() && sequence && sequence->card() > 0) {
+        return sequence->getItem(0);
+    }
+    return nullptr;
+}
+
+void parseContentSequence(DcmItem* parent, QVector<SRContentItem>& items, int depth)
+{
+    DcmSequenceOfItems* contentSeq = nullptr;
+    if (depth >= MaxContentDepth ||
+        parent->findAndGetSequence(DCM_ContentSequence, contentSeq).bad() || !contentSeq) {
+        return;
+    }
+
+    items.reserve(static_cast<int>(contentSeq->card()));
+    for (unsigned long i = 0; i < contentSeq->card(); i++) {
+        DcmItem* item = contentSeq->getItem(i);
+        if (!item) {
+            continue;
+        }
+
+        SRContentItem node;
+        node.conceptName = stringTag(firstSequenceItem(item, DCM_ConceptNameCodeSequence), DCM_CodeMeaning);
+        node.hasTextValue = readString(item, DCM_TextValue, node.textValue);
+
+        if (DcmItem* measuredItem = firstSequenceItem(item, DCM_MeasuredValueSequence)) {
+            node.hasNumericValue = readString(measuredItem, DCM_NumericValue, node.numericValue);
+            node.unit = stringTag(firstSequenceItem(measuredItem, DCM_MeasurementUnitsCodeSequence), DCM_CodeMeaning);
+        }
+
+        parseContentSequence(item, node.children, depth + 1);
+        items.append(node);
+    }
+}
+#endif
+
+const char* const ErrorPageStyle =
+    "<!DOCTYPE html><html><head><style>.error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; "
+    "padding: 15px; border: 1px solid #fadbd8; font-family: Arial, sans-serif; }</style></head><body>";
+
+} // namespace
+
+// ========== Model ==========
+
+bool DicomSRDocument::isRadiationDoseReport() const
+{
+    if (!isValid()) {
+        return false;
+    }
+    if (sopClassUID == RadiationDoseSRClassUID) {
+        return true;
+    }
+
+    // Only other SR documents can carry a dose report content tree
+    if (!sopClassUID.startsWith(StructuredReportClassPrefix)) {
+        return false;
+    }
+    for (const SRContentItem& item : content) {
+        if (item.conceptName.contains("Dose Report") ||
+            item.conceptName.contains("Radiation Dose") ||
+            item.conceptName.contains("X-Ray Dose")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DicomSRDocument DicomSRDocument::load(const QString& filePath)
+{
+    DicomSRDocument document;
+    document.filePath = filePath;
+
+#ifdef HAVE_DCMTK
+    try {
+        QFileInfo fileInfo(filePath);
+        if (!fileInfo.exists()) {
+            document.status = Status::FileMissing;
+            return document;
+        }
+        if (fileInfo.isDir()) {
+            document.status = Status::IsDirectory;
+            return document;
+        }
+        document.fileSize = fileInfo.size();
+
+        DcmFileFormat fileformat;
+        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
+        if (result.bad()) {
+            document.status = Status::LoadFailed;
+            document.errorText = result.text();
+            return document;
+        }
+
+        DcmDataset* dataset = fileformat.getDataset();
+        if (!dataset) {
+            document.status = Status::NoDataset;
+            return document;
+        }
+
+        document.sopClassUID = stringTag(dataset, DCM_SOPClassUID);
+        document.modality = stringTag(dataset, DCM_Modality);
+        document.patientName = stringTag(dataset, DCM_PatientName);
+        document.patientID = stringTag(dataset, DCM_PatientID);
+        document.patientSex = stringTag(dataset, DCM_PatientSex);
+        document.patientAge = stringTag(dataset, DCM_PatientAge);
+        document.studyDate = stringTag(dataset, DCM_StudyDate);
+        document.studyTime = stringTag(dataset, DCM_StudyTime);
+        document.studyDescription = stringTag(dataset, DCM_StudyDescription);
+        document.seriesDescription = stringTag(dataset, DCM_SeriesDescription);
+        document.protocolName = stringTag(dataset, DCM_ProtocolName);
+        document.institutionName = stringTag(dataset, DCM_InstitutionName);
+        document.manufacturer = stringTag(dataset, DCM_Manufacturer);
+        document.manufacturerModelName = stringTag(dataset, DCM_ManufacturerModelName);
+        document.deviceSerialNumber = stringTag(dataset, DCM_DeviceSerialNumber);
+
+        DcmSequenceOfItems* contentSeq = nullptr;
+        document.hasContentSequence = dataset->findAndGetSequence(DCM_ContentSequence, contentSeq).good() && contentSeq;
+        parseContentSequence(dataset, document.content, 0);
+
+        document.status = Status::Ok;
+    } catch (const std::exception& e) {
+        document.status = Status::LoadFailed;
+        document.errorText = e.what();
+    } catch (...) {
+        document.status = Status::LoadFailed;
+        document.errorText = "Unknown exception";
+    }
+#endif
+
+    return document;
+}
+
+// ========== HTML rendering ==========
+
+QString DicomSRHtmlRenderer::render(const DicomSRDocument& document)
+{
+    if (!document.isValid()) {
+        return renderError(document);
+    }
+    if (document.isRadiationDoseReport()) {
+        return renderRadiationDoseReport(document);
+    }
+    return renderBasicReport(document);
+}
+
+QString DicomSRHtmlRenderer::renderError(const DicomSRDocument& document)
+{
+    QString message;
+    switch (document.status) {
+    case DicomSRDocument::Status::FileMissing:
+        message = QString("Error: File does not exist<br><br>File: %1<br>Check if the file path is correct.")
+                  .arg(document.filePath);
+        break;
+    case DicomSRDocument::Status::IsDirectory:
+        message = QString("Error: Path is a directory, not a file<br><br>Path: %1<br>SR documents must be individual DICOM files.")
+                  .arg(document.filePath);
+        break;
+    case DicomSRDocument::Status::LoadFailed:
+        message = QString("Error: Could not load DICOM file<br><br>File: %1<br>Error: %2<br>File size: %3 bytes")
+                  .arg(document.filePath, document.errorText)
+                  .arg(document.fileSize);
+        break;
+    case DicomSRDocument::Status::NoDataset:
+        message = QString("Error: No dataset found in DICOM file<br><br>File: %1").arg(document.filePath);
+        break;
+    case DicomSRDocument::Status::NoDcmtk:
+    default:
+        return QString("Error: DCMTK support not available\n\nFile: %1\n\nDCMTK library is required for DICOM file reading.")
+               .arg(document.filePath);
+    }
+    return QString(ErrorPageStyle) + "<div class='error'>" + message + "</div></body></html>";
+}
+
+QString DicomSRHtmlRenderer::renderBasicReport(const DicomSRDocument& document)
+{
+    QString report;
+
+    // Start HTML document with professional styling
+    report += "<!DOCTYPE html><html><head><style>";
+    report += "body { font-family: 'Segoe UI', Tahoma, Arial, sans-serif; font-size: 11pt; line-height: 1.4; margin: 20px; background-color: #fdfdfd; }";
+    report += "h1 { font-size: 18pt; font-weight: bold; color: #2c3e50; text-align: center; margin: 20px 0; border-bottom: 3px solid #3498db; padding-bottom: 10px; }";
+    report += "h2 { font-size: 14pt; font-weight: bold; color: #34495e; margin: 20px 0 10px 0; border-left: 4px solid #3498db; padding-left: 10px; background-color: #f8f9fa; padding: 8px; }";
+    report += ".info-row { margin: 8px 0; padding: 4px 0; border-bottom: 1px dotted #ddd; }";
+    report += ".label { font-weight: bold; color: #2c3e50; display: inline-block; min-width: 150px; }";
+    report += ".value { color: #34495e; }";
+    report += ".warning { color: #f39c12; font-weight: bold; background-color: #fef9e7; padding: 10px; border: 1px solid #fcf3cf; margin: 10px 0; }";
+    report += "</style></head><body>";
+
+    report += "<h1>Structured Report Document</h1>";
+    report += "<h2>Basic Information</h2>";
+    report += infoRow("File Path", document.filePath);
+    report += infoRow("SOP Class UID", document.sopClassUID);
+    report += infoRow("Modality", document.modality);
+
+    report += "<div class='warning'>";
+    report += "<strong>Note:</strong> This structured report type is not fully supported for detailed formatting.<br>";
+    report += "Please use a dedicated DICOM viewer for complete SR analysis.";
+    report += "</div>";
+
+    report += "</body></html>";
+    return report;
+}
+
+QString DicomSRHtmlRenderer::renderRadiationDoseReport(const DicomSRDocument& document)
+{
+    QString report;
+
+    // Start HTML document with professional styling
+    report += "<!DOCTYPE html><html><head><style>";
+    report += "body { font-family: 'Segoe UI', Tahoma, Arial, sans-serif; font-size: 11pt; line-height: 1.4; margin: 20px; background-color: #fdfdfd; }";
+    report += "h1 { font-size: 18pt; font-weight: bold; color: #2c3e50; text-align: center; margin: 20px 0; border-bottom: 3px solid #3498db; padding-bottom: 10px; }";
+    report += "h2 { font-size: 14pt; font-weight: bold; color: #34495e; margin: 20px 0 10px 0; border-left: 4px solid #3498db; padding-left: 10px; background-color: #f8f9fa; padding: 8px; }";
+    report += "h3 { font-size: 12pt; font-weight: bold; color: #2c3e50; margin: 15px 0 8px 0; }";
+    report += ".info-row { margin: 8px 0; padding: 4px 0; border-bottom: 1px dotted #ddd; }";
+    report += ".label { font-weight: bold; color: #2c3e50; display: inline-block; min-width: 150px; }";
+    report += ".value { color: #34495e; }";
+    report += ".event { background-color: #f8f9fa; margin: 10px 0; padding: 15px; border-left: 3px solid #e74c3c; }";
+    report += ".measurement { margin: 5px 0 5px 20px; }";
+    report += ".error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; padding: 10px; border: 1px solid #fadbd8; }";
+    report += "</style></head><body>";
+
+    // Main Header
+    report += "<h1>RADIATION DOSE STRUCTURED REPORT</h1>";
+
+    // Add sections
+    report += formatHeader(document);
+    report += formatProcedureInfo(document);
+    report += formatAccumulatedDoseData(document);
+    report += formatIrradiationEvents(document);
+
+    // Close HTML
+    report += "</body></html>";
+    return report;
+}
+
+QString DicomSRHtmlRenderer::formatHeader(const DicomSRDocument& document)
+{
+    QString header;
+    header += "<h2>Patient & Study Information</h2>";
+
+    // Patient Information
+    header += infoRow("Patient Name", QString(document.patientName).replace("^", " ").trimmed());
+    header += infoRow("Patient ID", document.patientID);
+    header += infoRow("Patient Sex", document.patientSex);
+    header += infoRow("Patient Age", document.patientAge);
+
+    // Study Information
+    header += infoRow("Study Date", formatDateTime(document.studyDate));
+    header += infoRow("Study Time", formatDateTime(document.studyTime));
+    header += infoRow("Study Description", document.studyDescription);
+    header += infoRow("Institution", document.institutionName);
+
+    header += "<h3>Device Information</h3>";
+
+    // Device Information
+    header += infoRow("Manufacturer", document.manufacturer);
+    header += infoRow("Device Model", document.manufacturerModelName);
+    header += infoRow("Serial Number", document.deviceSerialNumber);
+
+    return header;
+}
+
+QString DicomSRHtmlRenderer::formatProcedureInfo(const DicomSRDocument& document)
+{
+    QString procedure;
+    procedure += "<h2>Procedure Information</h2>";
+
+    // Basic procedure info
+    procedure += infoRow("Procedure", document.studyDescription);
+    procedure += infoRow("Series Description", document.seriesDescription);
+    procedure += infoRow("Protocol", document.protocolName);
+
+    // Procedure-related information in the structured content
+    for (const SRContentItem& item : document.content) {
+        if ((item.conceptName.contains("Procedure") || item.conceptName.contains("Protocol")) && item.hasTextValue) {
+            procedure += QString("Protocol Detail: %1\n").arg(item.textValue);
+        }
+    }
+
+    return procedure;
+}
+
+QString DicomSRHtmlRenderer::formatAccumulatedDoseData(const DicomSRDocument& document)
+{
+    QString doseData;
+    doseData += "<h2>Accumulated Dose Data</h2>";
+
+    if (!document.hasContentSequence) {
+        doseData += "No content sequence found\n";
+        return doseData;
+    }
+
+    // Look for dose measurements among the top-level content items
+    QStringList foundDoseValues;
+    for (const SRContentItem& item : document.content) {
+        const QString& conceptStr = item.conceptName;
+        if (!conceptStr.contains("Dose", Qt::CaseInsensitive) &&
+            !conceptStr.contains("DAP", Qt::CaseInsensitive) &&
+            !conceptStr.contains("Air Kerma", Qt::CaseInsensitive) &&
+            !conceptStr.contains("Exposure", Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        if (item.hasNumericValue) {
+            QString measurement = formatMeasurement(conceptStr, item.numericValue, item.unit);
+            if (!foundDoseValues.contains(measurement)) {
+                foundDoseValues.append(measurement);
+                doseData += measurement + "\n";
+            }
+        }
+
+        // Also check for simple text values
+        if (item.hasTextValue) {
+            QString measurement = formatMeasurement(conceptStr, item.textValue);
+            if (!foundDoseValues.contains(measurement)) {
+                foundDoseValues.append(measurement);
+                doseData += measurement + "\n";
+            }
+        }
+    }
+
+    if (foundDoseValues.isEmpty()) {
+        doseData += "No dose measurements found in structured report\n";
+    }
+    return doseData;
+}
+
+QString DicomSRHtmlRenderer::formatIrradiationEvents(const DicomSRDocument& document)
+{
+    QString events;
+    events += "<h2>Irradiation Events</h2>";
+
+    if (!document.hasContentSequence) {
+        events += "<div class='info-row'>No content sequence found</div>";
+        return events;
+    }
+
+    int eventCount = 0;
+    for (const SRContentItem& item : document.content) {
+        if (!item.conceptName.contains("Irradiation Event", Qt::CaseInsensitive) &&
+            !item.conceptName.contains("Radiation Event", Qt::CaseInsensitive) &&
+            !item.conceptName.contains("Exposure Event", Qt::CaseInsensitive)) {
+            continue;
+        }
+
+        eventCount++;
+        events += QString("<div class='event'><h3>Event %1</h3>").arg(eventCount);
+
+        // Event details are the direct children of the event container
+        for (const SRContentItem& child : item.children) {
+            if (child.conceptName.isEmpty()) {
+                continue;
+            }
+            if (child.hasTextValue) {
+                events += formatMeasurement(child.conceptName, child.textValue) + "\n";
+            } else if (child.hasNumericValue) {
+                events += formatMeasurement(child.conceptName, child.numericValue, child.unit) + "\n";
+            }
+        }
+
+        events += "</div>";
+    }
+
+    if (eventCount == 0) {
+        events += "<div class='info-row'>No irradiation events found in structured report</div>";
+    }
+    return events;
+}
+
+QString DicomSRHtmlRenderer::formatDateTime(const QString& dtString)
+{
+    if (dtString.length() >= 8) {
+        QString year = dtString.mid(0, 4);
+        QString month = dtString.mid(4, 2);
+        QString day = dtString.mid(6, 2);
+
+        QString formatted = QString("%1-%2-%3").arg(day, month, year);
+
+        if (dtString.length() >= 14) {
+            QString hour = dtString.mid(8, 2);
+            QString minute = dtString.mid(10, 2);
+            QString second = dtString.mid(12, 2);
+            formatted += QString(" %1:%2:%3").arg(hour, minute, second);
+        }
+
+        return formatted;
+    }
+
+    return dtString;
+}
+
+QString DicomSRHtmlRenderer::formatMeasurement(const QString& name, const QString& value, const QString& unit)
+{
+    QString result = QString("<div class='measurement'><span class='label'>%1:</span> <span class='value'>%2").arg(name, value);
+
+    if (!unit.isEmpty() && unit != value) {
+        QString cleanUnit = unit;
+        // Fix degree symbol encoding issues
+        if (cleanUnit.contains("?") || cleanUnit.toLower().contains("degree")) {
+            cleanUnit = "degrees";
+        }
+        result += " " + cleanUnit;
+    }
+
+    result += "</span></div>";
+    return result;
+}
+
+QString DicomSRHtmlRenderer::infoRow(const QString& label, const QString& value)
+{
+    // Absent attributes get no row
+    if (value.isEmpty()) {
+        return QString();
+    }
+    return QString("<div class='info-row'><span class='label'>%1:</span> <span class='value'>%2</span></div>").arg(label, value);
+}
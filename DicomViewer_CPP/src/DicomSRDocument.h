@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief One node of an SR content tree
+ *
+ * Only the parts the report views use are kept: the concept name, a text
+ * value, the first measured value with its unit, and the child items.
+ */
+struct SRContentItem
+{
+    QString conceptName;            // Code Meaning of the Concept Name Code Sequence
+    bool hasTextValue = false;
+    QString textValue;              // (0040,A160)
+    bool hasNumericValue = false;
+    QString numericValue;           // (0040,A30A) of the first Measured Value Sequence item
+    QString unit;                   // Code Meaning of its Measurement Units Code Sequence
+    QVector<SRContentItem> children;
+};
+
+/**
+ * @brief Structured report parsed once into a content tree
+ *
+ * load() reads the file a single time and copies the header attributes and
+ * the whole Content Sequence tree into plain Qt types, so the DCMTK dataset
+ * is released before rendering starts. It is safe to call on worker threads.
+ */
+struct DicomSRDocument
+{
+    enum class Status
+    {
+        Ok,
+        FileMissing,
+        IsDirectory,
+        LoadFailed,
+        NoDataset,
+        NoDcmtk
+    };
+
+    Status status = Status::NoDcmtk;
+    QString filePath;
+    qint64 fileSize = 0;
+    QString errorText;              // Load error or exception message
+
+    QString sopClassUID;
+    QString modality;
+    QString patientName;
+    QString patientID;
+    QString patientSex;
+    QString patientAge;
+    QString studyDate;
+    QString studyTime;
+    QString studyDescription;
+    QString seriesDescription;
+    QString protocolName;
+    QString institutionName;
+    QString manufacturer;
+    QString manufacturerModelName;
+    QString deviceSerialNumber;
+
+    bool hasContentSequence = false;
+    QVector<SRContentItem> content; // Top-level Content Sequence items
+
+    bool isValid() const { return status == Status::Ok; }
+
+    /**
+     * @brief X-Ray Radiation Dose SR by SOP class, or an SR whose top-level
+     *        content names a dose report
+     */
+    bool isRadiationDoseReport() const;
+
+    static DicomSRDocument load(const QString& filePath);
+};
+
+/**
+ * @brief Renders a DicomSRDocument as the HTML shown in the report area
+ *
+ * Pure functions of the model; safe on worker threads.
+ */
+class DicomSRHtmlRenderer
+{
+public:
+    static QString render(const DicomSRDocument& document);
+
+private:
+    static QString renderError(const DicomSRDocument& document);
+    static QString renderBasicReport(const DicomSRDocument& document);
+    static QString renderRadiationDoseReport(const DicomSRDocument& document);
+    static QString formatHeader(const DicomSRDocument& document);
+    static QString formatProcedureInfo(const DicomSRDocument& document);
+    static QString formatAccumulatedDoseData(const DicomSRDocument& document);
+    static QString formatIrradiationEvents(const DicomSRDocument& document);
+    static QString formatDateTime(const QString& dtString);
+    static QString formatMeasurement(const QString& name, const QString& value, const QString& unit = QString());
+    static QString infoRow(const QString& label, const QString& value);
+};
@@ -0,0 +1,268 @@
+#include "DicomTagModel.h"
+#include "DicomDatasetHandle.h"
+#include <QBrush>
+#include <QColor>
+#include <QFont>
+#include <QMutexLocker>
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcelem.h"
+#include "dcmtk/dcmdata/dcsequen.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/dcmdata/dcvr.h"
+#endif
+
+namespace {
+
+// Longer values are cut in the panel
+constexpr int MaxValueLength = 100;
+
+QColor colorForVR(const QString& vr)
+{
+    if (vr == "SQ") {
+        return QColor(100, 150, 255);   // Sequences in blue
+    } else if (vr == "UI" || vr == "SH" || vr == "LO" || vr == "ST" || vr == "LT" || vr == "UT" || vr == "CS" || vr == "PN") {
+        return QColor(150, 255, 150);   // String types in light green
+    } else if (vr == "US" || vr == "SS" || vr == "UL" || vr == "SL" || vr == "FL" || vr == "FD" || vr == "DS" || vr == "IS") {
+        return QColor(255, 255, 150);   // Numeric types in yellow
+    }
+    return QColor(255, 255, 255);
+}
+
+bool isBinaryVR(const QString& vr)
+{
+    return vr == "OB" || vr == "OW" || vr == "OF" || vr == "OD" || vr == "OL" || vr == "OV" ||
+           vr == "UN" || vr == "ox" || vr == "px" || vr == "pi" || vr == "lt";
+}
+
+} // namespace
+
+DicomTagModel::DicomTagModel(QObject* parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+DicomTagModel::~DicomTagModel()
+{
+}
+
+void DicomTagModel::setDataset(const std::shared_ptr<DicomDatasetHandle>& dataset)
+{
+    if (dataset == m_dataset) {
+        return;
+    }
+
+    beginResetModel();
+    m_root.reset();
+    m_dataset = dataset;
+
+#ifdef HAVE_DCMTK
+    if (m_dataset) {
+        QMutexLocker locker(m_dataset->mutex());
+        if (DcmDataset* root = m_dataset->dataset()) {
+            m_root = std::make_unique<Node>();
+            m_root->object = root;
+            m_root->isItem = true;
+            m_root->childCount = static_cast<int>(root->card());
+        }
+    }
+#endif
+
+    endResetModel();
+}
+
+void DicomTagModel::clear()
+{
+    setDataset(nullptr);
+}
+
+DicomTagModel::Node* DicomTagModel::nodeFor(const QModelIndex& index) const
+{
+    return index.isValid() ? static_cast<Node*>(index.internalPointer()) : m_root.get();
+}
+
+QModelIndex DicomTagModel::index(int row, int column, const QModelIndex& parent) const
+{
+    Node* parentNode = nodeFor(parent);
+    if (!parentNode || row < 0 || column < 0 || column >= ColumnCount ||
+        row >= static_cast<int>(parentNode->children.size())) {
+        return QModelIndex();
+    }
+    return createIndex(row, column, parentNode->children[row].get());
+}
+
+QModelIndex DicomTagModel::parent(const QModelIndex& child) const
+{
+    if (!child.isValid()) {
+        return QModelIndex();
+    }
+    Node* parentNode = static_cast<Node*>(child.internalPointer())->parent;
+    if (!parentNode || parentNode == m_root.get()) {
+        return QModelIndex();
+    }
+    return createIndex(parentNode->row, 0, parentNode);
+}
+
+int DicomTagModel::rowCount(const QModelIndex& parent) const
+{
+    if (parent.column() > 0) {
+        return 0;
+    }
+    Node* node = nodeFor(parent);
+    return node ? static_cast<int>(node->children.size()) : 0;
+}
+
+int DicomTagModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return ColumnCount;
+}
+
+bool DicomTagModel::hasChildren(const QModelIndex& parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+    Node* node = nodeFor(parent);
+    return node && node->childCount > 0;
+}
+
+bool DicomTagModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (parent.column() > 0) {
+        return false;
+    }
+    Node* node = nodeFor(parent);
+    return node && static_cast<int>(node->children.size()) < node->childCount;
+}
+
+void DicomTagModel::fetchMore(const QModelIndex& parent)
+{
+    Node* node = nodeFor(parent);
+    if (!node || !m_dataset) {
+        return;
+    }
+
+    const int first = static_cast<int>(node->children.size());
+    const int last = qMin(node->childCount, first + FetchBatchSize) - 1;
+    if (last < first) {
+        return;
+    }
+
+#ifdef HAVE_DCMTK
+    beginInsertRows(parent, first, last);
+    {
+        QMutexLocker locker(m_dataset->mutex());
+        for (int row = first; row <= last; ++row) {
+            auto child = std::make_unique<Node>();
+            child->parent = node;
+            child->row = row;
+            if (node->isItem) {
+                // Elements of the dataset or of a sequence item
+                child->object = static_cast<DcmItem*>(node->object)->getElement(static_cast<unsigned long>(row));
+            } else {
+                // Items of a sequence
+                child->object = static_cast<DcmSequenceOfItems*>(node->object)->getItem(static_cast<unsigned long>(row));
+                child->isItem = true;
+            }
+            describeLocked(child.get());
+            node->children.push_back(std::move(child));
+        }
+    }
+    endInsertRows();
+#endif
+}
+
+void DicomTagModel::describeLocked(Node* node) const
+{
+#ifdef HAVE_DCMTK
+    if (!node->object) {
+        return;
+    }
+
+    if (node->isItem) {
+        DcmItem* item = static_cast<DcmItem*>(node->object);
+        node->childCount = static_cast<int>(item->card());
+        node->name = QString("Item #%1").arg(node->row + 1);
+        node->value = QString("%1 elements").arg(node->childCount);
+        node->vr = "SQ";
+        return;
+    }
+
+    DcmElement* elem = static_cast<DcmElement*>(node->object);
+    DcmTag tag = elem->getTag();
+    node->tag = QString("(%1,%2)").arg(tag.getGTag(), 4, 16, QChar('0')).arg(tag.getETag(), 4, 16, QChar('0')).toUpper();
+    node->vr = QString::fromLatin1(DcmVR(elem->getVR()).getVRName());
+    node->name = QString::fromLatin1(tag.getTagName());
+    if (node->name.isEmpty()) {
+        node->name = QString("Unknown Tag %1").arg(node->tag);
+    }
+
+    if (elem->ident() == EVR_SQ) {
+        node->childCount = static_cast<int>(static_cast<DcmSequenceOfItems*>(elem)->card());
+        node->value = QString("%1 items").arg(node->childCount);
+    } else if (isBinaryVR(node->vr) || tag == DCM_PixelData) {
+        // The length is in the header; the value itself stays on disk
+        Uint32 length = elem->getLength();
+        node->value = (length == DCM_UndefinedLength) ? QString("[Encapsulated]") : QString("[%1 bytes]").arg(length);
+    } else {
+        OFString ofString;
+        if (elem->getOFString(ofString, 0).good()) {
+            node->value = QString::fromLatin1(ofString.c_str());
+            if (node->value.length() > MaxValueLength) {
+                node->value = node->value.left(MaxValueLength - 3) + "...";
+            }
+        } else {
+            node->value = "[Empty]";
+        }
+    }
+#else
+    Q_UNUSED(node);
+#endif
+}
+
+QVariant DicomTagModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid()) {
+        return QVariant();
+    }
+    const Node* node = static_cast<Node*>(index.internalPointer());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::ToolTipRole:
+        switch (index.column()) {
+        case TagColumn: return node->tag;
+        case NameColumn: return node->name;
+        case ValueColumn: return node->value;
+        default: return QVariant();
+        }
+    case Qt::ForegroundRole:
+        return QBrush(colorForVR(node->vr));
+    case Qt::FontRole:
+        if (index.column() == NameColumn) {
+            static const QFont boldFont = [] { QFont font; font.setBold(true); return font; }();
+            return boldFont;
+        } else {
+            static const QFont monospaceFont = [] { QFont font("Consolas"); font.setStyleHint(QFont::Monospace); return font; }();
+            return monospaceFont;
+        }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant DicomTagModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    switch (section) {
+    case TagColumn: return QString("Group,Elem.");
+    case NameColumn: return QString("TAG Description");
+    case ValueColumn: return QString("Value");
+    default: return QVariant();
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class DicomDatasetHandle;
+class DcmObject;
+
+/**
+ * @brief Tree model of the tags of an already parsed dataset
+ *
+ * Reads straight from a shared DicomDatasetHandle, so showing the tag panel
+ * never parses the file again. Rows are created in batches through
+ * canFetchMore()/fetchMore(), and sequence items and their elements only
+ * when the view expands them, so a dataset with large private sequences
+ * costs a few hundred rows up front. Binary values (OB, OW, UN, ...) are
+ * shown by length and never loaded from disk.
+ *
+ * Columns: tag "(gggg,eeee)", tag name, value. Text colour follows the VR.
+ * GUI thread only; the handle's mutex is taken while rows are created.
+ */
+class DicomTagModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    enum Column { TagColumn = 0, NameColumn, ValueColumn, ColumnCount };
+
+    explicit DicomTagModel(QObject* parent = nullptr);
+    ~DicomTagModel() override;
+
+    /**
+     * @brief Show the tags of a dataset; a no-op if it is already shown
+     */
+    void setDataset(const std::shared_ptr<DicomDatasetHandle>& dataset);
+
+    /**
+     * @brief Drop all rows and release the dataset
+     */
+    void clear();
+
+    const std::shared_ptr<DicomDatasetHandle>& dataset() const { return m_dataset; }
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& child) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    // Rows created per fetchMore() call
+    static constexpr int FetchBatchSize = 256;
+
+    struct Node
+    {
+        Node* parent = nullptr;
+        int row = 0;
+        DcmObject* object = nullptr;    // DcmElement, or the DcmItem of a sequence item / the dataset
+        bool isItem = false;
+        int childCount = 0;             // Children in the dataset
+        std::vector<std::unique_ptr<Node>> children;   // Created so far
+        QString tag;
+        QString name;
+        QString value;
+        QString vr;
+    };
+
+    Node* nodeFor(const QModelIndex& index) const;
+    void describeLocked(Node* node) const;
+
+    std::shared_ptr<DicomDatasetHandle> m_dataset;
+    std::unique_ptr<Node> m_root;
+};
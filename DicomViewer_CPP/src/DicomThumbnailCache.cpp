@@ -0,0 +1,354 @@
+#include "DicomThumbnailCache.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+// File layout (host byte order - the cache never leaves the machine):
+//   8-byte magic, then records. Each record starts 8-byte aligned with a
+//   RecordHeader, followed by the UID, path and instance number (UTF-8), then
+//   the thumbnail rows at a 4-byte aligned offset, padded to 8 bytes.
+const char FileMagic[8] = {'E', 'K', 'N', 'T', 'H', 'C', '0', '1'};
+const quint32 RecordTag = 0x52544B45;           // "EKTR"
+const qint64 MaxCacheBytes = 512LL * 1024 * 1024;
+const int MinStaleForCompaction = 32;
+
+struct RecordHeader
+{
+    quint32 tag;
+    quint32 recordSize;
+    qint64 fileSize;
+    qint64 modifiedMs;
+    qint32 frameCount;
+    quint16 uidBytes;
+    quint16 pathBytes;
+    quint16 instanceBytes;
+    quint16 width;
+    quint16 height;
+    quint16 bytesPerLine;
+};
+static_assert(sizeof(RecordHeader) == 40, "RecordHeader layout");
+
+qint64 alignUp(qint64 value, qint64 alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+DicomThumbnailCache::DicomThumbnailCache()
+    : m_map(nullptr)
+    , m_mapSize(0)
+{
+}
+
+DicomThumbnailCache::~DicomThumbnailCache()
+{
+    close();
+}
+
+QString DicomThumbnailCache::defaultCacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbnails.ekc";
+}
+
+bool DicomThumbnailCache::open(const QString& cacheFilePath)
+{
+    close();
+
+    QMutexLocker locker(&m_mutex);
+    m_filePath = cacheFilePath;
+    QDir().mkpath(QFileInfo(cacheFilePath).absolutePath());
+
+    try {
+        return mapAndIndexLocked();
+    } catch (const std::exception&) {
+        return false;
+    } catch (...) {
+        return false;
+    }
+}
+
+void DicomThumbnailCache::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_pathIndex.clear();
+    m_appendFile.reset();
+    if (m_mapFile) {
+        if (m_map) {
+            m_mapFile->unmap(m_map);
+        }
+        m_mapFile.reset();
+    }
+    m_map = nullptr;
+    m_mapSize = 0;
+}
+
+bool DicomThumbnailCache::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_appendFile != nullptr;
+}
+
+int DicomThumbnailCache::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+QString DicomThumbnailCache::keyFor(const QString& filePath, const QString& sopInstanceUID)
+{
+    return sopInstanceUID.isEmpty() ? QStringLiteral("file:") + QDir::cleanPath(filePath) : sopInstanceUID;
+}
+
+bool DicomThumbnailCache::lookup(const QString& filePath, const QString& sopInstanceUID, Entry& entry) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_appendFile) {
+        return false;
+    }
+
+    const QString key = sopInstanceUID.isEmpty()
+        ? m_pathIndex.value(QDir::cleanPath(filePath), keyFor(filePath, QString()))
+        : sopInstanceUID;
+    auto it = m_entries.constFind(key);
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    // Only valid while the file is unchanged
+    QFileInfo info(filePath);
+    if (!info.exists() || info.size() != it->fileSize ||
+        info.lastModified().toMSecsSinceEpoch() != it->modifiedMs) {
+        return false;
+    }
+
+    entry = *it;
+    return true;
+}
+
+void DicomThumbnailCache::insert(Entry entry)
+{
+    if (entry.fileSize == 0 || entry.modifiedMs == 0) {
+        QFileInfo info(entry.filePath);
+        if (!info.exists()) {
+            return;
+        }
+        entry.fileSize = info.size();
+        entry.modifiedMs = info.lastModified().toMSecsSinceEpoch();
+    }
+    entry.filePath = QDir::cleanPath(entry.filePath);
+    if (!entry.thumbnail.isNull() && entry.thumbnail.format() != QImage::Format_RGB888) {
+        entry.thumbnail = entry.thumbnail.convertToFormat(QImage::Format_RGB888);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_appendFile) {
+        return;
+    }
+
+    const QString key = keyFor(entry.filePath, entry.sopInstanceUID);
+    auto it = m_entries.constFind(key);
+    if (it != m_entries.constEnd() && it->fileSize == entry.fileSize && it->modifiedMs == entry.modifiedMs) {
+        // Same unchanged file - merge rather than lose what is already cached
+        const Entry& cached = *it;
+        if (entry.thumbnail.isNull()) {
+            entry.thumbnail = cached.thumbnail;
+        }
+        if (entry.frameCount <= 0) {
+            entry.frameCount = cached.frameCount;
+        }
+        if (entry.instanceNumber.isEmpty()) {
+            entry.instanceNumber = cached.instanceNumber;
+        }
+        if (entry.frameCount == cached.frameCount && entry.instanceNumber == cached.instanceNumber &&
+            entry.thumbnail.cacheKey() == cached.thumbnail.cacheKey()) {
+            return;  // Nothing new
+        }
+    }
+
+    if (!appendLocked(entry)) {
+        return;
+    }
+
+    m_entries.insert(key, entry);
+    m_pathIndex.insert(entry.filePath, key);
+}
+
+QByteArray DicomThumbnailCache::encodeRecord(const Entry& entry)
+{
+    const QByteArray uid = entry.sopInstanceUID.toUtf8().left(0xFFFF);
+    const QByteArray path = entry.filePath.toUtf8().left(0xFFFF);
+    const QByteArray instance = entry.instanceNumber.toUtf8().left(0xFFFF);
+
+    const QImage& image = entry.thumbnail;
+    const bool hasImage = !image.isNull() && image.width() <= 0xFFFF && image.height() <= 0xFFFF;
+    const int bytesPerLine = hasImage ? static_cast<int>(alignUp(image.width() * 3, 4)) : 0;
+
+    RecordHeader header;
+    header.tag = RecordTag;
+    header.fileSize = entry.fileSize;
+    header.modifiedMs = entry.modifiedMs;
+    header.frameCount = entry.frameCount;
+    header.uidBytes = static_cast<quint16>(uid.size());
+    header.pathBytes = static_cast<quint16>(path.size());
+    header.instanceBytes = static_cast<quint16>(instance.size());
+    header.width = hasImage ? static_cast<quint16>(image.width()) : 0;
+    header.height = hasImage ? static_cast<quint16>(image.height()) : 0;
+    header.bytesPerLine = static_cast<quint16>(bytesPerLine);
+
+    const qint64 pixelOffset = alignUp(sizeof(RecordHeader) + uid.size() + path.size() + instance.size(), 4);
+    const qint64 recordSize = alignUp(pixelOffset + static_cast<qint64>(header.height) * bytesPerLine, 8);
+    header.recordSize = static_cast<quint32>(recordSize);
+
+    QByteArray record(static_cast<int>(recordSize), '\0');
+    char* out = record.data();
+    memcpy(out, &header, sizeof(header));
+    qint64 offset = sizeof(header);
+    memcpy(out + offset, uid.constData(), uid.size());
+    offset += uid.size();
+    memcpy(out + offset, path.constData(), path.size());
+    offset += path.size();
+    memcpy(out + offset, instance.constData(), instance.size());
+
+    for (int y = 0; y < header.height; ++y) {
+        memcpy(out + pixelOffset + static_cast<qint64>(y) * bytesPerLine, image.constScanLine(y),
+               static_cast<size_t>(header.width) * 3);
+    }
+    return record;
+}
+
+bool DicomThumbnailCache::appendLocked(const Entry& entry)
+{
+    const QByteArray record = encodeRecord(entry);
+    if (m_appendFile->write(record) != record.size()) {
+        return false;
+    }
+    return m_appendFile->flush();
+}
+
+bool DicomThumbnailCache::mapAndIndexLocked()
+{
+    m_entries.clear();
+    m_pathIndex.clear();
+
+    // Start over on a missing, foreign or oversized file
+    QFileInfo info(m_filePath);
+    bool valid = info.exists() && info.size() >= static_cast<qint64>(sizeof(FileMagic)) &&
+                 info.size() <= MaxCacheBytes;
+    if (valid) {
+        QFile probe(m_filePath);
+        char magic[sizeof(FileMagic)];
+        valid = probe.open(QIODevice::ReadOnly) &&
+                probe.read(magic, sizeof(magic)) == static_cast<qint64>(sizeof(magic)) &&
+                memcmp(magic, FileMagic, sizeof(magic)) == 0;
+    }
+    if (!valid) {
+        QFile fresh(m_filePath);
+        if (!fresh.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+            fresh.write(FileMagic, sizeof(FileMagic)) != static_cast<qint64>(sizeof(FileMagic))) {
+            return false;
+        }
+    }
+
+    m_mapFile.reset(new QFile(m_filePath));
+    if (!m_mapFile->open(QIODevice::ReadOnly)) {
+        m_mapFile.reset();
+        return false;
+    }
+    m_mapSize = m_mapFile->size();
+    m_map = m_mapFile->map(0, m_mapSize);
+    if (!m_map) {
+        m_mapFile.reset();
+        return false;
+    }
+
+    // Index records; a later record for the same key supersedes an earlier one
+    QHash<QString, QPair<qint64, qint64>> liveRanges;
+    int staleRecords = 0;
+    qint64 position = sizeof(FileMagic);
+    while (position + static_cast<qint64>(sizeof(RecordHeader)) <= m_mapSize) {
+        RecordHeader header;
+        memcpy(&header, m_map + position, sizeof(header));
+        const qint64 stringBytes = static_cast<qint64>(header.uidBytes) + header.pathBytes + header.instanceBytes;
+        const qint64 pixelOffset = alignUp(sizeof(RecordHeader) + stringBytes, 4);
+        if (header.tag != RecordTag || header.recordSize % 8 != 0 ||
+            position + header.recordSize > m_mapSize ||
+            pixelOffset + static_cast<qint64>(header.height) * header.bytesPerLine > header.recordSize ||
+            (header.width > 0 && header.bytesPerLine < header.width * 3)) {
+            break;  // Torn write at the end of the file
+        }
+
+        const char* strings = reinterpret_cast<const char*>(m_map + position + sizeof(RecordHeader));
+        Entry entry;
+        entry.sopInstanceUID = QString::fromUtf8(strings, header.uidBytes);
+        entry.filePath = QString::fromUtf8(strings + header.uidBytes, header.pathBytes);
+        entry.instanceNumber = QString::fromUtf8(strings + header.uidBytes + header.pathBytes,
+                                                 header.instanceBytes);
+        entry.fileSize = header.fileSize;
+        entry.modifiedMs = header.modifiedMs;
+        entry.frameCount = header.frameCount;
+        if (header.width > 0 && header.height > 0) {
+            // Zero-copy view of the mapped rows; the const buffer makes writers detach
+            entry.thumbnail = QImage(static_cast<const uchar*>(m_map + position + pixelOffset),
+                                     header.width, header.height, header.bytesPerLine, QImage::Format_RGB888);
+        }
+
+        const QString key = keyFor(entry.filePath, entry.sopInstanceUID);
+        if (m_entries.contains(key)) {
+            ++staleRecords;
+        }
+        m_entries.insert(key, entry);
+        m_pathIndex.insert(entry.filePath, key);
+        liveRanges.insert(key, qMakePair(position, static_cast<qint64>(header.recordSize)));
+        position += header.recordSize;
+    }
+
+    const bool tornTail = position != m_mapSize;
+    if (tornTail || (staleRecords >= MinStaleForCompaction && staleRecords > m_entries.size())) {
+        QList<QByteArray> liveRecords;
+        for (auto it = liveRanges.constBegin(); it != liveRanges.constEnd(); ++it) {
+            liveRecords.append(QByteArray(reinterpret_cast<const char*>(m_map + it->first),
+                                          static_cast<int>(it->second)));
+        }
+        return compactLocked(liveRecords);
+    }
+
+    m_appendFile.reset(new QFile(m_filePath));
+    if (!m_appendFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        m_appendFile.reset();
+        return false;
+    }
+    return true;
+}
+
+bool DicomThumbnailCache::compactLocked(const QList<QByteArray>& liveRecords)
+{
+    // Views into the mapping must go before it does
+    m_entries.clear();
+    m_pathIndex.clear();
+    m_mapFile->unmap(m_map);
+    m_map = nullptr;
+    m_mapFile.reset();
+
+    QSaveFile compacted(m_filePath);
+    if (!compacted.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    compacted.write(FileMagic, sizeof(FileMagic));
+    for (const QByteArray& record : liveRecords) {
+        compacted.write(record);
+    }
+    if (!compacted.commit()) {
+        return false;
+    }
+
+    // The rewritten file has no stale records or torn tail, so this does not recurse again
+    return mapAndIndexLocked();
+}
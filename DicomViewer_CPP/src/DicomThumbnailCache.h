@@ -0,0 +1,98 @@
+#pragma once
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QString>
+#include <memory>
+
+/**
+ * @brief Persistent thumbnail and header cache, memory-mapped on open
+ *
+ * One append-only file of records. Each record holds the identity of a DICOM
+ * file (SOP Instance UID, path, size, modification time), the header values
+ * the viewer probes (frame count, instance number) and optionally the
+ * rendered thumbnail as raw RGB888 rows. open() maps the file and indexes
+ * every record, and thumbnails of mapped records are QImages over the
+ * mapping, so serving a full strip copies nothing until the pixmap upload.
+ * Records added during the session are appended to the file and held in
+ * memory until the next open().
+ *
+ * Entries are keyed by SOP Instance UID (by path when the UID is unknown),
+ * so a disc copied to a new location still hits. An entry is only returned
+ * while the size and modification time of the file on disk match the
+ * record. Superseded records are compacted away on open() once they
+ * outnumber the live ones.
+ *
+ * All methods are thread-safe. Thumbnails returned for mapped records stay
+ * valid until close().
+ */
+class DicomThumbnailCache
+{
+public:
+    struct Entry
+    {
+        QString sopInstanceUID;     // Empty if not known
+        QString filePath;
+        qint64 fileSize = 0;
+        qint64 modifiedMs = 0;      // Last modification, ms since epoch (UTC)
+        int frameCount = 0;         // 0 = not probed
+        QString instanceNumber;
+        QImage thumbnail;           // Null for header-only entries
+    };
+
+    DicomThumbnailCache();
+    ~DicomThumbnailCache();
+
+    DicomThumbnailCache(const DicomThumbnailCache&) = delete;
+    DicomThumbnailCache& operator=(const DicomThumbnailCache&) = delete;
+
+    /**
+     * @brief Default cache file in the per-user cache directory
+     */
+    static QString defaultCacheFilePath();
+
+    /**
+     * @brief Map an existing cache file (or create an empty one) and index it
+     * @return true if the cache can be used
+     */
+    bool open(const QString& cacheFilePath);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief Find the entry for a file that is unchanged since it was cached
+     * @param filePath File on disk; its size and modification time are checked
+     * @param sopInstanceUID UID if known (e.g. from DICOMDIR), otherwise empty
+     * @param entry Receives the cached entry on a hit
+     */
+    bool lookup(const QString& filePath, const QString& sopInstanceUID, Entry& entry) const;
+
+    /**
+     * @brief Add or replace the entry for a file and append it to the cache file
+     *
+     * fileSize and modifiedMs are taken from disk when zero. A header-only
+     * entry does not replace a cached thumbnail of the same unchanged file.
+     */
+    void insert(Entry entry);
+
+    int count() const;
+
+private:
+    bool mapAndIndexLocked();
+    bool compactLocked(const QList<QByteArray>& liveRecords);
+    bool appendLocked(const Entry& entry);
+    static QByteArray encodeRecord(const Entry& entry);
+    static QString keyFor(const QString& filePath, const QString& sopInstanceUID);
+
+    mutable QMutex m_mutex;
+    QString m_filePath;
+    std::unique_ptr<QFile> m_mapFile;   // Read-only handle owning the mapping
+    uchar* m_map;
+    qint64 m_mapSize;
+    std::unique_ptr<QFile> m_appendFile;
+
+    QHash<QString, Entry> m_entries;    // By key (UID, or path when no UID)
+    QHash<QString, QString> m_pathIndex; // File path -> key
+};
@@ -0,0 +1,446 @@
+#include "EncapsulatedFrameDecoder.h"
+#include "TurboJpegDecoder.h"
+#include <QMutexLocker>
+#include <QtEndian>
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/dcmdata/dcdatset.h"
+#include "dcmtk/dcmdata/dcdeftag.h"
+#include "dcmtk/dcmdata/dcpixel.h"
+#include "dcmtk/dcmdata/dcpxitem.h"
+#include "dcmtk/dcmdata/dcxfer.h"
+#include "dcmtk/dcmjpeg/djcparam.h"
+#include "dcmtk/dcmjpeg/djdijg8.h"
+#include "dcmtk/dcmjpeg/djdijg12.h"
+#include "dcmtk/dcmjpeg/djdijg16.h"
+#endif
+
+EncapsulatedFrameDecoder::EncapsulatedFrameDecoder()
+    :
+#ifdef HAVE_DCMTK
+      m_pixelSequence(nullptr),
+#endif
+      m_rows(0)
+    , m_cols(0)
+    , m_samplesPerPixel(1)
+    , m_bitsAllocated(8)
+    , m_bitsStored(8)
+    , m_isSigned(false)
+    , m_isYBR(false)
+    , m_isLossyJpeg(false)
+{
+}
+
+EncapsulatedFrameDecoder::~EncapsulatedFrameDecoder()
+{
+}
+
+bool EncapsulatedFrameDecoder::isSupportedTransferSyntax(const QString& transferSyntaxUID)
+{
+    // JPEG processes handled by the DCMTK IJG 8/12/16-bit codecs
+    return transferSyntaxUID == "1.2.840.10008.1.2.4.50" ||   // Baseline
+           transferSyntaxUID == "1.2.840.10008.1.2.4.51" ||   // Extended
+           transferSyntaxUID == "1.2.840.10008.1.2.4.57" ||   // Lossless
+           transferSyntaxUID == "1.2.840.10008.1.2.4.70";     // Lossless SV1
+}
+
+bool EncapsulatedFrameDecoder::open(const std::shared_ptr<DicomDatasetHandle>& dataset, unsigned long frameLimit)
+{
+    m_frameFragments.clear();
+    m_dataset = dataset;
+
+#ifdef HAVE_DCMTK
+    m_pixelSequence = nullptr;
+    if (!m_dataset) {
+        return false;
+    }
+
+    try {
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* ds = m_dataset->dataset();
+        if (!ds) {
+            return false;
+        }
+
+        Uint16 value = 0;
+        if (ds->findAndGetUint16(DCM_Rows, value).bad()) return false;
+        m_rows = value;
+        if (ds->findAndGetUint16(DCM_Columns, value).bad()) return false;
+        m_cols = value;
+        m_samplesPerPixel = ds->findAndGetUint16(DCM_SamplesPerPixel, value).good() ? value : 1;
+        m_bitsAllocated = ds->findAndGetUint16(DCM_BitsAllocated, value).good() ? value : 8;
+        m_bitsStored = ds->findAndGetUint16(DCM_BitsStored, value).good() ? value : m_bitsAllocated;
+        m_isSigned = ds->findAndGetUint16(DCM_PixelRepresentation, value).good() && value == 1;
+
+        OFString photometric;
+        ds->findAndGetOFString(DCM_PhotometricInterpretation, photometric);
+        m_isYBR = photometric.find("YBR") == 0;
+
+        if (m_rows == 0 || m_cols == 0 || (m_samplesPerPixel != 1 && m_samplesPerPixel != 3)) {
+            return false;
+        }
+
+        Sint32 numberOfFrames = 1;
+        if (ds->findAndGetSint32(DCM_NumberOfFrames, numberOfFrames).bad() || numberOfFrames < 1) {
+            numberOfFrames = 1;
+        }
+
+        DcmElement* element = nullptr;
+        if (ds->findAndGetElement(DCM_PixelData, element).bad() || !element) {
+            return false;
+        }
+        DcmPixelData* pixelData = dynamic_cast<DcmPixelData*>(element);
+        if (!pixelData) {
+            return false;
+        }
+
+        E_TransferSyntax xfer = ds->getOriginalXfer();
+        if (!DcmXfer(xfer).isEncapsulated()) {
+            return false;
+        }
+        m_isLossyJpeg = xfer == EXS_JPEGProcess1 || xfer == EXS_JPEGProcess2_4;
+
+        DcmPixelSequence* sequence = nullptr;
+        if (pixelData->getEncapsulatedRepresentation(xfer, nullptr, sequence).bad() || !sequence) {
+            return false;
+        }
+        m_pixelSequence = sequence;
+
+        const unsigned long itemCount = m_pixelSequence->card();
+        if (itemCount < 2) {
+            return false;
+        }
+
+        // Byte offset of every fragment item, measured like the offset tables:
+        // from the first byte of the first item following the Basic Offset Table
+        QVector<quint64> fragmentStarts;
+        fragmentStarts.reserve(static_cast<int>(itemCount - 1));
+        quint64 position = 0;
+        for (unsigned long i = 1; i < itemCount; ++i) {
+            DcmPixelItem* item = nullptr;
+            if (m_pixelSequence->getItem(item, i).bad() || !item) {
+                return false;
+            }
+            fragmentStarts.append(position);
+            position += 8 + item->getLength();
+        }
+
+        // Single frame: every fragment belongs to frame 0
+        if (numberOfFrames == 1) {
+            QVector<unsigned long> fragments;
+            for (unsigned long i = 1; i < itemCount; ++i) {
+                fragments.append(i);
+            }
+            m_frameFragments.append(fragments);
+            return true;
+        }
+
+        // 1. Basic Offset Table (item 0)
+        DcmPixelItem* offsetItem = nullptr;
+        if (m_pixelSequence->getItem(offsetItem, 0).good() && offsetItem &&
+            offsetItem->getLength() == static_cast<Uint32>(numberOfFrames) * 4) {
+            QByteArray table(static_cast<int>(offsetItem->getLength()), Qt::Uninitialized);
+            if (offsetItem->getPartialValue(table.data(), 0, offsetItem->getLength()).good()) {
+                QVector<quint64> offsets;
+                offsets.reserve(numberOfFrames);
+                for (Sint32 f = 0; f < numberOfFrames; ++f) {
+                    offsets.append(qFromLittleEndian<quint32>(table.constData() + f * 4));
+                }
+                if (indexFromOffsets(offsets, fragmentStarts)) {
+                    return true;
+                }
+            }
+        }
+
+        // 2. Extended Offset Table (7FE0,0001)
+        QVector<quint64> extendedOffsets;
+        if (readExtendedOffsetTable(extendedOffsets) &&
+            extendedOffsets.size() == numberOfFrames &&
+            indexFromOffsets(extendedOffsets, fragmentStarts)) {
+            return true;
+        }
+
+        // 3. No usable table - walk the fragments
+        m_frameFragments.clear();
+        if (static_cast<Sint32>(itemCount - 1) == numberOfFrames) {
+            for (unsigned long i = 1; i < itemCount; ++i) {
+                m_frameFragments.append(QVector<unsigned long>{i});
+            }
+            return true;
+        }
+
+        if (indexFromFragmentScan(frameLimit)) {
+            if (m_frameFragments.size() == numberOfFrames ||
+                (frameLimit > 0 && static_cast<unsigned long>(m_frameFragments.size()) == frameLimit)) {
+                return true;
+            }
+        }
+
+        m_frameFragments.clear();
+        return false;
+
+    } catch (const std::exception& e) {
+        m_frameFragments.clear();
+        return false;
+    } catch (...) {
+        m_frameFragments.clear();
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+#ifdef HAVE_DCMTK
+bool EncapsulatedFrameDecoder::indexFromOffsets(const QVector<quint64>& offsets,
+                                                const QVector<quint64>& fragmentStarts)
+{
+    m_frameFragments.clear();
+    if (offsets.isEmpty() || fragmentStarts.isEmpty()) {
+        return false;
+    }
+
+    m_frameFragments.resize(offsets.size());
+    int frame = 0;
+    for (int i = 0; i < fragmentStarts.size(); ++i) {
+        while (frame + 1 < offsets.size() && fragmentStarts[i] >= offsets[frame + 1]) {
+            ++frame;
+        }
+        if (fragmentStarts[i] < offsets[frame]) {
+            m_frameFragments.clear();
+            return false;
+        }
+        m_frameFragments[frame].append(static_cast<unsigned long>(i + 1));
+    }
+
+    // Every offset must point exactly at the start of its first fragment
+    for (int f = 0; f < offsets.size(); ++f) {
+        if (m_frameFragments[f].isEmpty() ||
+            fragmentStarts[static_cast<int>(m_frameFragments[f].first()) - 1] != offsets[f]) {
+            m_frameFragments.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool EncapsulatedFrameDecoder::indexFromFragmentScan(unsigned long frameLimit)
+{
+    // A fragment starting with a JPEG SOI marker (FF D8) starts a new frame
+    m_frameFragments.clear();
+    const unsigned long itemCount = m_pixelSequence->card();
+    for (unsigned long i = 1; i < itemCount; ++i) {
+        DcmPixelItem* item = nullptr;
+        if (m_pixelSequence->getItem(item, i).bad() || !item) {
+            return false;
+        }
+
+        unsigned char marker[2] = {0, 0};
+        bool startsFrame = item->getLength() >= 2 &&
+                           item->getPartialValue(marker, 0, 2).good() &&
+                           marker[0] == 0xFF && marker[1] == 0xD8;
+
+        if (startsFrame || m_frameFragments.isEmpty()) {
+            if (frameLimit > 0 && static_cast<unsigned long>(m_frameFragments.size()) == frameLimit) {
+                break;  // The requested frames are complete
+            }
+            m_frameFragments.append(QVector<unsigned long>());
+        }
+        m_frameFragments.last().append(i);
+    }
+    return !m_frameFragments.isEmpty();
+}
+
+bool EncapsulatedFrameDecoder::readExtendedOffsetTable(QVector<quint64>& offsets) const
+{
+    DcmElement* element = nullptr;
+    DcmDataset* ds = m_dataset->dataset();
+    if (!ds || ds->findAndGetElement(DcmTagKey(0x7FE0, 0x0001), element).bad() || !element) {
+        return false;
+    }
+
+    // Read raw bytes so this works whether the dictionary knows the tag as OV or UN
+    const Uint32 length = element->getLength();
+    if (length == 0 || length % 8 != 0) {
+        return false;
+    }
+    QByteArray table(static_cast<int>(length), Qt::Uninitialized);
+    if (element->getPartialValue(table.data(), 0, length, nullptr, EBO_LittleEndian).bad()) {
+        return false;
+    }
+
+    offsets.clear();
+    offsets.reserve(static_cast<int>(length / 8));
+    for (Uint32 i = 0; i < length; i += 8) {
+        offsets.append(qFromLittleEndian<quint64>(table.constData() + i));
+    }
+    return true;
+}
+
+int EncapsulatedFrameDecoder::scanJpegPrecision(const QByteArray& bitstream)
+{
+    // Walk marker segments up to the first SOFn and return its sample precision
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(bitstream.constData());
+    const int size = bitstream.size();
+    int i = 2; // Skip SOI
+
+    while (i + 4 < size) {
+        if (data[i] != 0xFF) {
+            return 0;
+        }
+        unsigned char marker = data[i + 1];
+        if (marker == 0xFF) {           // Fill byte
+            ++i;
+            continue;
+        }
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            return data[i + 4];
+        }
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD8)) {
+            i += 2;
+            continue;
+        }
+        int length = (data[i + 2] << 8) | data[i + 3];
+        i += 2 + length;
+    }
+    return 0;
+}
+#endif
+
+QByteArray EncapsulatedFrameDecoder::frameBitstream(unsigned long frameNumber) const
+{
+    QByteArray bitstream;
+    if (!readFrameBitstream(frameNumber, bitstream)) {
+        return QByteArray();
+    }
+    return bitstream;
+}
+
+bool EncapsulatedFrameDecoder::readFrameBitstream(unsigned long frameNumber, QByteArray& bitstream) const
+{
+#ifdef HAVE_DCMTK
+    if (!m_dataset || !m_pixelSequence || frameNumber >= frameCount()) {
+        return false;
+    }
+
+    try {
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        const QVector<unsigned long>& fragments = m_frameFragments[static_cast<int>(frameNumber)];
+
+        // Size the buffer once for all fragments
+        QVector<DcmPixelItem*> items;
+        items.reserve(fragments.size());
+        qsizetype totalLength = 0;
+        for (unsigned long itemNumber : fragments) {
+            DcmPixelItem* item = nullptr;
+            if (m_pixelSequence->getItem(item, itemNumber).bad() || !item) {
+                return false;
+            }
+            items.append(item);
+            totalLength += item->getLength();
+        }
+        bitstream.resize(totalLength);
+
+        qsizetype offset = 0;
+        for (DcmPixelItem* item : items) {
+            const Uint32 length = item->getLength();
+            // getPartialValue reads straight from file when the value is not
+            // loaded, so frames do not accumulate in the dataset
+            if (length > 0 && item->getPartialValue(bitstream.data() + offset, 0, length).bad()) {
+                return false;
+            }
+            offset += length;
+        }
+        return true;
+
+    } catch (...) {
+        return false;
+    }
+#else
+    Q_UNUSED(frameNumber)
+    Q_UNUSED(bitstream)
+    return false;
+#endif
+}
+
+bool EncapsulatedFrameDecoder::decodeFrame(unsigned long frameNumber, QByteArray& samples) const
+{
+#ifdef HAVE_DCMTK
+    // Compressed frames are read into a per-thread buffer that keeps its allocation
+    thread_local QByteArray bitstream;
+    if (!readFrameBitstream(frameNumber, bitstream) || bitstream.size() < 4) {
+        return false;
+    }
+
+    try {
+        int precision = scanJpegPrecision(bitstream);
+        if (precision == 0) {
+            precision = static_cast<int>(m_bitsStored);
+        }
+
+#ifdef HAVE_TURBOJPEG
+        // Colour only when the photometric is YBR: TurboJPEG assumes YCbCr for
+        // three components, while DCMTK honours an RGB photometric
+        if (m_isLossyJpeg && precision <= 8 && bytesPerSample() == 1 && !m_isSigned &&
+            (m_samplesPerPixel == 1 || m_isYBR) &&
+            TurboJpegDecoder::decode(bitstream, static_cast<int>(m_cols), static_cast<int>(m_rows),
+                                     static_cast<int>(m_samplesPerPixel), samples)) {
+            return true;
+        }
+#endif
+
+        DJCodecParameter parameters(ECC_lossyYCbCr, EDC_photometricInterpretation, EUC_default, EPC_default);
+        std::unique_ptr<DJDecoder> codec;
+        if (precision > 12) {
+            codec.reset(new DJDecompressIJG16Bit(parameters, m_isYBR));
+        } else if (precision > 8) {
+            codec.reset(new DJDecompressIJG12Bit(parameters, m_isYBR));
+        } else {
+            codec.reset(new DJDecompressIJG8Bit(parameters, m_isYBR));
+        }
+
+        const size_t pixelCount = static_cast<size_t>(m_rows) * m_cols * m_samplesPerPixel;
+        const size_t codecBytes = static_cast<size_t>(codec->bytesPerSample());
+        QByteArray decoded(static_cast<int>(pixelCount * codecBytes), Qt::Uninitialized);
+
+        if (codec->init().bad()) {
+            return false;
+        }
+        if (codec->decode(reinterpret_cast<Uint8*>(bitstream.data()), static_cast<Uint32>(bitstream.size()),
+                          reinterpret_cast<Uint8*>(decoded.data()), static_cast<Uint32>(decoded.size()),
+                          m_isSigned ? OFTrue : OFFalse).bad()) {
+            return false;
+        }
+
+        if (codecBytes == bytesPerSample()) {
+            samples = decoded;
+        } else if (codecBytes == 1) {
+            // 8-bit precision stored in 16-bit words
+            samples.resize(static_cast<int>(pixelCount * 2));
+            const Uint8* src = reinterpret_cast<const Uint8*>(decoded.constData());
+            Uint16* dst = reinterpret_cast<Uint16*>(samples.data());
+            for (size_t i = 0; i < pixelCount; ++i) {
+                dst[i] = src[i];
+            }
+        } else {
+            // 16-bit words for an 8-bit allocation
+            samples.resize(static_cast<int>(pixelCount));
+            const Uint16* src = reinterpret_cast<const Uint16*>(decoded.constData());
+            Uint8* dst = reinterpret_cast<Uint8*>(samples.data());
+            for (size_t i = 0; i < pixelCount; ++i) {
+                dst[i] = static_cast<Uint8>(src[i]);
+            }
+        }
+        return true;
+
+    } catch (const std::exception& e) {
+        return false;
+    } catch (...) {
+        return false;
+    }
+#else
+    Q_UNUSED(frameNumber)
+    Q_UNUSED(samples)
+    return false;
+#endif
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "DicomDatasetHandle.h"
+
+#ifdef HAVE_DCMTK
+#include "dcmtk/config/osconfig.h"
+#include "dcmtk/dcmdata/dcpixseq.h"
+#endif
+
+/**
+ * @brief Random-access decoder for encapsulated (JPEG) multi-frame pixel data
+ *
+ * Builds a frame index over the encapsulated fragments. The index is taken
+ * from the Basic Offset Table, then the Extended Offset Table (7FE0,0001),
+ * and finally from a scan for JPEG SOI markers at fragment starts. With the
+ * index, any frame's bitstream can be read and decoded on its own, so frame N
+ * costs one frame's decode rather than decoding frames 0..N-1 first.
+ *
+ * 8-bit baseline/extended frames are decoded with TurboJPEG when it is
+ * available (one decompressor handle per thread, output written straight into
+ * the sample buffer); everything else uses a fresh DCMTK IJG codec per call.
+ * Decoding runs outside the dataset lock. Only the fragment read takes the
+ * lock, so decodeFrame() may be called from several threads at once.
+ */
+class EncapsulatedFrameDecoder
+{
+public:
+    EncapsulatedFrameDecoder();
+    ~EncapsulatedFrameDecoder();
+
+    /**
+     * @brief Check whether a transfer syntax can be decoded per frame
+     * @param transferSyntaxUID Transfer Syntax UID from the file meta header
+     */
+    static bool isSupportedTransferSyntax(const QString& transferSyntaxUID);
+
+    /**
+     * @brief Build the frame index for a dataset
+     * @param dataset Shared dataset handle
+     * @param frameLimit Index only the first frameLimit frames (0 = all). Without
+     *        an offset table this stops the fragment scan early, so opening a
+     *        long run for its first frame does not touch every fragment.
+     * @return true if every requested frame could be mapped to its fragments
+     */
+    bool open(const std::shared_ptr<DicomDatasetHandle>& dataset, unsigned long frameLimit = 0);
+
+    bool isOpen() const { return !m_frameFragments.isEmpty(); }
+    unsigned long frameCount() const { return static_cast<unsigned long>(m_frameFragments.size()); }
+
+    /**
+     * @brief Read the compressed bitstream of one frame (fragments concatenated)
+     * @return Compressed bytes, or an empty array on error
+     */
+    QByteArray frameBitstream(unsigned long frameNumber) const;
+
+    /**
+     * @brief Read the compressed bitstream of one frame into a reusable buffer
+     * @param bitstream Resized to the frame's size; keeps its allocation when possible
+     * @return true if successful, false otherwise
+     */
+    bool readFrameBitstream(unsigned long frameNumber, QByteArray& bitstream) const;
+
+    /**
+     * @brief Decode one frame to native samples
+     * @param frameNumber Frame number (0-based)
+     * @param samples Receives rows*columns*samplesPerPixel samples, 1 byte each
+     *        for BitsAllocated 8 and 2 bytes (host order) otherwise
+     * @return true if successful, false otherwise
+     */
+    bool decodeFrame(unsigned long frameNumber, QByteArray& samples) const;
+
+    unsigned int bytesPerSample() const { return m_bitsAllocated > 8 ? 2 : 1; }
+
+private:
+#ifdef HAVE_DCMTK
+    bool indexFromOffsets(const QVector<quint64>& offsets, const QVector<quint64>& fragmentStarts);
+    bool indexFromFragmentScan(unsigned long frameLimit);
+    bool readExtendedOffsetTable(QVector<quint64>& offsets) const;
+    static int scanJpegPrecision(const QByteArray& bitstream);
+
+    DcmPixelSequence* m_pixelSequence;  // Owned by the dataset
+#endif
+
+    std::shared_ptr<DicomDatasetHandle> m_dataset;
+
+    // Fragment item numbers (1-based, item 0 is the Basic Offset Table) per frame
+    QVector<QVector<unsigned long>> m_frameFragments;
+
+    unsigned int m_rows;
+    unsigned int m_cols;
+    unsigned int m_samplesPerPixel;
+    unsigned int m_bitsAllocated;
+    unsigned int m_bitsStored;
+    bool m_isSigned;
+    bool m_isYBR;
+    bool m_isLossyJpeg;     // Baseline or extended process (.50/.51)
+};
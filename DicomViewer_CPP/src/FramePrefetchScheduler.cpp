@@ -0,0 +1,163 @@
+#include "FramePrefetchScheduler.h"
+#include <QtGlobal>
+#include <cmath>
+
+namespace {
+
+// Moves of up to this many frames count as steps (playback, wheel, arrow
+// keys); anything larger is a jump
+constexpr int MaxStepFrames = 2;
+// No step for this long means the playhead is at rest
+constexpr qint64 RestAfterMs = 500;
+// At this rate (or faster) the window lies mostly ahead
+constexpr double FullSpeedFps = 30.0;
+// Share of the window ahead of the playhead at rest and at full speed
+constexpr double RestAheadShare = 0.5;
+constexpr double FullSpeedAheadShare = 0.9;
+
+} // namespace
+
+FramePrefetchScheduler::FramePrefetchScheduler()
+    : m_frameCount(0)
+    , m_windowFrames(0)
+    , m_playhead(0)
+    , m_direction(1)
+    , m_framesPerSecond(0.0)
+    , m_lastStepMs(0)
+    , m_inFlightCount(0)
+{
+    m_clock.start();
+}
+
+void FramePrefetchScheduler::reset(int frameCount)
+{
+    m_frameCount = qMax(0, frameCount);
+    m_windowFrames = m_frameCount;
+    m_playhead = m_frameCount > 0 ? qBound(0, m_playhead, m_frameCount - 1) : 0;
+    m_inFlight.assign(m_frameCount, false);
+    m_failed.assign(m_frameCount, false);
+    m_inFlightCount = 0;
+}
+
+void FramePrefetchScheduler::setWindowFrames(int windowFrames)
+{
+    m_windowFrames = m_frameCount > 0 ? qBound(1, windowFrames, m_frameCount) : 0;
+}
+
+bool FramePrefetchScheduler::setPlayhead(int frameIndex)
+{
+    if (m_frameCount <= 0) {
+        // Not started yet - reset() clamps it
+        m_playhead = qMax(0, frameIndex);
+        return false;
+    }
+
+    frameIndex = qBound(0, frameIndex, m_frameCount - 1);
+    int step = frameIndex - m_playhead;
+    if (step == 0) {
+        return false;
+    }
+    // Shortest way round, so looping from the last frame to the first is a step
+    if (step > m_frameCount / 2) {
+        step -= m_frameCount;
+    } else if (step < -m_frameCount / 2) {
+        step += m_frameCount;
+    }
+
+    const qint64 nowMs = m_clock.elapsed();
+    bool jump = false;
+    if (qAbs(step) <= MaxStepFrames) {
+        m_direction = step > 0 ? 1 : -1;
+        const qint64 elapsedMs = nowMs - m_lastStepMs;
+        if (elapsedMs > 0 && elapsedMs < RestAfterMs) {
+            const double rate = qAbs(step) * 1000.0 / elapsedMs;
+            m_framesPerSecond = m_framesPerSecond > 0.0 ? 0.75 * m_framesPerSecond + 0.25 * rate : rate;
+        } else {
+            // First step after a pause
+            m_framesPerSecond = 0.0;
+        }
+    } else {
+        // Direction is kept; speed starts over from the new position
+        jump = true;
+        m_framesPerSecond = 0.0;
+    }
+
+    m_lastStepMs = nowMs;
+    m_playhead = frameIndex;
+    return jump;
+}
+
+int FramePrefetchScheduler::aheadFrames() const
+{
+    const double fps = (m_clock.elapsed() - m_lastStepMs) < RestAfterMs ? m_framesPerSecond : 0.0;
+    const double share = RestAheadShare + (FullSpeedAheadShare - RestAheadShare) * qMin(1.0, fps / FullSpeedFps);
+    return static_cast<int>(std::lround((m_windowFrames - 1) * share));
+}
+
+void FramePrefetchScheduler::forEachInWindow(const std::function<bool(int)>& visit) const
+{
+    if (m_frameCount <= 0 || m_windowFrames <= 0) {
+        return;
+    }
+    if (!visit(m_playhead)) {
+        return;
+    }
+
+    const int ahead = aheadFrames();
+    const int behind = m_windowFrames - 1 - ahead;
+    int aheadTaken = 0;
+    int behindTaken = 0;
+    while (aheadTaken < ahead || behindTaken < behind) {
+        // Take from whichever side is proportionally less covered
+        const bool takeAhead = behindTaken >= behind ||
+            (aheadTaken < ahead && (aheadTaken + 1) * (behind + 1) <= (behindTaken + 1) * (ahead + 1));
+        const int offset = takeAhead ? ++aheadTaken : -(++behindTaken);
+        const int frame = ((m_playhead + m_direction * offset) % m_frameCount + m_frameCount) % m_frameCount;
+        if (!visit(frame)) {
+            return;
+        }
+    }
+}
+
+int FramePrefetchScheduler::takeNext(const std::function<bool(int)>& isStored)
+{
+    int next = -1;
+    forEachInWindow([&](int frame) {
+        if (m_inFlight[frame] || m_failed[frame] || isStored(frame)) {
+            return true;
+        }
+        next = frame;
+        return false;
+    });
+
+    if (next >= 0) {
+        m_inFlight[next] = true;
+        ++m_inFlightCount;
+    }
+    return next;
+}
+
+void FramePrefetchScheduler::finish(int frameIndex, bool ok)
+{
+    if (frameIndex < 0 || frameIndex >= m_frameCount || !m_inFlight[frameIndex]) {
+        return;
+    }
+    m_inFlight[frameIndex] = false;
+    --m_inFlightCount;
+    if (!ok) {
+        m_failed[frameIndex] = true;
+    }
+}
+
+bool FramePrefetchScheduler::isWanted(int frameIndex) const
+{
+    if (frameIndex < 0 || frameIndex >= m_frameCount || m_windowFrames <= 0) {
+        return false;
+    }
+
+    // Distance ahead in the playback direction, wrapping
+    const int distance = (((frameIndex - m_playhead) * m_direction) % m_frameCount + m_frameCount) % m_frameCount;
+    const int ahead = aheadFrames();
+    const int behind = m_windowFrames - 1 - ahead;
+    return distance <= ahead || (distance > 0 && m_frameCount - distance <= behind);
+}
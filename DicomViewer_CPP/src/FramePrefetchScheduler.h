@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Chooses which frame to decode next around a moving playhead
+ *
+ * The scheduler keeps a decode window of windowFrames frames around the
+ * playhead: the playhead itself, frames ahead of it in the playback
+ * direction and frames behind it, wrapping at the ends like a looping cine
+ * run. The window is sized by the caller to fit the frame store budget.
+ *
+ * How the window splits between ahead and behind follows the playhead:
+ * - direction is the sign of the last single-frame step
+ * - speed is a smoothed frames-per-second rate of those steps
+ * - at rest, or right after a jump, the split is even, so scrubbing either
+ *   way finds decoded frames; the faster the playback, the more of the
+ *   window lies ahead
+ *
+ * Work is never queued. takeNext() walks the current window in priority
+ * order each time, so after a jump frames of the old window are simply no
+ * longer handed out, and isWanted() tells workers whether a decode that was
+ * already running is still worth keeping.
+ *
+ * Not thread-safe; ProgressiveFrameLoader calls it with its mutex held.
+ */
+class FramePrefetchScheduler
+{
+public:
+    FramePrefetchScheduler();
+
+    /**
+     * @brief Start over for a run; the playhead is kept (clamped)
+     */
+    void reset(int frameCount);
+
+    /**
+     * @brief Limit the window, e.g. once the cost of a frame is known
+     */
+    void setWindowFrames(int windowFrames);
+    int windowFrames() const { return m_windowFrames; }
+
+    /**
+     * @brief Report the frame being shown or requested
+     * @return true if this was a jump rather than a step
+     */
+    bool setPlayhead(int frameIndex);
+
+    int playhead() const { return m_playhead; }
+    int direction() const { return m_direction; }
+    double framesPerSecond() const { return m_framesPerSecond; }
+
+    /**
+     * @brief Claim the most urgent frame of the window that still needs decoding
+     * @param isStored Tells whether a frame is already decoded
+     * @return Frame index, or -1 if every frame of the window is stored or in flight
+     */
+    int takeNext(const std::function<bool(int)>& isStored);
+
+    /**
+     * @brief Release a claimed frame after its decode
+     * @param ok false marks the frame as undecodable so it is not retried
+     */
+    void finish(int frameIndex, bool ok);
+
+    /**
+     * @brief True if the frame lies in the current window
+     */
+    bool isWanted(int frameIndex) const;
+
+    int inFlightCount() const { return m_inFlightCount; }
+
+private:
+    /**
+     * @brief Frames of the window lying ahead of the playhead, from the current speed
+     */
+    int aheadFrames() const;
+
+    // Frames in priority order: playhead, then ahead and behind interleaved
+    // in proportion to their shares of the window. Stops when visit returns false.
+    void forEachInWindow(const std::function<bool(int)>& visit) const;
+
+    int m_frameCount;
+    int m_windowFrames;
+
+    int m_playhead;
+    int m_direction;                // +1 forward, -1 backward
+    double m_framesPerSecond;       // Smoothed step rate; 0 at rest
+    QElapsedTimer m_clock;
+    qint64 m_lastStepMs;
+
+    std::vector<bool> m_inFlight;
+    std::vector<bool> m_failed;
+    int m_inFlightCount;
+};
@@ -0,0 +1,100 @@
+#include "MappedPixelData.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// Pixel Data is normally the last top-level element; at most this much
+// (padding, digital signatures) is expected to follow it
+constexpr qint64 MaxTrailingBytes = 1024 * 1024;
+
+} // namespace
+
+MappedPixelData::~MappedPixelData()
+{
+    if (m_fileData) {
+        m_file.unmap(m_fileData);
+    }
+}
+
+std::shared_ptr<const MappedPixelData> MappedPixelData::map(const QString& filePath, bool explicitVR,
+                                                            quint64 valueLength, const QByteArray& leadingBytes)
+{
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+    if (valueLength == 0) {
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedPixelData> mapping(new MappedPixelData());
+    mapping->m_file.setFileName(filePath);
+    if (!mapping->m_file.open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+
+    const qint64 fileSize = mapping->m_file.size();
+    mapping->m_fileData = mapping->m_file.map(0, fileSize);
+    if (!mapping->m_fileData) {
+        return nullptr;
+    }
+
+    const qint64 valueOffset = locateValue(mapping->m_fileData, fileSize, explicitVR, valueLength);
+    if (valueOffset < 0) {
+        return nullptr;
+    }
+
+    // A length match alone could be a coincidence; the value must also start like DCMTK's
+    const quint64 probeLength = qMin<quint64>(static_cast<quint64>(leadingBytes.size()), valueLength);
+    if (probeLength == 0 || memcmp(mapping->m_fileData + valueOffset, leadingBytes.constData(), probeLength) != 0) {
+        return nullptr;
+    }
+
+    mapping->m_data = mapping->m_fileData + valueOffset;
+    mapping->m_length = valueLength;
+    return mapping;
+#else
+    Q_UNUSED(filePath)
+    Q_UNUSED(explicitVR)
+    Q_UNUSED(valueLength)
+    Q_UNUSED(leadingBytes)
+    return nullptr;
+#endif
+}
+
+qint64 MappedPixelData::locateValue(const uchar* file, qint64 fileSize, bool explicitVR, quint64 valueLength)
+{
+    // Tag (7FE0,0010), then either VR "OB"/"OW", two reserved bytes and a 32-bit
+    // length (explicit VR) or just the 32-bit length (implicit VR)
+    const qint64 headerSize = explicitVR ? 12 : 8;
+    const qint64 lastStart = fileSize - headerSize - static_cast<qint64>(valueLength);
+    if (lastStart < 0) {
+        return -1;
+    }
+
+    // Walk back from where the header sits when nothing follows the value; this
+    // only touches the file's tail, never the pixel pages themselves
+    const qint64 firstStart = qMax<qint64>(0, lastStart - MaxTrailingBytes);
+    for (qint64 pos = lastStart; pos >= firstStart; --pos) {
+        const uchar* header = file + pos;
+        if (header[0] != 0xE0 || header[1] != 0x7F || header[2] != 0x10 || header[3] != 0x00) {
+            continue;
+        }
+        if (explicitVR) {
+            if (header[4] != 'O' || (header[5] != 'B' && header[5] != 'W') || header[6] != 0 || header[7] != 0 ||
+                qFromLittleEndian<quint32>(header + 8) != valueLength) {
+                continue;
+            }
+        } else if (qFromLittleEndian<quint32>(header + 4) != valueLength) {
+            continue;
+        }
+        return pos + headerSize;
+    }
+    return -1;
+}
+
+QByteArray MappedPixelData::view(quint64 offset, quint64 length) const
+{
+    if (!m_data || offset > m_length || length > m_length - offset) {
+        return QByteArray();
+    }
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_data + offset), static_cast<qsizetype>(length));
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <memory>
+
+/**
+ * @brief Read-only memory mapping of a native little endian Pixel Data value
+ *
+ * Uncompressed frames lie back to back in the file, so frame N is a fixed
+ * offset into the value. view() returns a QByteArray that points straight
+ * into the mapping: nothing is copied, nothing is read until a page is
+ * touched, and the OS can drop clean pages again under memory pressure.
+ *
+ * Views are only valid while the mapping lives. Frames that hold a view keep
+ * a reference to it (DicomPixelFrame::mapping).
+ *
+ * Only available on little endian hosts, where the file's sample order is
+ * already the host order.
+ */
+class MappedPixelData
+{
+public:
+    ~MappedPixelData();
+
+    /**
+     * @brief Map a file and locate its top-level Pixel Data value
+     * @param filePath File to map
+     * @param explicitVR false for Implicit VR Little Endian
+     * @param valueLength Pixel Data value length as parsed by DCMTK
+     * @param leadingBytes First bytes of the value as read by DCMTK; the
+     *        located value must start with them
+     * @return Mapping, or nullptr if the value could not be located or mapped
+     */
+    static std::shared_ptr<const MappedPixelData> map(const QString& filePath, bool explicitVR,
+                                                      quint64 valueLength, const QByteArray& leadingBytes);
+
+    quint64 length() const { return m_length; }
+
+    /**
+     * @brief Zero-copy view of part of the value
+     * @return View, or an empty array if the range is outside the value
+     */
+    QByteArray view(quint64 offset, quint64 length) const;
+
+private:
+    MappedPixelData() = default;
+
+    /**
+     * @brief Offset of the value within the file, or -1 if not found
+     */
+    static qint64 locateValue(const uchar* file, qint64 fileSize, bool explicitVR, quint64 valueLength);
+
+    QFile m_file;
+    uchar* m_fileData = nullptr;        // Whole file, unmapped with m_file
+    const uchar* m_data = nullptr;      // Start of the Pixel Data value
+    quint64 m_length = 0;
+};
@@ -0,0 +1,226 @@
+#include "PerfTrace.h"
+#include "AsyncLogger.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringList>
+#include <QThread>
+#include <chrono>
+#include <vector>
+
+std::atomic<bool> PerfTrace::s_enabled{false};
+
+namespace {
+
+// Bucket i holds durations below 2^i microseconds; the last one is open-ended
+constexpr int BucketCount = 32;
+// Trace events kept in memory before new ones are dropped (~40 bytes each)
+constexpr size_t MaxTraceEvents = 1000000;
+
+// Only instantiated with static storage, so the buckets start zeroed
+struct StageHistogram
+{
+    std::atomic<quint64> buckets[BucketCount];
+    std::atomic<quint64> count{0};
+    std::atomic<quint64> totalUs{0};
+    std::atomic<qint64> maxUs{0};
+};
+
+struct TraceEvent
+{
+    const char* name;
+    PerfStage stage;
+    qint64 startUs;
+    qint64 durationUs;
+    quintptr threadId;
+};
+
+StageHistogram s_histograms[static_cast<int>(PerfStage::StageCount)];
+
+QMutex s_traceMutex;
+QString s_traceFilePath;
+std::vector<TraceEvent> s_traceEvents;
+std::atomic<bool> s_collectTrace{false};
+std::atomic<quint64> s_droppedEvents{0};
+
+int bucketFor(qint64 durationUs)
+{
+    int bucket = 0;
+    quint64 value = static_cast<quint64>(qMax<qint64>(durationUs, 0));
+    while (value > 0 && bucket < BucketCount - 1) {
+        value >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+// Upper bound of the bucket holding the given fraction of samples
+qint64 percentileUs(const StageHistogram& histogram, quint64 count, double fraction)
+{
+    const quint64 target = qMax<quint64>(1, static_cast<quint64>(count * fraction + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += histogram.buckets[i].load(std::memory_order_relaxed);
+        if (seen >= target) {
+            return i == 0 ? 0 : (qint64(1) << i) - 1;
+        }
+    }
+    return histogram.maxUs.load(std::memory_order_relaxed);
+}
+
+QString jsonEscaped(const char* text)
+{
+    QString escaped = QString::fromLatin1(text);
+    escaped.replace('\\', "\\\\");
+    escaped.replace('"', "\\\"");
+    return escaped;
+}
+
+} // namespace
+
+void PerfTrace::enable(const QString& traceFilePath)
+{
+    nowUs();    // Pin the clock origin
+    {
+        QMutexLocker locker(&s_traceMutex);
+        s_traceFilePath = traceFilePath;
+        if (!traceFilePath.isEmpty()) {
+            s_traceEvents.reserve(64 * 1024);
+        }
+    }
+    s_collectTrace.store(!traceFilePath.isEmpty(), std::memory_order_release);
+    s_enabled.store(true, std::memory_order_release);
+}
+
+qint64 PerfTrace::nowUs()
+{
+    static const auto origin = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+void PerfTrace::record(const char* name, PerfStage stage, qint64 startUs, qint64 durationUs)
+{
+    if (stage != PerfStage::None) {
+        StageHistogram& histogram = s_histograms[static_cast<int>(stage)];
+        histogram.buckets[bucketFor(durationUs)].fetch_add(1, std::memory_order_relaxed);
+        histogram.count.fetch_add(1, std::memory_order_relaxed);
+        histogram.totalUs.fetch_add(static_cast<quint64>(qMax<qint64>(durationUs, 0)), std::memory_order_relaxed);
+        qint64 currentMax = histogram.maxUs.load(std::memory_order_relaxed);
+        while (durationUs > currentMax &&
+               !histogram.maxUs.compare_exchange_weak(currentMax, durationUs, std::memory_order_relaxed)) {
+        }
+    }
+
+    if (!s_collectTrace.load(std::memory_order_relaxed)) {
+        return;
+    }
+    QMutexLocker locker(&s_traceMutex);
+    if (s_traceEvents.size() >= MaxTraceEvents) {
+        s_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    s_traceEvents.push_back({name, stage, startUs, durationUs,
+                             reinterpret_cast<quintptr>(QThread::currentThreadId())});
+}
+
+const char* PerfTrace::stageName(PerfStage stage)
+{
+    switch (stage) {
+        case PerfStage::Parse:       return "parse";
+        case PerfStage::Decode:      return "decode";
+        case PerfStage::WindowLevel: return "windowlevel";
+        case PerfStage::Convert:     return "convert";
+        case PerfStage::Display:     return "display";
+        default:                     return "span";
+    }
+}
+
+QString PerfTrace::histogramSummary()
+{
+    QStringList lines;
+    for (int i = 0; i < static_cast<int>(PerfStage::StageCount); ++i) {
+        const StageHistogram& histogram = s_histograms[i];
+        const quint64 count = histogram.count.load(std::memory_order_relaxed);
+        if (count == 0) {
+            continue;
+        }
+        const double meanUs = static_cast<double>(histogram.totalUs.load(std::memory_order_relaxed)) / count;
+        lines << QString("%1: n=%2 mean=%3us p50<=%4us p90<=%5us p99<=%6us max=%7us")
+                     .arg(QString::fromLatin1(stageName(static_cast<PerfStage>(i))), -11)
+                     .arg(count)
+                     .arg(meanUs, 0, 'f', 1)
+                     .arg(percentileUs(histogram, count, 0.50))
+                     .arg(percentileUs(histogram, count, 0.90))
+                     .arg(percentileUs(histogram, count, 0.99))
+                     .arg(histogram.maxUs.load(std::memory_order_relaxed));
+    }
+    return lines.join('\n');
+}
+
+bool PerfTrace::writeChromeTrace(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QByteArray json;
+    json.reserve(1024 * 1024);
+    json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    QMutexLocker locker(&s_traceMutex);
+    bool first = true;
+    for (const TraceEvent& event : s_traceEvents) {
+        if (!first) {
+            json += ",\n";
+        }
+        first = false;
+        json += QString("{\"name\":\"%1\",\"cat\":\"%2\",\"ph\":\"X\",\"ts\":%3,\"dur\":%4,\"pid\":%5,\"tid\":%6}")
+                    .arg(jsonEscaped(event.name), QString::fromLatin1(stageName(event.stage)))
+                    .arg(event.startUs)
+                    .arg(event.durationUs)
+                    .arg(pid)
+                    .arg(event.threadId)
+                    .toUtf8();
+        // Keep memory bounded on long sessions
+        if (json.size() > 4 * 1024 * 1024) {
+            file.write(json);
+            json.clear();
+        }
+    }
+    json += "\n]}\n";
+    file.write(json);
+    return true;
+}
+
+void PerfTrace::shutdown()
+{
+    if (!isEnabled()) {
+        return;
+    }
+    s_enabled.store(false, std::memory_order_release);
+
+    const QString summary = histogramSummary();
+    if (!summary.isEmpty()) {
+        AsyncLogger::instance().log(LOG_INFO, "PERF: stage latency histograms\n" + summary);
+    }
+
+    QString traceFilePath;
+    {
+        QMutexLocker locker(&s_traceMutex);
+        traceFilePath = s_traceFilePath;
+    }
+    if (traceFilePath.isEmpty()) {
+        return;
+    }
+
+    if (writeChromeTrace(traceFilePath)) {
+        AsyncLogger::instance().log(LOG_INFO, QString("PERF: wrote trace to %1 (%2 events dropped)")
+                                                  .arg(traceFilePath)
+                                                  .arg(s_droppedEvents.load(std::memory_order_relaxed)));
+    } else {
+        AsyncLogger::instance().log(LOG_WARN, "PERF: could not write trace to " + traceFilePath);
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief Pipeline stage a span is accounted to
+ *
+ * Each stage has its own latency histogram. Spans that only group other
+ * spans use None so their time is not counted twice.
+ */
+enum class PerfStage
+{
+    None = -1,
+    Parse = 0,      // File / dataset parsing and frame indexing
+    Decode,         // Pixel data read or decompression
+    WindowLevel,    // W/L, invert and flip mapping
+    Convert,        // Sample, QImage and QPixmap conversions
+    Display,        // Scene update on the GUI thread
+    StageCount
+};
+
+/**
+ * @brief Process-wide span recorder and per-stage latency histograms
+ *
+ * Off by default; enable() turns it on at run time (--perf-stats or
+ * --trace=<file> on the command line). While disabled a PerfSpan costs one
+ * relaxed atomic load.
+ *
+ * Histograms use power-of-two microsecond buckets and are updated with
+ * atomics. When a trace file is given, every finished span is also kept and
+ * written by shutdown() as Chrome trace JSON ("X" events), which loads in
+ * chrome://tracing and ui.perfetto.dev.
+ */
+class PerfTrace
+{
+public:
+    /**
+     * @brief Start collecting; an empty path collects histograms only
+     */
+    static void enable(const QString& traceFilePath = QString());
+
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Microseconds on a monotonic clock since the first call
+     */
+    static qint64 nowUs();
+
+    /**
+     * @brief Account one finished span; name must be a string literal
+     */
+    static void record(const char* name, PerfStage stage, qint64 startUs, qint64 durationUs);
+
+    /**
+     * @brief Count, mean, p50/p90/p99 and max per stage, one line each
+     */
+    static QString histogramSummary();
+
+    static bool writeChromeTrace(const QString& filePath);
+
+    /**
+     * @brief Log the histogram summary and write the trace file, if any
+     */
+    static void shutdown();
+
+    static const char* stageName(PerfStage stage);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * @brief Records the lifetime of a scope as a named span
+ */
+class PerfSpan
+{
+public:
+    PerfSpan(const char* name, PerfStage stage)
+        : m_name(name)
+        , m_stage(stage)
+        , m_startUs(PerfTrace::isEnabled() ? PerfTrace::nowUs() : -1)
+    {
+    }
+
+    ~PerfSpan()
+    {
+        if (m_startUs >= 0) {
+            PerfTrace::record(m_name, m_stage, m_startUs, PerfTrace::nowUs() - m_startUs);
+        }
+    }
+
+    PerfSpan(const PerfSpan&) = delete;
+    PerfSpan& operator=(const PerfSpan&) = delete;
+
+private:
+    const char* m_name;
+    PerfStage m_stage;
+    qint64 m_startUs;
+};
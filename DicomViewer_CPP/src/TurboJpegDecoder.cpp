@@ -0,0 +1,64 @@
+#include "TurboJpegDecoder.h"
+
+#ifdef HAVE_TURBOJPEG
+
+namespace {
+
+// Owns the calling thread's handle for the lifetime of the thread
+struct ThreadDecompressor
+{
+    tjhandle handle = nullptr;
+
+    ~ThreadDecompressor()
+    {
+        if (handle) {
+            tjDestroy(handle);
+        }
+    }
+};
+
+thread_local ThreadDecompressor t_decompressor;
+
+} // namespace
+
+tjhandle TurboJpegDecoder::decompressor()
+{
+    if (!t_decompressor.handle) {
+        t_decompressor.handle = tjInitDecompress();
+    }
+    return t_decompressor.handle;
+}
+
+bool TurboJpegDecoder::decode(const QByteArray& bitstream, int width, int height, int samplesPerPixel,
+                              QByteArray& samples)
+{
+    if (bitstream.size() < 4 || width <= 0 || height <= 0 || (samplesPerPixel != 1 && samplesPerPixel != 3)) {
+        return false;
+    }
+
+    tjhandle handle = decompressor();
+    if (!handle) {
+        return false;
+    }
+
+    unsigned char* jpegData = reinterpret_cast<unsigned char*>(const_cast<char*>(bitstream.constData()));
+    const unsigned long jpegSize = static_cast<unsigned long>(bitstream.size());
+    int jpegWidth = 0, jpegHeight = 0, subsampling = 0, colorspace = 0;
+
+    // Fails for 12-bit and lossless bitstreams, which the caller decodes another way
+    if (tjDecompressHeader3(handle, jpegData, jpegSize, &jpegWidth, &jpegHeight, &subsampling, &colorspace) != 0 ||
+        jpegWidth != width || jpegHeight != height) {
+        return false;
+    }
+    // A grayscale frame must be single-component and a colour frame must not be
+    if ((samplesPerPixel == 1) != (colorspace == TJCS_GRAY)) {
+        return false;
+    }
+
+    const int pitch = width * samplesPerPixel;
+    samples.resize(static_cast<qsizetype>(pitch) * height);
+    return tjDecompress2(handle, jpegData, jpegSize, reinterpret_cast<unsigned char*>(samples.data()),
+                         width, pitch, height, samplesPerPixel == 1 ? TJPF_GRAY : TJPF_RGB, 0) == 0;
+}
+
+#endif
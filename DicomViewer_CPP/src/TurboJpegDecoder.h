@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QByteArray>
+
+#ifdef HAVE_TURBOJPEG
+#include <turbojpeg.h>
+
+/**
+ * @brief TurboJPEG decoding of 8-bit baseline/extended JPEG frames
+ *
+ * Every thread gets its own decompressor handle, created on first use and
+ * destroyed when the thread ends, so the frame-loader and thumbnail worker
+ * threads reuse one handle each instead of creating one per frame. Handles
+ * are never shared between threads, so no locking is needed.
+ */
+class TurboJpegDecoder
+{
+public:
+    /**
+     * @brief Decompressor handle of the calling thread, or null if TurboJPEG
+     *        could not create one
+     */
+    static tjhandle decompressor();
+
+    /**
+     * @brief Decode a full-resolution frame straight into its sample buffer
+     * @param bitstream Complete JPEG bitstream of one frame
+     * @param width Expected width; the frame is rejected if it differs
+     * @param height Expected height; the frame is rejected if it differs
+     * @param samplesPerPixel 1 (grayscale) or 3 (YCbCr decoded to RGB)
+     * @param samples Receives width*height*samplesPerPixel 8-bit samples; its
+     *        allocation is reused when it is large enough and not shared
+     * @return false for bitstreams TurboJPEG cannot decode (12-bit, lossless)
+     */
+    static bool decode(const QByteArray& bitstream, int width, int height, int samplesPerPixel,
+                       QByteArray& samples);
+};
+#endif
@@ -0,0 +1,319 @@
+#include "WindowLevelEngine.h"
+#include <QtGlobal>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define WLE_HAVE_AVX2 1
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define WLE_HAVE_SSE2 1
+#endif
+
+namespace {
+
+struct KernelConstants
+{
+    float scale;
+    float offset;
+    quint16 mask;
+    int signShift;
+    bool isSigned;
+    uchar invertMask;
+};
+
+#if defined(WLE_HAVE_AVX2)
+
+inline __m256i loadSixteen(const quint8* src)
+{
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+}
+
+inline __m256i loadSixteen(const quint16* src)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+}
+
+inline __m256i mapEightAvx2(__m256i stored, const KernelConstants& k)
+{
+    __m256 value = _mm256_cvtepi32_ps(stored);
+    value = _mm256_add_ps(_mm256_mul_ps(value, _mm256_set1_ps(k.scale)), _mm256_set1_ps(k.offset));
+    value = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+    return _mm256_cvttps_epi32(value);
+}
+
+// Sixteen samples in 16-bit lanes -> sixteen display values in 16-bit lanes
+// (lane-interleaved as _mm256_packs_epi32 leaves them)
+inline __m256i mapSixteenAvx2(__m256i codes, const KernelConstants& k)
+{
+    __m256i lo, hi;
+    if (k.isSigned) {
+        const __m128i shift = _mm_cvtsi32_si128(k.signShift);
+        codes = _mm256_sra_epi16(_mm256_sll_epi16(codes, shift), shift);
+        lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(codes));
+        hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(codes, 1));
+    } else {
+        codes = _mm256_and_si256(codes, _mm256_set1_epi16(static_cast<short>(k.mask)));
+        lo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(codes));
+        hi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(codes, 1));
+    }
+    return _mm256_packs_epi32(mapEightAvx2(lo, k), mapEightAvx2(hi, k));
+}
+
+inline __m256i reverseBytes(__m256i v)
+{
+    const __m256i reversed = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                              15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    v = _mm256_shuffle_epi8(v, reversed);
+    return _mm256_permute2x128_si256(v, v, 0x01);
+}
+
+template <typename Sample>
+int mapRowAvx2(const Sample* src, uchar* dst, int count, bool reverse, const KernelConstants& k)
+{
+    const __m256i invert = _mm256_set1_epi8(static_cast<char>(k.invertMask));
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    int i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i first = mapSixteenAvx2(loadSixteen(src + i), k);
+        __m256i second = mapSixteenAvx2(loadSixteen(src + i + 16), k);
+        __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(first, second), order);
+        bytes = _mm256_xor_si256(bytes, invert);
+        if (reverse) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + count - 32 - i), reverseBytes(bytes));
+        } else {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), bytes);
+        }
+    }
+    return i;
+}
+
+#elif defined(WLE_HAVE_SSE2)
+
+inline __m128i loadEight(const quint8* src)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)), _mm_setzero_si128());
+}
+
+inline __m128i loadEight(const quint16* src)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+}
+
+inline __m128i mapFourSse2(__m128i stored, const KernelConstants& k)
+{
+    __m128 value = _mm_cvtepi32_ps(stored);
+    value = _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(k.scale)), _mm_set1_ps(k.offset));
+    value = _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+    return _mm_cvttps_epi32(value);
+}
+
+// Eight samples in 16-bit lanes -> eight display values in 16-bit lanes
+inline __m128i mapEightSse2(__m128i codes, const KernelConstants& k)
+{
+    __m128i lo, hi;
+    if (k.isSigned) {
+        const __m128i shift = _mm_cvtsi32_si128(k.signShift);
+        codes = _mm_sra_epi16(_mm_sll_epi16(codes, shift), shift);
+        const __m128i sign = _mm_srai_epi16(codes, 15);
+        lo = _mm_unpacklo_epi16(codes, sign);
+        hi = _mm_unpackhi_epi16(codes, sign);
+    } else {
+        codes = _mm_and_si128(codes, _mm_set1_epi16(static_cast<short>(k.mask)));
+        lo = _mm_unpacklo_epi16(codes, _mm_setzero_si128());
+        hi = _mm_unpackhi_epi16(codes, _mm_setzero_si128());
+    }
+    return _mm_packs_epi32(mapFourSse2(lo, k), mapFourSse2(hi, k));
+}
+
+inline __m128i reverseBytes(__m128i v)
+{
+    // Reverse dwords, then words within dwords, then bytes within words
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+template <typename Sample>
+int mapRowSse2(const Sample* src, uchar* dst, int count, bool reverse, const KernelConstants& k)
+{
+    const __m128i invert = _mm_set1_epi8(static_cast<char>(k.invertMask));
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i bytes = _mm_packus_epi16(mapEightSse2(loadEight(src + i), k),
+                                         mapEightSse2(loadEight(src + i + 8), k));
+        bytes = _mm_xor_si128(bytes, invert);
+        if (reverse) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + count - 16 - i), reverseBytes(bytes));
+        } else {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), bytes);
+        }
+    }
+    return i;
+}
+
+#endif
+
+} // namespace
+
+WindowLevelEngine::WindowLevelEngine()
+    : m_scale(0.0f)
+    , m_offset(128.0f)
+    , m_mask(0xFF)
+    , m_signShift(8)
+    , m_invertMask(0)
+{
+    rebuild();
+}
+
+const char* WindowLevelEngine::kernelName()
+{
+#if defined(WLE_HAVE_AVX2)
+    return "AVX2";
+#elif defined(WLE_HAVE_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
+
+void WindowLevelEngine::setParameters(const Parameters& parameters)
+{
+    if (parameters == m_parameters && !m_lut.isEmpty()) {
+        return;
+    }
+    m_parameters = parameters;
+    rebuild();
+}
+
+void WindowLevelEngine::rebuild()
+{
+    const int bits = qBound(1, m_parameters.bitsStored, 16);
+    const double slope = (m_parameters.slope != 0.0) ? m_parameters.slope : 1.0;
+    const double width = m_parameters.width;
+
+    // display = stored * scale + offset; a degenerate window shows mid-gray
+    if (width <= 1.0) {
+        m_scale = 0.0f;
+        m_offset = 128.0f;
+    } else {
+        m_scale = static_cast<float>(slope * 255.0 / width);
+        m_offset = static_cast<float>((m_parameters.intercept - (m_parameters.center - width / 2.0)) * 255.0 / width);
+    }
+    m_mask = static_cast<quint16>((1u << bits) - 1);
+    m_signShift = 16 - bits;
+    m_invertMask = m_parameters.invert ? 0xFF : 0x00;
+
+    const int lutSize = (bits <= 8) ? 256 : (bits <= 12 ? 4096 : 65536);
+    m_lut.resize(lutSize);
+
+    // Tabulate through the row kernel so table and kernel agree bit for bit
+    QVector<quint16> codes(lutSize);
+    for (int code = 0; code < lutSize; ++code) {
+        codes[code] = static_cast<quint16>(code);
+    }
+    const int done = applyRowSimd(reinterpret_cast<const uchar*>(codes.constData()), 2, m_lut.data(), lutSize, false);
+
+    const quint32 signBit = 1u << (bits - 1);
+    for (int code = done; code < lutSize; ++code) {
+        quint32 raw = static_cast<quint32>(code) & m_mask;
+        qint32 stored = (m_parameters.isSigned && (raw & signBit)) ? static_cast<qint32>(raw) - (1 << bits)
+                                                                  : static_cast<qint32>(raw);
+        float value = static_cast<float>(stored) * m_scale + m_offset;
+        value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+        m_lut[code] = static_cast<uchar>(static_cast<int>(value)) ^ m_invertMask;
+    }
+}
+
+int WindowLevelEngine::applyRowSimd(const uchar* src, int bytesPerSample, uchar* dst, int count,
+                                    bool reverse) const
+{
+#if defined(WLE_HAVE_AVX2) || defined(WLE_HAVE_SSE2)
+    const KernelConstants k = { m_scale, m_offset, m_mask, m_signShift, m_parameters.isSigned, m_invertMask };
+#if defined(WLE_HAVE_AVX2)
+    return (bytesPerSample == 2) ? mapRowAvx2(reinterpret_cast<const quint16*>(src), dst, count, reverse, k)
+                                 : mapRowAvx2(reinterpret_cast<const quint8*>(src), dst, count, reverse, k);
+#else
+    return (bytesPerSample == 2) ? mapRowSse2(reinterpret_cast<const quint16*>(src), dst, count, reverse, k)
+                                 : mapRowSse2(reinterpret_cast<const quint8*>(src), dst, count, reverse, k);
+#endif
+#else
+    Q_UNUSED(src)
+    Q_UNUSED(bytesPerSample)
+    Q_UNUSED(dst)
+    Q_UNUSED(count)
+    Q_UNUSED(reverse)
+    return 0;
+#endif
+}
+
+void WindowLevelEngine::applyRow(const uchar* src, int bytesPerSample, uchar* dst, int count,
+                                 bool reverse) const
+{
+    int x = applyRowSimd(src, bytesPerSample, dst, count, reverse);
+
+    // Row tail (or the whole row without SIMD) through the lookup table
+    const uchar* lut = m_lut.constData();
+    const int last = reverse ? count - 1 : 0;
+    const int step = reverse ? -1 : 1;
+    if (bytesPerSample == 2) {
+        const quint16* samples = reinterpret_cast<const quint16*>(src);
+        for (; x < count; ++x) {
+            dst[last + step * x] = lut[samples[x] & m_mask];
+        }
+    } else {
+        for (; x < count; ++x) {
+            dst[last + step * x] = lut[src[x] & m_mask];
+        }
+    }
+}
+
+bool WindowLevelEngine::apply(const uchar* src, qsizetype srcStride, int bytesPerSample, int width, int height,
+                              QImage& output, bool flipRows, bool flipColumns) const
+{
+    if (!src || width <= 0 || height <= 0) {
+        return false;
+    }
+
+    if (output.width() != width || output.height() != height || output.format() != QImage::Format_Grayscale8) {
+        output = QImage(width, height, QImage::Format_Grayscale8);
+        if (output.isNull()) {
+            return false;
+        }
+    }
+
+    for (int y = 0; y < height; ++y) {
+        const int outY = flipRows ? height - 1 - y : y;
+        applyRow(src + y * srcStride, bytesPerSample, output.scanLine(outY), width, flipColumns);
+    }
+    return true;
+}
+
+bool WindowLevelEngine::apply(const DicomPixelFrame& frame, QImage& output, bool flipRows, bool flipColumns) const
+{
+    if (frame.isNull() || frame.samplesPerPixel != 1) {
+        return false;
+    }
+
+    const int bytesPerSample = frame.bytesPerSample();
+    const qsizetype rowBytes = static_cast<qsizetype>(frame.width) * bytesPerSample;
+    if (frame.samples.size() < rowBytes * frame.height) {
+        return false;
+    }
+
+    return apply(reinterpret_cast<const uchar*>(frame.samples.constData()), rowBytes, bytesPerSample,
+                 frame.width, frame.height, output, flipRows, flipColumns);
+}
+
+QImage WindowLevelEngine::apply(const DicomPixelFrame& frame) const
+{
+    QImage result;
+    if (!apply(frame, result, false, false)) {
+        return QImage();
+    }
+    return result;
+}
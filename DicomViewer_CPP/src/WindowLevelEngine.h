@@ -0,0 +1,105 @@
+#pragma once
+
+#include <QImage>
+#include <QVector>
+#include "DicomPixelFrame.h"
+
+/**
+ * @brief Window/level mapping from stored pixel values to 8-bit display values
+ *
+ * Rescale and window are folded into one linear map per stored value,
+ * display = clamp(stored * scale + offset, 0, 255), optionally inverted.
+ * The map is tabulated once per parameter change into a lookup table with
+ * one entry per stored code (256, 4096 or 65536 entries depending on
+ * BitsStored). Rows are mapped by an SSE2 or AVX2 kernel that evaluates the
+ * same map arithmetically, so no gathers are needed; the table covers the
+ * row tails and builds without SIMD. The table is filled by the kernel
+ * itself, so both paths give identical output.
+ *
+ * The image overloads of apply() also take row and column flips, which only
+ * change where each output row and pixel is written. Together with invert
+ * folded into the table, a displayed frame is produced in one read of the
+ * source and one write of the output.
+ */
+class WindowLevelEngine
+{
+public:
+    struct Parameters
+    {
+        double center = 0.0;        // Window center in modality units
+        double width = 1.0;         // Window width in modality units
+        double slope = 1.0;         // Rescale slope
+        double intercept = 0.0;     // Rescale intercept
+        bool invert = false;        // Output 255 - value (MONOCHROME1 and/or user invert)
+        int bitsStored = 8;
+        bool isSigned = false;
+
+        bool operator==(const Parameters& other) const
+        {
+            return center == other.center && width == other.width &&
+                   slope == other.slope && intercept == other.intercept &&
+                   invert == other.invert && bitsStored == other.bitsStored &&
+                   isSigned == other.isSigned;
+        }
+        bool operator!=(const Parameters& other) const { return !(*this == other); }
+    };
+
+    WindowLevelEngine();
+
+    /**
+     * @brief Set the mapping; the lookup table is rebuilt only if it changed
+     */
+    void setParameters(const Parameters& parameters);
+    const Parameters& parameters() const { return m_parameters; }
+
+    /**
+     * @brief Lookup table indexed by the stored code masked to BitsStored
+     */
+    const uchar* lut() const { return m_lut.constData(); }
+    int lutSize() const { return m_lut.size(); }
+
+    /**
+     * @brief Map one row of samples to 8-bit display values
+     * @param src count samples, 1 or 2 bytes each (host order)
+     * @param bytesPerSample 1 or 2
+     * @param dst Receives count bytes
+     * @param reverse Write src[x] to dst[count - 1 - x]
+     */
+    void applyRow(const uchar* src, int bytesPerSample, uchar* dst, int count, bool reverse = false) const;
+
+    /**
+     * @brief Map and flip an image in one pass into a reusable Grayscale8 buffer
+     * @param src First row of samples, rows srcStride bytes apart
+     * @param flipRows Write source row y to output row height - 1 - y
+     * @param flipColumns Write source column x to output column width - 1 - x
+     * @param output Reallocated only if its size or format differs. If the
+     *        caller still shares it, Qt detaches on the first write.
+     * @return true if output was written
+     */
+    bool apply(const uchar* src, qsizetype srcStride, int bytesPerSample, int width, int height,
+               QImage& output, bool flipRows, bool flipColumns) const;
+    bool apply(const DicomPixelFrame& frame, QImage& output, bool flipRows, bool flipColumns) const;
+
+    /**
+     * @brief Map a single-sample native frame to a Grayscale8 image
+     * @return Grayscale8 image, or a null image for colour or empty frames
+     */
+    QImage apply(const DicomPixelFrame& frame) const;
+
+    /**
+     * @brief Name of the row kernel compiled into this build ("AVX2", "SSE2" or "scalar")
+     */
+    static const char* kernelName();
+
+private:
+    void rebuild();
+    int applyRowSimd(const uchar* src, int bytesPerSample, uchar* dst, int count, bool reverse) const;
+
+    Parameters m_parameters;
+    float m_scale;
+    float m_offset;
+    quint16 m_mask;
+    int m_signShift;            // 16 - BitsStored, used to sign-extend signed codes
+    uchar m_invertMask;         // 0xFF when inverting, XORed into the output
+    QVector<uchar> m_lut;
+};
@@ -1,4 +1,6 @@
 ﻿#include "dicomreader.h"
+#include "DicomHeaderProbe.h"
+#include "DicomThumbnailCache.h"
 #include <QFile>
 #include <QFileInfo>
 #include <QDir>
@@ -23,6 +25,9 @@
 
 DicomReader::DicomReader()
     : m_totalImages(0)
+    , m_thumbnailCache(nullptr)
+    , m_indexedImages(0)
+    , m_existingImages(0)
 {
 }
 
@@ -36,6 +41,76 @@ void DicomReader::clearData()
     m_totalImages = 0;
     m_lastError.clear();
     m_basePath.clear();
+    m_imageIndex.clear();
+    m_indexedImages = 0;
+    m_existingImages = 0;
+    m_treeItems.clear();
+}
+
+void DicomReader::rebuildImageIndex()
+{
+    m_imageIndex.clear();
+    m_indexedImages = 0;
+    m_existingImages = 0;
+    
+    for (auto patientIt = m_patients.constBegin(); patientIt != m_patients.constEnd(); ++patientIt) {
+        for (auto studyIt = patientIt->studies.constBegin(); studyIt != patientIt->studies.constEnd(); ++studyIt) {
+            for (auto seriesIt = studyIt->series.constBegin(); seriesIt != studyIt->series.constEnd(); ++seriesIt) {
+                const QList<DicomImageInfo>& images = seriesIt->images;
+                for (int i = 0; i < images.size(); ++i) {
+                    m_indexedImages++;
+                    if (images[i].fileExists) {
+                        m_existingImages++;
+                    }
+                    
+                    // First image with a given name wins, as in the old linear search
+                    QString key = QFileInfo(images[i].filePath).fileName().toLower();
+                    if (!m_imageIndex.contains(key)) {
+                        ImageLocation location;
+                        location.patientID = patientIt.key();
+                        location.studyUID = studyIt.key();
+                        location.seriesUID = seriesIt.key();
+                        location.index = i;
+                        m_imageIndex.insert(key, location);
+                    }
+                }
+            }
+        }
+    }
+}
+
+const DicomImageInfo* DicomReader::findImage(const QString& fileName) const
+{
+    auto locationIt = m_imageIndex.constFind(QFileInfo(fileName).fileName().toLower());
+    if (locationIt == m_imageIndex.constEnd()) {
+        return nullptr;
+    }
+    
+    auto patientIt = m_patients.constFind(locationIt->patientID);
+    if (patientIt == m_patients.constEnd()) return nullptr;
+    auto studyIt = patientIt->studies.constFind(locationIt->studyUID);
+    if (studyIt == patientIt->studies.constEnd()) return nullptr;
+    auto seriesIt = studyIt->series.constFind(locationIt->seriesUID);
+    if (seriesIt == studyIt->series.constEnd()) return nullptr;
+    if (locationIt->index < 0 || locationIt->index >= seriesIt->images.size()) return nullptr;
+    return &seriesIt->images[locationIt->index];
+}
+
+DicomImageInfo* DicomReader::findImage(const QString& fileName)
+{
+    auto locationIt = m_imageIndex.constFind(QFileInfo(fileName).fileName().toLower());
+    if (locationIt == m_imageIndex.constEnd()) {
+        return nullptr;
+    }
+    
+    auto patientIt = m_patients.find(locationIt->patientID);
+    if (patientIt == m_patients.end()) return nullptr;
+    auto studyIt = patientIt->studies.find(locationIt->studyUID);
+    if (studyIt == patientIt->studies.end()) return nullptr;
+    auto seriesIt = studyIt->series.find(locationIt->seriesUID);
+    if (seriesIt == studyIt->series.end()) return nullptr;
+    if (locationIt->index < 0 || locationIt->index >= seriesIt->images.size()) return nullptr;
+    return &seriesIt->images[locationIt->index];
 }
 
 QString DicomReader::cleanDicomText(const QString& text)
@@ -95,7 +170,9 @@ bool DicomReader::loadDicomDir(const QString& dicomdirPath)
         return false;
     }
     
-    return parseWithDcmtk(dicomdirPath);
+    bool loaded = parseWithDcmtk(dicomdirPath);
+    rebuildImageIndex();
+    return loaded;
 }
 
 
@@ -107,6 +184,7 @@ void DicomReader::populateTreeWidget(QTreeWidget* treeWidget)
     LOG_DEBUG("##### populateTreeWidget() called - clearing and repopulating tree #####");
     
     treeWidget->clear();
+    m_treeItems.clear();
     
     // Update header
     treeWidget->setHeaderLabel(QString("All patients (Patients: %1, Images: %2)")
@@ -166,102 +244,18 @@ void DicomReader::populateTreeWidget(QTreeWidget* treeWidget)
                 int imageIndex = 0;  // Track image index for fallback naming
                 for (const DicomImageInfo& image : sortedImages) {
                     imageIndex++;
-                    // Generate proper display names that work even when files don't exist yet
-                    QString displayName;
-                    if (!image.displayName.isEmpty() && image.displayName.startsWith("SR DOC")) {
-                        // Keep SR DOC names as they are meaningful
-                        displayName = image.displayName;
-                    } else {
-                        // Extract meaningful filename from file path, even if file doesn't exist yet
-                        QFileInfo pathInfo(image.filePath);
-                        QString filename = pathInfo.fileName();
-                        
-                        // Debug: Show what we're getting - CRITICAL DEBUG
-                        LOG_DEBUG("************************ TREE POPULATION DEBUG ************************");
-                        LOG_DEBUG(QString("[TREE FILENAME DEBUG] FilePath: %1, Filename: %2, DisplayName: %3, FileExists: %4")
-                                 .arg(image.filePath).arg(filename).arg(image.displayName).arg(image.fileExists));
-                        LOG_DEBUG("************************ END TREE DEBUG ************************");
-                        
-                        // ALWAYS use the actual filename from the path if we have one
-                        // Don't check file existence - we want to show the real filename even if file doesn't exist yet
-                        if (!filename.isEmpty() && filename != "DICOMFiles" && filename != "DICOMDIR" && 
-                            !filename.endsWith(".") && filename.length() > 3) {
-                            // Use the actual DICOM filename - this should be the filename from DICOMDIR
-                            displayName = filename;
-                            LOG_DEBUG(QString("[TREE] Using actual filename: %1").arg(filename));
-                        } else {
-                            // Only fall back to generic names if we really don't have a valid filename
-                            LOG_WARN(QString("[TREE] Falling back to generic name for invalid filename: %1").arg(filename));
-                            if (image.instanceNumber > 0) {
-                                displayName = QString("Image_%1").arg(image.instanceNumber, 3, 10, QChar('0'));
-                            } else {
-                                // Fallback to generic numbering using current index
-                                displayName = QString("Image_%1").arg(imageIndex, 3, 10, QChar('0'));
-                            }
-                        }
-                    }
-                    
-                    // Add frame count information for multiframe images
-                    if (image.frameCount > 1) {
-                        displayName += QString(" (%1 frames)").arg(image.frameCount);
-                    }
-                    
-                    QTreeWidgetItem* imageItem = new QTreeWidgetItem(QStringList() << displayName);
-                    
-                    // Set UserRole data based on content type
-                    // Check if this is a Structured Report (SR) or RDSR file
-                    bool isReport = false;
-                    if (!image.displayName.isEmpty() && image.displayName.startsWith("SR DOC")) {
-                        isReport = true;
-                    } else if (image.fileExists) {
-                        // Also check if this is an RDSR file by SOP Class UID
-                        isReport = isRDSRFile(image.filePath);
-                    }
-                    
-                    if (isReport) {
-                        // This is a Structured Report document or RDSR - mark as "report" type
-                        imageItem->setData(0, Qt::UserRole, QVariantList() << "report" << image.filePath);
-                    } else {
-                        // This is an actual image - mark as "image" type
-                        imageItem->setData(0, Qt::UserRole, QVariantList() << "image" << image.filePath);
-                    }
-                    
-                    // Set icon based on file existence first, then file type and frame count
-                    QString iconName;
-                    QString tooltip;
+                    QTreeWidgetItem* imageItem = new QTreeWidgetItem();
+                    QString itemType = applyImageItemState(imageItem, image, imageIndex);
+                    seriesItem->addChild(imageItem);
                     
-                    if (!image.fileExists) {
-                        // File doesn't exist yet - show loading icon for all file types
-                        iconName = "Loading.png";
-                        if (!image.displayName.isEmpty() && image.displayName.startsWith("SR DOC")) {
-                            tooltip = QString("Loading Structured Report (SR) Document\nFile is being copied from media...");
-                        } else {
-                            tooltip = QString("Loading %1\nFile is being copied from media...")
-                                     .arg(image.frameCount > 1 ? "multiframe image" : "DICOM image");
-                        }
-                        imageItem->setForeground(0, QColor(180, 180, 180)); // Gray out text
-                    } else if (isReport) {
-                        // Check if this is specifically an RDSR (Radiation Dose Structured Report)
-                        bool isRDSR = isRDSRFile(image.filePath);
-                        if (isRDSR) {
-                            iconName = "RDSR.png"; // Special icon for RDSR
-                            tooltip = "Radiation Dose Structured Report (RDSR)";
-                        } else {
-                            // This is a regular Structured Report document that exists
-                            iconName = "List.png"; // Use document/list icon for SR
-                            tooltip = "Structured Report (SR) Document";
-                        }
-                    } else if (image.frameCount > 1) {
-                        iconName = "AcquisitionHeader.png";
-                        tooltip = QString("Multiframe DICOM image - %1 frames").arg(image.frameCount);
-                    } else {
-                        iconName = "Camera.png";
-                        tooltip = "Single frame DICOM image";
+                    QString itemKey = QFileInfo(image.filePath).fileName().toLower();
+                    if (!m_treeItems.contains(itemKey)) {
+                        TreeItemRef ref;
+                        ref.item = imageItem;
+                        ref.itemType = itemType;
+                        ref.imageIndex = imageIndex;
+                        m_treeItems.insert(itemKey, ref);
                     }
-                    
-                    imageItem->setIcon(0, QIcon(":/icons/" + iconName));
-                    imageItem->setToolTip(0, tooltip);
-                    seriesItem->addChild(imageItem);
                 }
             }
         }
@@ -277,6 +271,139 @@ void DicomReader::populateTreeWidget(QTreeWidget* treeWidget)
     treeWidget->expandAll();
 }
 
+QString DicomReader::applyImageItemState(QTreeWidgetItem* item, const DicomImageInfo& image, int imageIndex)
+{
+    // Generate proper display names that work even when files don't exist yet
+    QString displayName;
+    if (!image.displayName.isEmpty() && image.displayName.startsWith("SR DOC")) {
+        // Keep SR DOC names as they are meaningful
+        displayName = image.displayName;
+    } else {
+        // Extract meaningful filename from file path, even if file doesn't exist yet
+        QFileInfo pathInfo(image.filePath);
+        QString filename = pathInfo.fileName();
+        
+        // Debug: Show what we're getting - CRITICAL DEBUG
+        LOG_DEBUG("************************ TREE POPULATION DEBUG ************************");
+        LOG_DEBUG(QString("[TREE FILENAME DEBUG] FilePath: %1, Filename: %2, DisplayName: %3, FileExists: %4")
+                 .arg(image.filePath).arg(filename).arg(image.displayName).arg(image.fileExists));
+        LOG_DEBUG("************************ END TREE DEBUG ************************");
+        
+        // ALWAYS use the actual filename from the path if we have one
+        // Don't check file existence - we want to show the real filename even if file doesn't exist yet
+        if (!filename.isEmpty() && filename != "DICOMFiles" && filename != "DICOMDIR" && 
+            !filename.endsWith(".") && filename.length() > 3) {
+            // Use the actual DICOM filename - this should be the filename from DICOMDIR
+            displayName = filename;
+            LOG_DEBUG(QString("[TREE] Using actual filename: %1").arg(filename));
+        } else {
+            // Only fall back to generic names if we really don't have a valid filename
+            LOG_WARN(QString("[TREE] Falling back to generic name for invalid filename: %1").arg(filename));
+            if (image.instanceNumber > 0) {
+                displayName = QString("Image_%1").arg(image.instanceNumber, 3, 10, QChar('0'));
+            } else {
+                // Fallback to generic numbering using current index
+                displayName = QString("Image_%1").arg(imageIndex, 3, 10, QChar('0'));
+            }
+        }
+    }
+    
+    // Add frame count information for multiframe images
+    if (image.frameCount > 1) {
+        displayName += QString(" (%1 frames)").arg(image.frameCount);
+    }
+    
+    item->setText(0, displayName);
+    // Progress display captures the plain text again on its next update
+    item->setData(0, Qt::UserRole + 1, QVariant());
+    
+    // Set UserRole data based on content type
+    // Check if this is a Structured Report (SR) or RDSR file (one header read, only once the file exists)
+    bool isRDSR = image.fileExists && isRDSRFile(image.filePath);
+    bool isReport = isRDSR || (!image.displayName.isEmpty() && image.displayName.startsWith("SR DOC"));
+    
+    if (isReport) {
+        // This is a Structured Report document or RDSR - mark as "report" type
+        item->setData(0, Qt::UserRole, QVariantList() << "report" << image.filePath);
+    } else {
+        // This is an actual image - mark as "image" type
+        item->setData(0, Qt::UserRole, QVariantList() << "image" << image.filePath);
+    }
+    
+    // Set icon based on file existence first, then file type and frame count
+    QString iconName;
+    QString tooltip;
+    
+    if (!image.fileExists) {
+        // File doesn't exist yet - show loading icon for all file types
+        iconName = "Loading.png";
+        if (!image.displayName.isEmpty() && image.displayName.startsWith("SR DOC")) {
+            tooltip = QString("Loading Structured Report (SR) Document\nFile is being copied from media...");
+        } else {
+            tooltip = QString("Loading %1\nFile is being copied from media...")
+                     .arg(image.frameCount > 1 ? "multiframe image" : "DICOM image");
+        }
+        item->setForeground(0, QColor(180, 180, 180)); // Gray out text
+    } else if (isReport) {
+        // Check if this is specifically an RDSR (Radiation Dose Structured Report)
+        if (isRDSR) {
+            iconName = "RDSR.png"; // Special icon for RDSR
+            tooltip = "Radiation Dose Structured Report (RDSR)";
+        } else {
+            // This is a regular Structured Report document that exists
+            iconName = "List.png"; // Use document/list icon for SR
+            tooltip = "Structured Report (SR) Document";
+        }
+    } else if (image.frameCount > 1) {
+        iconName = "AcquisitionHeader.png";
+        tooltip = QString("Multiframe DICOM image - %1 frames").arg(image.frameCount);
+    } else {
+        iconName = "Camera.png";
+        tooltip = "Single frame DICOM image";
+    }
+    
+    if (image.fileExists) {
+        item->setData(0, Qt::ForegroundRole, QVariant());
+    }
+    
+    item->setIcon(0, QIcon(":/icons/" + iconName));
+    item->setToolTip(0, tooltip);
+    return isReport ? "report" : "image";
+}
+
+void DicomReader::updateTreeItems(const QStringList& filePaths)
+{
+    for (const QString& filePath : filePaths) {
+        auto refIt = m_treeItems.find(QFileInfo(filePath).fileName().toLower());
+        const DicomImageInfo* image = findImage(filePath);
+        if (refIt == m_treeItems.end() || !refIt->item || !image) {
+            continue;
+        }
+        // Setters only notify the view when a value really changes
+        refIt->itemType = applyImageItemState(refIt->item, *image, refIt->imageIndex);
+    }
+}
+
+QTreeWidgetItem* DicomReader::findTreeItem(const QString& filePath) const
+{
+    return m_treeItems.value(QFileInfo(filePath).fileName().toLower()).item;
+}
+
+QString DicomReader::treeItemType(const QString& filePath) const
+{
+    return m_treeItems.value(QFileInfo(filePath).fileName().toLower()).itemType;
+}
+
+QList<QTreeWidgetItem*> DicomReader::fileTreeItems() const
+{
+    QList<QTreeWidgetItem*> items;
+    items.reserve(m_treeItems.size());
+    for (const TreeItemRef& ref : m_treeItems) {
+        items.append(ref.item);
+    }
+    return items;
+}
+
 #ifdef HAVE_DCMTK
 bool DicomReader::parseWithDcmtk(const QString& dicomdirPath)
 {
@@ -444,6 +571,7 @@ bool DicomReader::parseWithDcmtk(const QString& dicomdirPath)
                                 DicomImageInfo imageInfo;
                                 imageInfo.filePath = fullPath;  // Use the path exactly as specified in DICOMDIR
                                 imageInfo.isDirectory = false;
+                                imageInfo.sopInstanceUID = sopUID;
                                 
                                 // CRITICAL: Debug what filename we'll extract from this path
                                 QString extractedFilename = QFileInfo(fullPath).fileName();
@@ -606,6 +734,7 @@ bool DicomReader::parseWithDcmtk(const QString& dicomdirPath)
                                         DicomImageInfo docInfo;
                                         docInfo.filePath = expectedFilePath;
                                         docInfo.isDirectory = false;
+                                        docInfo.sopInstanceUID = sopUID;
                                         docInfo.instanceNumber = !instanceNumberStr.empty() ? 
                                             atoi(instanceNumberStr.c_str()) : seriesInstanceCount;
                                         docInfo.frameCount = 1;
@@ -722,38 +851,37 @@ bool DicomReader::parseWithDcmtk(const QString& dicomdirPath)
 
 int DicomReader::getFrameCountFromFile(const QString& filePath)
 {
-    try {
-        // Use DCMTK to properly read the Number of Frames tag
-        DcmFileFormat dcmFile;
-        OFCondition status = dcmFile.loadFile(filePath.toLocal8Bit().constData());
-        if (status.bad()) {
-            return 1;
-        }
-        
-        DcmDataset* dataset = dcmFile.getDataset();
-        if (!dataset) {
-            return 1;
-        }
-        
-        // Try to get Number of Frames (0028,0008)
-        OFString numberOfFramesStr;
-        if (dataset->findAndGetOFString(DCM_NumberOfFrames, numberOfFramesStr).good()) {
-            if (!numberOfFramesStr.empty()) {
-                int frameCount = atoi(numberOfFramesStr.c_str());
-                if (frameCount > 0 && frameCount < 100000) { // Sanity check
-                    return frameCount;
-                }
-            }
-        }
-        
-        // If no Number of Frames tag found, it's likely a single frame image
-        return 1;
-        
-    } catch (const std::exception& e) {
-        return 1;
-    } catch (...) {
+    return probeFrameCount(filePath, m_thumbnailCache);
+}
+
+int DicomReader::probeFrameCount(const QString& filePath, DicomThumbnailCache* cache)
+{
+    // Unchanged files probed in an earlier session need no read at all
+    DicomThumbnailCache::Entry cached;
+    if (cache && cache->lookup(filePath, QString(), cached) && cached.frameCount > 0) {
+        return cached.frameCount;
+    }
+    
+    // Number of Frames (0028,0008) lives in the header - no need to read pixel data
+    DicomHeaderInfo header = DicomHeaderProbe::read(filePath);
+    if (!header.valid) {
         return 1;
     }
+    
+    // If no Number of Frames tag found, it's likely a single frame image
+    int frameCount = 1;
+    if (header.numberOfFrames > 0 && header.numberOfFrames < 100000) { // Sanity check
+        frameCount = header.numberOfFrames;
+    }
+    
+    if (cache) {
+        DicomThumbnailCache::Entry entry;
+        entry.sopInstanceUID = header.sopInstanceUID;
+        entry.filePath = filePath;
+        entry.frameCount = frameCount;
+        cache->insert(entry);
+    }
+    return frameCount;
 } 
 
 QList<DicomImageInfo> DicomReader::expandDirectoryEntries(const QList<DicomImageInfo>& images)
@@ -814,24 +942,13 @@ QString DicomReader::extractSeriesDescriptionFromFile(const QString& filePath)
 {
 #ifdef HAVE_DCMTK
     try {
-        DcmFileFormat dcmFile;
-        OFCondition status = dcmFile.loadFile(filePath.toLocal8Bit().constData());
-        if (status.bad()) {
+        DicomHeaderInfo header = DicomHeaderProbe::read(filePath);
+        if (!header.valid) {
             return "No Series Description";
         }
         
-        DcmDataset* dataset = dcmFile.getDataset();
-        if (!dataset) {
-            return "No Series Description";
-        }
-        
-        OFString seriesDesc;
-        if (dataset->findAndGetOFString(DCM_SeriesDescription, seriesDesc).good()) {
-            QString result = QString::fromStdString(seriesDesc.c_str()).replace('^', ' ').trimmed();
-            return result.isEmpty() ? "No Series Description" : result;
-        }
-        
-        return "No Series Description";
+        QString result = QString(header.seriesDescription).replace('^', ' ').trimmed();
+        return result.isEmpty() ? "No Series Description" : result;
     } catch (...) {
         return "No Series Description";
     }
@@ -841,9 +958,14 @@ QString DicomReader::extractSeriesDescriptionFromFile(const QString& filePath)
 #endif
 }
 
-void DicomReader::refreshFileExistenceStatus()
+QStringList DicomReader::refreshFileExistenceStatus()
 {
-    // Update file existence status for all images in all patients/studies/series
+    QStringList appeared;
+    if (m_existingImages >= m_indexedImages) {
+        return appeared;
+    }
+    
+    // Files only ever appear during a copy, so present files are not stat'ed again
     for (auto patientIt = m_patients.begin(); patientIt != m_patients.end(); ++patientIt) {
         DicomPatientInfo& patient = patientIt.value();
         for (auto studyIt = patient.studies.begin(); studyIt != patient.studies.end(); ++studyIt) {
@@ -851,24 +973,44 @@ void DicomReader::refreshFileExistenceStatus()
             for (auto seriesIt = study.series.begin(); seriesIt != study.series.end(); ++seriesIt) {
                 DicomSeriesInfo& series = seriesIt.value();
                 for (DicomImageInfo& image : series.images) {
-                    bool wasExisting = image.fileExists;
-                    
-                    // Update file existence status
-                    image.fileExists = QFile::exists(image.filePath);
-                    
-                    // If file just became available, read actual frame count from the DICOM file
-                    if (image.fileExists && !wasExisting) {
-                        int actualFrameCount = getFrameCountFromFile(image.filePath);
-                        if (actualFrameCount > 0) {
-                            logMessage(LOG_DEBUG, QString("[FRAME COUNT UPDATE] %1 - DICOMDIR frames: %2 - Actual frames: %3")
-                                     .arg(QFileInfo(image.filePath).fileName()).arg(image.frameCount).arg(actualFrameCount));
-                            image.frameCount = actualFrameCount;
-                        }
+                    if (!image.fileExists && QFile::exists(image.filePath)) {
+                        image.fileExists = true;
+                        m_existingImages++;
+                        appeared.append(image.filePath);
                     }
                 }
             }
         }
     }
+    return appeared;
+}
+
+bool DicomReader::markFileAvailable(const QString& fileName)
+{
+    DicomImageInfo* image = findImage(fileName);
+    if (!image || image->fileExists) {
+        return false;
+    }
+    
+    if (!QFile::exists(image->filePath)) {
+        return false;
+    }
+    image->fileExists = true;
+    m_existingImages++;
+    return true;
+}
+
+bool DicomReader::setFrameCountForFile(const QString& fileName, int frameCount)
+{
+    DicomImageInfo* image = findImage(fileName);
+    if (!image || frameCount <= 0 || image->frameCount == frameCount) {
+        return false;
+    }
+    
+    logMessage(LOG_DEBUG, QString("[FRAME COUNT UPDATE] %1 - DICOMDIR frames: %2 - Actual frames: %3")
+             .arg(QFileInfo(image->filePath).fileName()).arg(image->frameCount).arg(frameCount));
+    image->frameCount = frameCount;
+    return true;
 }
 
 void DicomReader::startProactiveCopyMonitoring()
@@ -885,25 +1027,9 @@ double DicomReader::calculateProgress() const
         return 0.0;
     }
     
-    int existingFiles = 0;
-    int totalFiles = 0;
-    
-    // Count existing files vs total files
-    for (auto patientIt = m_patients.begin(); patientIt != m_patients.end(); ++patientIt) {
-        const DicomPatientInfo& patient = patientIt.value();
-        for (auto studyIt = patient.studies.begin(); studyIt != patient.studies.end(); ++studyIt) {
-            const DicomStudyInfo& study = studyIt.value();
-            for (auto seriesIt = study.series.begin(); seriesIt != study.series.end(); ++seriesIt) {
-                const DicomSeriesInfo& series = seriesIt.value();
-                for (const DicomImageInfo& image : series.images) {
-                    totalFiles++;
-                    if (image.fileExists) {
-                        existingFiles++;
-                    }
-                }
-            }
-        }
-    }
+    // Counts are kept up to date by rebuildImageIndex() and the refresh methods
+    int existingFiles = m_existingImages;
+    int totalFiles = m_indexedImages;
     
     // Calculate percentage
     if (totalFiles == 0) {
@@ -922,22 +1048,14 @@ bool DicomReader::isStructuredReport(const QString& filePath)
     
 #ifdef HAVE_DCMTK
     try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return false;
-        }
-        
-        DcmDataset* dataset = fileformat.getDataset();
-        if (!dataset) {
+        DicomHeaderInfo header = DicomHeaderProbe::read(filePath);
+        if (!header.valid) {
             return false;
         }
         
         // Check SOP Class UID for known SR types
-        OFString sopClassUID;
-        if (dataset->findAndGetOFString(DCM_SOPClassUID, sopClassUID).good()) {
-            QString sopUID = QString::fromStdString(sopClassUID.c_str());
+        if (!header.sopClassUID.isEmpty()) {
+            const QString& sopUID = header.sopClassUID;
             
             // Debug: Log the SOP Class UID we found
             LOG_DEBUG(QString("DICOM file SOP Class UID: %1").arg(sopUID));
@@ -993,26 +1111,11 @@ bool DicomReader::isRDSRFile(const QString& filePath) const
 
 #ifdef HAVE_DCMTK
     try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return false;
-        }
-        
-        DcmDataset* dataset = fileformat.getDataset();
-        if (!dataset) {
-            return false;
-        }
-        
         // Check SOP Class UID specifically for X-Ray Radiation Dose SR
-        OFString sopClassUID;
-        if (dataset->findAndGetOFString(DCM_SOPClassUID, sopClassUID).good()) {
-            // X-Ray Radiation Dose SR SOP Class UID
-            if (sopClassUID == "1.2.840.10008.5.1.4.1.1.88.67") {
-                LOG_DEBUG(QString("File identified as RDSR: %1").arg(filePath));
-                return true;
-            }
+        DicomHeaderInfo header = DicomHeaderProbe::read(filePath);
+        if (header.valid && header.isRadiationDoseSR()) {
+            LOG_DEBUG(QString("File identified as RDSR: %1").arg(filePath));
+            return true;
         }
     } catch (...) {
         LOG_ERROR(QString("Exception while checking RDSR file: %1").arg(filePath));
@@ -1024,41 +1127,11 @@ bool DicomReader::isRDSRFile(const QString& filePath) const
 
 DicomImageInfo DicomReader::getImageInfoForFile(const QString& filePath) const
 {
-    QString targetFileName = QFileInfo(filePath).fileName();
-    LOG_DEBUG(QString("[ICON DEBUG] Looking for image info for file: %1 from path: %2").arg(targetFileName).arg(filePath));
-    
-    // Search through all patients, studies, series to find the file
-    int itemCount = 0;
-    for (const auto& patient : m_patients) {
-        for (const auto& study : patient.studies) {
-            for (const auto& series : study.series) {
-                for (const auto& image : series.images) {
-                    itemCount++;
-                    QFileInfo imageFileInfo(image.filePath);
-                    QString imageFileName = imageFileInfo.fileName();
-                    
-                    // Debug first few items
-                    if (itemCount <= 3) {
-                        logMessage("DEBUG", QString("[ICON DEBUG] %1 Checking: %2 frames: %3").arg(itemCount).arg(imageFileName).arg(image.frameCount));
-                    }
-                    
-                    // Match by filename (case insensitive)
-                    if (imageFileName.compare(targetFileName, Qt::CaseInsensitive) == 0) {
-                        logMessage("DEBUG", QString("[ICON DEBUG] ✓ MATCH FOUND: %1 frames: %2").arg(imageFileName).arg(image.frameCount));
-                        return image;
-                    }
-                    
-                    // Also try exact path match
-                    if (image.filePath == filePath) {
-                        logMessage("DEBUG", QString("[ICON DEBUG] ✓ EXACT PATH MATCH: %1 frames: %2").arg(imageFileName).arg(image.frameCount));
-                        return image;
-                    }
-                }
-            }
-        }
+    if (const DicomImageInfo* image = findImage(filePath)) {
+        return *image;
     }
     
-    logMessage("DEBUG", QString("[ICON DEBUG] ✗ NO MATCH FOUND for: %1 - returning default (1 frame)").arg(targetFileName));
+    logMessage("DEBUG", QString("[ICON DEBUG] No image info for: %1 - returning default (1 frame)").arg(QFileInfo(filePath).fileName()));
     
     // Return default if not found
     DicomImageInfo defaultInfo;
@@ -1070,42 +1143,17 @@ DicomImageInfo DicomReader::getImageInfoForFile(const QString& filePath) const
 
 void DicomReader::updateFrameCountForFile(const QString& fileName)
 {
-    logMessage("DEBUG", QString("[FRAME COUNT UPDATE] Updating frame count for file: %1").arg(fileName));
-    
-    // Find the file in our data structures and update its frame count
-    for (auto& patient : m_patients) {
-        for (auto& study : patient.studies) {
-            for (auto& series : study.series) {
-                for (auto& image : series.images) {
-                    // Extract filename from full path to compare
-                    QString imageFileName = QFileInfo(image.filePath).fileName();
-                    
-                    if (imageFileName == fileName && image.fileExists) {
-                        logMessage("DEBUG", "[FRAME COUNT UPDATE] Found matching image, reading actual frame count...");
-                        
-                        // Re-read the actual frame count from the now-available file
-                        int actualFrameCount = getFrameCountFromFile(image.filePath);
-                        
-                        if (actualFrameCount != image.frameCount) {
-                            logMessage("DEBUG", QString("[FRAME COUNT UPDATE] Updated %1 from %2 to %3 frames")
-                                        .arg(fileName)
-                                        .arg(image.frameCount)
-                                        .arg(actualFrameCount));
-                            
-                            image.frameCount = actualFrameCount;
-                        } else {
-                            logMessage("DEBUG", QString("[FRAME COUNT UPDATE] Frame count unchanged: %1 frames")
-                                        .arg(actualFrameCount));
-                        }
-                        
-                        return; // Found and updated, we're done
-                    }
-                }
-            }
-        }
+    const DicomImageInfo* image = findImage(fileName);
+    if (!image) {
+        logMessage("WARN", QString("[FRAME COUNT UPDATE] File not found in data structures: %1").arg(fileName));
+        return;
+    }
+    if (!image->fileExists) {
+        return;
     }
     
-    logMessage("WARN", QString("[FRAME COUNT UPDATE] File not found in data structures: %1").arg(fileName));
+    // Re-read the actual frame count from the now-available file
+    setFrameCountForFile(fileName, getFrameCountFromFile(image->filePath));
 }
 
 #endif // HAVE_DCMTK
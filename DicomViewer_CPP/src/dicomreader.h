@@ -5,6 +5,7 @@
 #include <QString>
 #include <QStringList>
 #include <QMap>
+#include <QHash>
 #include <QTreeWidget>
 #include <QTreeWidgetItem>
 #include <QIcon>
@@ -18,6 +19,7 @@
 #endif
 
 class QFile;
+class DicomThumbnailCache;
 
 struct DicomImageInfo {
     QString filePath;
@@ -26,6 +28,7 @@ struct DicomImageInfo {
     bool fileExists = true;
     bool isDirectory = false; // True if filePath points to a directory containing DICOM files
     QString displayName; // Optional display name (e.g., "SR DOC 1" for structured reports)
+    QString sopInstanceUID; // From the DICOMDIR record, empty if not known
 };
 
 struct DicomSeriesInfo {
@@ -59,6 +62,15 @@ public:
     bool loadDicomDir(const QString& dicomdirPath);
     void populateTreeWidget(QTreeWidget* treeWidget);
     
+    // Image/report items of the last populated tree, by file name (case-insensitive); GUI thread only
+    QTreeWidgetItem* findTreeItem(const QString& filePath) const;
+    QString treeItemType(const QString& filePath) const;   // "image", "report" or empty if not in the tree
+    QList<QTreeWidgetItem*> fileTreeItems() const;
+    
+    // Re-apply text, icon, tooltip and type of these files' items in place; selection,
+    // expansion and item pointers are kept, and only changed items are repainted
+    void updateTreeItems(const QStringList& filePaths);
+    
     // Getters
     int getTotalPatients() const { return m_patients.size(); }
     int getTotalImages() const { return m_totalImages; }
@@ -69,16 +81,32 @@ public:
     static QString formatDate(const QString& dicomDate);
     
     // Copy monitoring support
-    void refreshFileExistenceStatus();
+    // Stats only files not yet present; returns the paths that just appeared (frame counts not probed)
+    QStringList refreshFileExistenceStatus();
     void startProactiveCopyMonitoring();
     double calculateProgress() const;
     
-    // Get image info for a specific file
+    // Mark one copied file as present; true if it was missing before (frame count not probed)
+    bool markFileAvailable(const QString& fileName);
+    
+    // Store a frame count probed elsewhere; true if the count changed
+    bool setFrameCountForFile(const QString& fileName, int frameCount);
+    
+    // Get image info for a specific file (matched by file name)
     DicomImageInfo getImageInfoForFile(const QString& filePath) const;
     
-    // Get frame count from DICOM file
+    // Get frame count from DICOM file (served from the thumbnail cache when the file is unchanged)
     int getFrameCountFromFile(const QString& filePath);
     
+    // Thread-safe frame count probe for worker threads; cache may be null
+    static int probeFrameCount(const QString& filePath, DicomThumbnailCache* cache);
+    
+    // Cache passed to probeFrameCount() by callers probing off the GUI thread
+    DicomThumbnailCache* thumbnailCache() const { return m_thumbnailCache; }
+    
+    // Persistent header cache consulted before probing files (optional, not owned)
+    void setThumbnailCache(DicomThumbnailCache* cache) { m_thumbnailCache = cache; }
+    
     // Update frame count for a specific file when it becomes available
     void updateFrameCountForFile(const QString& fileName);
     
@@ -87,15 +115,40 @@ public:
     bool isRDSRFile(const QString& filePath) const;
 
 private:
+    // Where an image lives in m_patients
+    struct ImageLocation {
+        QString patientID;
+        QString studyUID;
+        QString seriesUID;
+        int index = -1;
+    };
+    
     QMap<QString, DicomPatientInfo> m_patients;
     int m_totalImages;
     QString m_lastError;
     QString m_basePath;
+    DicomThumbnailCache* m_thumbnailCache;
+    QHash<QString, ImageLocation> m_imageIndex;  // Lower-case file name -> first image with that name
+    
+    // Tree item of a file and its type, kept by populateTreeWidget()
+    struct TreeItemRef {
+        QTreeWidgetItem* item = nullptr;
+        QString itemType;
+        int imageIndex = 0;                      // Position in its series, for fallback names
+    };
+    QHash<QString, TreeItemRef> m_treeItems;     // Lower-case file name -> first item with that name
+    int m_indexedImages;                         // Images in m_patients
+    int m_existingImages;                        // Of those, files present on disk
     
     // Private methods
     bool isDicomDir(const QString& filePath);
     void clearData();
+    void rebuildImageIndex();
+    DicomImageInfo* findImage(const QString& fileName);
+    const DicomImageInfo* findImage(const QString& fileName) const;
     bool isStructuredReport(const QString& filePath);
+    // Text, icon, tooltip and UserRole data of an image/report item; returns its type
+    QString applyImageItemState(QTreeWidgetItem* item, const DicomImageInfo& image, int imageIndex);
     
 private:
     
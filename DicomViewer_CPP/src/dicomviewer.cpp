@@ -1,11 +1,13 @@
 ﻿#include "dicomviewer.h"
 #include "DicomFrameProcessor.h"
+#include "DicomHeaderProbe.h"
+#include "DicomSRDocument.h"
+#include "PerfTrace.h"
 #include "saveimagedialog.h"
 #include "saverundialog.h"
 #include "dvdcopyworker.h"
 #include "thumbnailTask.h"
 
-#include <chrono>
 #include <cstdlib> // For std::exit
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QHeaderView>
@@ -47,6 +49,7 @@
 #include "dcmtk/dcmjpeg/djencode.h"
 #include "dcmtk/dcmjpeg/djrplol.h"
 #include "dcmtk/dcmdata/dccodec.h"
+#include "dcmtk/dcmdata/dcrledrg.h"
 #endif
 
 // Thread-aware logging helpers
@@ -81,6 +84,8 @@ ImageProcessingPipeline::ImageProcessingPipeline()
     , m_windowCenter(0.0)    // Default center for medical imaging
     , m_windowWidth(2000.0)  // Default width for medical imaging
     , m_bitsStored(8)        // Default to 8-bit
+    , m_rescaleSlope(1.0)
+    , m_rescaleIntercept(0.0)
 {
 }
 
@@ -115,6 +120,12 @@ void ImageProcessingPipeline::setBitsStored(int bitsStored)
     m_bitsStored = bitsStored;
 }
 
+void ImageProcessingPipeline::setRescale(double slope, double intercept)
+{
+    m_rescaleSlope = (slope != 0.0) ? slope : 1.0;
+    m_rescaleIntercept = intercept;
+}
+
 void ImageProcessingPipeline::resetAllTransformations()
 {
     m_hFlipEnabled = false;
@@ -136,17 +147,95 @@ QImage ImageProcessingPipeline::processImage(const QImage& sourceImage) const
     if (sourceImage.isNull()) {
         return QImage(); // Pass through null images
     }
-
     
-    // Pipeline: Decompressed Image ? Window/Level ? H-Flip ? V-Flip ? Invert ? Display
+    // Colour input (RGB/YBR photometric) keeps its colour: run the individual stages
+    if (sourceImage.format() != QImage::Format_Grayscale8) {
+        QImage result = windowLevelStage(sourceImage);
+        result = horizontalFlipStage(result);
+        result = verticalFlipStage(result);
+        result = invertStage(result);
+        return result;
+    }
+    
+    // Pipeline: Decompressed Image ? [Window/Level + Invert LUT, H-Flip/V-Flip remap] ? Display
     // Note: Decompression already handled by DCMTK/GDCM/libjpeg libraries
-    QImage result = sourceImage;
-    result = windowLevelStage(result);
-    result = horizontalFlipStage(result);
-    result = verticalFlipStage(result);
-    result = invertStage(result);
+    WindowLevelEngine::Parameters params = grayscale8WindowParameters();
+    params.invert = m_invertEnabled;
+    m_windowLevelEngine.setParameters(params);
     
-    return result;
+    // H-Flip mirrors rows and V-Flip mirrors columns, matching the stage functions
+    if (!m_windowLevelEngine.apply(sourceImage.constBits(), sourceImage.bytesPerLine(), 1,
+                                   sourceImage.width(), sourceImage.height(),
+                                   m_outputBuffer, m_hFlipEnabled, m_vFlipEnabled)) {
+        return QImage();
+    }
+    return m_outputBuffer;
+}
+
+QImage ImageProcessingPipeline::processFrame(const DicomPixelFrame& frame) const
+{
+    if (frame.isNull() || frame.samplesPerPixel != 1) {
+        return QImage();
+    }
+    
+    // Pipeline: Native Frame ? [Window/Level + Invert LUT, H-Flip/V-Flip remap] ? Display
+    WindowLevelEngine::Parameters params = frameWindowParameters(frame);
+    params.invert = (frame.monochrome1 != m_invertEnabled);
+    m_windowLevelEngine.setParameters(params);
+    
+    if (!m_windowLevelEngine.apply(frame, m_outputBuffer, m_hFlipEnabled, m_vFlipEnabled)) {
+        return QImage();
+    }
+    return m_outputBuffer;
+}
+
+WindowLevelEngine::Parameters ImageProcessingPipeline::frameWindowParameters(const DicomPixelFrame& frame) const
+{
+    const int bits = qBound(1, frame.bitsStored, 16);
+    
+    WindowLevelEngine::Parameters params;
+    params.bitsStored = bits;
+    params.isSigned = frame.isSigned;
+    params.invert = frame.monochrome1;
+    if (m_windowLevelEnabled) {
+        params.slope = frame.rescaleSlope;
+        params.intercept = frame.rescaleIntercept;
+        params.center = m_windowCenter;
+        params.width = m_windowWidth;
+    } else {
+        // No window: show the full stored range, as the 8-bit decode did
+        const qint32 minStored = frame.isSigned ? -(1 << (bits - 1)) : 0;
+        const qint32 maxStored = frame.isSigned ? (1 << (bits - 1)) - 1 : (1 << bits) - 1;
+        params.width = static_cast<double>(maxStored - minStored) + 1.0;
+        params.center = minStored + params.width / 2.0;
+    }
+    return params;
+}
+
+WindowLevelEngine::Parameters ImageProcessingPipeline::grayscale8WindowParameters() const
+{
+    WindowLevelEngine::Parameters params;
+    params.bitsStored = 8;
+    
+    if (!m_windowLevelEnabled) {
+        // Identity map: scale 1, offset 0
+        params.center = 127.5;
+        params.width = 255.0;
+        return params;
+    }
+    
+    // Window values are in modality units. DCMTK's getOutputData(8) mapped the
+    // stored range to 0-255, so bring the window into that 8-bit range first.
+    double storedCenter = (m_windowCenter - m_rescaleIntercept) / m_rescaleSlope;
+    double storedWidth = m_windowWidth / m_rescaleSlope;
+    double scaleFactor = 1.0;
+    if (m_bitsStored > 8) {
+        double maxOriginalValue = (1 << m_bitsStored) - 1;  // e.g., 16383 for 14-bit
+        scaleFactor = 255.0 / maxOriginalValue;             // e.g., 255/16383 ≈ 0.0156
+    }
+    params.center = storedCenter * scaleFactor;
+    params.width = storedWidth * scaleFactor;
+    return params;
 }
 
 QImage ImageProcessingPipeline::horizontalFlipStage(const QImage& input) const
@@ -186,58 +275,17 @@ QImage ImageProcessingPipeline::windowLevelStage(const QImage& input) const
         return input; // Pass through unchanged if disabled
     }
     
+    m_windowLevelEngine.setParameters(grayscale8WindowParameters());
     
-    // Apply window/level transformation
-    double minValue = m_windowCenter - (m_windowWidth / 2.0);
-    double maxValue = m_windowCenter + (m_windowWidth / 2.0);
-    
-    
-    QImage result = input.convertToFormat(QImage::Format_RGB32);
-    
-    // Sample some pixels to debug pixel value range
-    static bool debugSampled = false;
-    if (!debugSampled) {
-        debugSampled = true;
-        for (int y = 0; y < qMin(result.height(), 10); y += 2) {
-            const QRgb* scanLine = reinterpret_cast<const QRgb*>(result.constScanLine(y));
-            for (int x = 0; x < qMin(result.width(), 10); x += 2) {
-                QRgb pixel = scanLine[x];
-                int gray = qGray(pixel);
-                double maxPixelValue = (1 << m_bitsStored) - 1;
-                double originalPixelValue = (gray / 255.0) * maxPixelValue;
-            }
-        }
-    }
+    // DCMTK has already converted from original bit depth to 8 bits per sample.
+    // Grayscale stays single-channel; colour is windowed per channel.
+    const QImage source = (input.format() == QImage::Format_Grayscale8 || input.format() == QImage::Format_RGB888)
+        ? input : input.convertToFormat(QImage::Format_RGB888);
+    const int samplesPerRow = source.width() * (source.format() == QImage::Format_RGB888 ? 3 : 1);
     
-    for (int y = 0; y < result.height(); ++y) {
-        QRgb* scanLine = reinterpret_cast<QRgb*>(result.scanLine(y));
-        for (int x = 0; x < result.width(); ++x) {
-            QRgb pixel = scanLine[x];
-            
-            // Get the grayscale value from the 8-bit image (0-255)
-            // DCMTK has already converted from original bit depth to 8-bit
-            // We should apply windowing directly to this 8-bit data
-            int pixelValue = qGray(pixel);
-            
-            // Apply window/level algorithm directly to 8-bit data
-            double windowedValue;
-            if (m_windowWidth > 1) {  // Minimum meaningful width
-                if (pixelValue <= minValue) {
-                    windowedValue = 0.0;
-                } else if (pixelValue >= maxValue) {
-                    windowedValue = 255.0;
-                } else {
-                    // Scale within window range to 0-255
-                    windowedValue = ((pixelValue - minValue) / m_windowWidth) * 255.0;
-                }
-            } else {
-                // If width too small, use mid-gray
-                windowedValue = 128.0;
-            }
-            
-            int newGray = qBound(0, static_cast<int>(windowedValue), 255);
-            scanLine[x] = qRgb(newGray, newGray, newGray);
-        }
+    QImage result(source.width(), source.height(), source.format());
+    for (int y = 0; y < source.height(); ++y) {
+        m_windowLevelEngine.applyRow(source.constScanLine(y), 1, result.scanLine(y), samplesPerRow);
     }
     
     return result;
@@ -268,6 +316,8 @@ DicomViewer::DicomViewer(QWidget *parent, const QString& sourceDrive)
     , m_completedThumbnails(0)
     , m_totalThumbnails(0)
     , m_activeThumbnailTasks(0)
+    , m_thumbnailFlushScheduled(false)
+    , m_reportRequestId(0)
     , m_mainStack(nullptr)
     , m_imageWidget(nullptr)
     , m_reportArea(nullptr)
@@ -286,9 +336,8 @@ DicomViewer::DicomViewer(QWidget *parent, const QString& sourceDrive)
     , m_playbackPausedForFrame(false)
     , m_playbackTimer(nullptr)
     , m_progressiveLoader(nullptr)
-    , m_frameProcessor(nullptr)
     , m_isLoadingProgressively(false)
-    , m_allFramesCached(false)
+    , m_initialWindowLoaded(false)
     , m_progressiveTimer(nullptr)
     , m_lastProgressiveDisplayTime(0)
     , m_targetProgressiveFPS(15) // Increased from 7 to match GDCM performance capabilities
@@ -314,9 +363,10 @@ DicomViewer::DicomViewer(QWidget *parent, const QString& sourceDrive)
     , m_dicomReader(nullptr)
     , m_dicomInfoVisible(false)
     , m_dicomInfoWidget(nullptr)
-    , m_dicomInfoTextEdit(nullptr)
-    , m_cachedDicomInfoFilePath()
-    , m_cachedDicomInfoHtml()
+    , m_dicomInfoView(nullptr)
+    , m_dicomInfoMessage(nullptr)
+    , m_dicomTagModel(nullptr)
+    , m_dicomInfoRequestId(0)
     , m_copyProgressTimer(nullptr)
     , m_copyInProgress(false)
     , m_currentCopyProgress(0)
@@ -354,11 +404,21 @@ DicomViewer::DicomViewer(QWidget *parent, const QString& sourceDrive)
     // Initialize DICOM reader
     m_dicomReader = new DicomReader();
     
+    // Thumbnails and frame counts of files seen in earlier sessions
+    if (m_thumbnailCache.open(DicomThumbnailCache::defaultCacheFilePath())) {
+        m_dicomReader->setThumbnailCache(&m_thumbnailCache);
+    }
+    
 #ifdef HAVE_DCMTK
-    // Register JPEG decompression codecs for compressed DICOM images
+    // Register JPEG and RLE decompression codecs for compressed DICOM images
     DJDecoderRegistration::registerCodecs();
+    DcmRLEDecoderRegistration::registerCodecs();
 #endif
     
+    // Thumbnail tasks decode independently, one per core, below the GUI and frame decoders
+    m_thumbnailPool.setMaxThreadCount(QThread::idealThreadCount());
+    m_thumbnailPool.setThreadPriority(QThread::LowPriority);
+    
     // Create timer
     m_playbackTimer = new QTimer(this);
     connect(m_playbackTimer, &QTimer::timeout, this, &DicomViewer::nextFrame);
@@ -376,8 +436,8 @@ DicomViewer::DicomViewer(QWidget *parent, const QString& sourceDrive)
     m_localDestPath = PathNormalizer::getCanonicalDestPath();
     logMessage(LOG_INFO, QString("PathNormalizer: Canonical destination path initialized: %1").arg(m_localDestPath));
     
-    // Initialize frame processor
-    m_frameProcessor = new DicomFrameProcessor();
+    // Frame store shared with the loader
+    m_frameStore = std::make_shared<DicomFrameStore>();
     
     // Create proper central widget with layout
     m_centralWidget = new QWidget;
@@ -500,46 +560,13 @@ DicomViewer::DicomViewer(QWidget *parent, const QString& sourceDrive)
     }
 
     // Step 2.5: Create DICOM Info Panel (between tree and main content like Python version)
-    m_dicomInfoWidget = new QFrame;
-    m_dicomInfoWidget->setObjectName("dicom_info_panel"); 
-    m_dicomInfoWidget->setFixedWidth(400);  // Same as Python version
-    m_dicomInfoWidget->setStyleSheet("QFrame#dicom_info_panel { background-color: #2a2a2a; border-right: 1px solid #666; }");
-    m_dicomInfoWidget->hide();  // Initially hidden like Python
-    
-    QVBoxLayout* dicomInfoLayout = new QVBoxLayout(m_dicomInfoWidget);
-    dicomInfoLayout->setContentsMargins(0, 0, 0, 0);
-    dicomInfoLayout->setSpacing(0);
-    
-    // Header with title (like Python)
-    QVBoxLayout* headerLayout = new QVBoxLayout;
-    headerLayout->setContentsMargins(5, 5, 5, 5);
-    
-    QLabel* titleLabel = new QLabel("DICOM Tags");
-    titleLabel->setStyleSheet("color: white; font-weight: bold; font-size: 14px; padding: 5px;");
-    headerLayout->addWidget(titleLabel);
-    
-    dicomInfoLayout->addLayout(headerLayout);
-    
-    // DICOM info text area
-    m_dicomInfoTextEdit = new QTextEdit;
-    m_dicomInfoTextEdit->setObjectName("dicom_info_text");
-    m_dicomInfoTextEdit->setReadOnly(true);
-    m_dicomInfoTextEdit->setStyleSheet(R"(
-        QTextEdit {
-            background-color: #2b2b2b;
-            color: white;
-            border: 1px solid #666666;
-            padding: 2px;
-            selection-background-color: #0078d4;
-        }
-    )");
-    dicomInfoLayout->addWidget(m_dicomInfoTextEdit);
+    createDicomInfoPanel();
     
     // Add DICOM info widget to main layout
     mainLayout->addWidget(m_dicomInfoWidget);
     
     // Debug: Confirm widget creation
-    logMessage(LOG_DEBUG, QString("[DICOM INFO] DICOM info widget created successfully in constructor. Widget pointer: %1").arg(reinterpret_cast<quintptr>(m_dicomInfoWidget)));
+    LOG_AT(LOG_DEBUG, QString("[DICOM INFO] DICOM info widget created successfully in constructor. Widget pointer: %1").arg(reinterpret_cast<quintptr>(m_dicomInfoWidget)));
     
     // Step 3: Main content area with stacked widget
     m_mainStack = new QStackedWidget;
@@ -641,6 +668,10 @@ DicomViewer::~DicomViewer()
         m_playbackTimer->stop();
     }
     
+    // Drop queued thumbnail tasks and let running ones finish before members go away
+    m_thumbnailPool.clear();
+    m_thumbnailPool.waitForDone();
+    
     // Stop and clean up progressive loader
     if (m_progressiveLoader) {
         m_progressiveLoader->stop();
@@ -655,13 +686,17 @@ DicomViewer::~DicomViewer()
     }
     
     delete m_dicomReader;
-    delete m_frameProcessor;
     delete m_imagePipeline;
     
 #ifdef HAVE_DCMTK
-    // Clean up JPEG decompression codecs
+    // Clean up JPEG and RLE decompression codecs
     DJDecoderRegistration::cleanup();
+    DcmRLEDecoderRegistration::cleanup();
 #endif
+    
+    logMessage("INFO", "DicomViewer application closed");
+    PerfTrace::shutdown();
+    AsyncLogger::instance().stop();
 }
 
 void DicomViewer::installEventFilters()
@@ -718,13 +753,13 @@ void DicomViewer::initializeDvdWorker()
             this, &DicomViewer::onCopyCompleted);
     connect(m_dvdWorker, &DvdCopyWorker::copyCompleted, 
             this, [this](bool success) {
-                logMessage("DEBUG", QString("*** LAMBDA: copyCompleted signal received with success: %1 ***").arg(success ? "true" : "false"));
+                LOG_AT(LOG_DEBUG, QString("*** LAMBDA: copyCompleted signal received with success: %1 ***").arg(success ? "true" : "false"));
             });
     connect(m_dvdWorker, &DvdCopyWorker::workerError, 
             this, &DicomViewer::onWorkerError);
     connect(m_dvdWorker, &DvdCopyWorker::statusChanged, 
             this, [this](const QString& status) {
-                logMessage("DEBUG", QString("DVD Worker Status: %1").arg(status));
+                LOG_AT(LOG_DEBUG, QString("DVD Worker Status: %1").arg(status));
             });
     connect(m_dvdWorker, &DvdCopyWorker::fileCompleted,
             this, &DicomViewer::onFileReadyForThumbnail);
@@ -733,7 +768,7 @@ void DicomViewer::initializeDvdWorker()
     bool seqConnected = connect(this, &DicomViewer::requestSequentialRobocopyStart,
                                m_dvdWorker, &DvdCopyWorker::startSequentialRobocopy,
                                Qt::QueuedConnection);
-    logMessage(LOG_DEBUG, QString("[DVD WORKER] Sequential robocopy signal connection established: %1").arg(seqConnected ? "SUCCESS" : "FAILED"));
+    LOG_AT(LOG_DEBUG, QString("[DVD WORKER] Sequential robocopy signal connection established: %1").arg(seqConnected ? "SUCCESS" : "FAILED"));
     
     // Connect ffmpeg copy completion signal to slot
     connect(this, &DicomViewer::ffmpegCopyCompleted,
@@ -925,40 +960,7 @@ void DicomViewer::createCentralWidget()
     mainLayout->addWidget(m_leftSidebar);
     
     // Create DICOM Info Panel (like Python version - between tree and main content)
-    m_dicomInfoWidget = new QFrame;
-    m_dicomInfoWidget->setObjectName("dicom_info_panel"); 
-    m_dicomInfoWidget->setFixedWidth(400);  // Same as Python version
-    m_dicomInfoWidget->setStyleSheet("QFrame#dicom_info_panel { background-color: #2a2a2a; border-right: 1px solid #666; }");
-    m_dicomInfoWidget->hide();  // Initially hidden like Python
-    
-    QVBoxLayout* dicomInfoLayout = new QVBoxLayout(m_dicomInfoWidget);
-    dicomInfoLayout->setContentsMargins(0, 0, 0, 0);
-    dicomInfoLayout->setSpacing(0);
-    
-    // Header with title (like Python)
-    QVBoxLayout* headerLayout = new QVBoxLayout;
-    headerLayout->setContentsMargins(5, 5, 5, 5);
-    
-    QLabel* titleLabel = new QLabel("DICOM Tags");
-    titleLabel->setStyleSheet("color: white; font-weight: bold; font-size: 14px; padding: 5px;");
-    headerLayout->addWidget(titleLabel);
-    
-    dicomInfoLayout->addLayout(headerLayout);
-    
-    // DICOM info text area
-    m_dicomInfoTextEdit = new QTextEdit;
-    m_dicomInfoTextEdit->setObjectName("dicom_info_text");
-    m_dicomInfoTextEdit->setReadOnly(true);
-    m_dicomInfoTextEdit->setStyleSheet(R"(
-        QTextEdit {
-            background-color: #2b2b2b;
-            color: white;
-            border: 1px solid #666666;
-            padding: 2px;
-            selection-background-color: #0078d4;
-        }
-    )");
-    dicomInfoLayout->addWidget(m_dicomInfoTextEdit);
+    createDicomInfoPanel();
     
     mainLayout->addWidget(m_dicomInfoWidget);
     
@@ -1287,7 +1289,7 @@ void DicomViewer::nextFrame()
     
     // Don't stop playback when advancing frames during playback (Python behavior)
     bool wasPlaying = m_isPlaying;
-    if (m_isPlaying && !m_allFramesCached) {
+    if (m_isPlaying && !m_initialWindowLoaded) {
         if (m_playbackTimer) {
             m_playbackTimer->stop();
         }
@@ -1298,18 +1300,14 @@ void DicomViewer::nextFrame()
     m_currentFrame = (m_currentFrame + 1) % m_totalFrames;
     
     // Use cached frame if available (Python behavior)
-    if (m_frameCache.contains(m_currentFrame)) {
+    if (isFrameAvailable(m_currentFrame)) {
         displayCachedFrame(m_currentFrame);
     } else {
-        // Go back to previous frame if next isn't ready (Python behavior)
-        m_currentFrame = (m_currentFrame - 1 + m_totalFrames) % m_totalFrames;
-        if (m_frameCache.contains(m_currentFrame)) {
-            displayCachedFrame(m_currentFrame);
-        }
+        showFramePending(m_currentFrame);
     }
     
     // Resume playback if it was active before (Python behavior)
-    if (wasPlaying && m_allFramesCached) {
+    if (wasPlaying && m_initialWindowLoaded) {
         if (m_playbackTimer) {
             m_playbackTimer->start();
     }
@@ -1329,7 +1327,7 @@ void DicomViewer::automaticNextFrame()
     int nextFrame = (m_currentFrame + 1) % m_totalFrames;
     
     // Use cached frame if available
-    if (m_frameCache.contains(nextFrame)) {
+    if (isFrameAvailable(nextFrame)) {
         m_currentFrame = nextFrame;
         displayCachedFrame(m_currentFrame);
         m_playbackPausedForFrame = false;  // Clear pause flag if we can continue
@@ -1342,6 +1340,7 @@ void DicomViewer::automaticNextFrame()
         // Frame not ready yet - remember we're waiting but keep timer running
         // This allows continuous looping once frames are loaded
         m_playbackPausedForFrame = true;
+        reportPlayhead(nextFrame);
     }
     
     // Ensure continuous playback - the modulo operation above already handles looping
@@ -1367,40 +1366,17 @@ void DicomViewer::previousFrame()
     
     int prevFrame = (m_currentFrame - 1 + m_totalFrames) % m_totalFrames;
     
-    // Try DicomFrameProcessor first for direct frame loading
-    if (m_frameProcessor && !m_currentImagePath.isEmpty()) {
-        QImage frameImage = m_frameProcessor->getFrameAsQImage(prevFrame);
-        if (!frameImage.isNull()) {
-            m_currentFrame = prevFrame;
-            m_currentPixmap = QPixmap::fromImage(frameImage);
-            m_originalPixmap = m_currentPixmap;  // Store the original unmodified pixmap
-            updateImageDisplay();
-            updateOverlayInfo();
-            return;
-        }
-    }
-    
-    // Fallback to cached frame system
-    if (m_allFramesCached || m_frameCache.contains(prevFrame)) {
+    // Frames come from the store; the loader decodes a missing one next
+    if (isFrameAvailable(prevFrame)) {
         displayCachedFrame(prevFrame);
     } else {
-        // If frames are still loading, only go back if the frame is cached
-    if (m_frameCache.contains(prevFrame)) {
-        displayCachedFrame(prevFrame);
-        } else {
-            // Go forward to next frame if previous isn't ready
-            int nextFrame = (m_currentFrame + 1) % m_totalFrames;
-            if (m_frameCache.contains(nextFrame)) {
-                displayCachedFrame(nextFrame);
-    }
-}
+        showFramePending(prevFrame);
     }
-
 }
 
 void DicomViewer::togglePlayback()
 {
-    logMessage(LOG_DEBUG, "[USER ACTION] Toggle playback requested");
+    LOG_AT(LOG_DEBUG, "[USER ACTION] Toggle playback requested");
     // Use professional framework for playback control
     if (m_playbackController) {
         m_playbackController->togglePlayback();
@@ -1422,7 +1398,7 @@ void DicomViewer::togglePlayback()
             updatePlayButtonIcon("Play_96.png");
         } else {
             // Start playback: either for cached frames or during progressive loading
-            bool allFramesReady = !m_isLoadingProgressively && m_allFramesCached;
+            bool allFramesReady = !m_isLoadingProgressively && m_initialWindowLoaded;
             bool canStartDuringLoading = m_isLoadingProgressively && m_totalFrames > 1;
             
             if (allFramesReady || canStartDuringLoading) {
@@ -1595,7 +1571,7 @@ void DicomViewer::showWindowLevelDialog()
 
 void DicomViewer::zoomIn()
 {
-    logMessage(LOG_DEBUG, "[USER ACTION] Zoom in requested");
+    LOG_AT(LOG_DEBUG, "[USER ACTION] Zoom in requested");
     if (m_graphicsView && m_zoomFactor < m_maxZoomFactor) {
         m_zoomFactor *= m_zoomIncrement;
         m_graphicsView->scale(m_zoomIncrement, m_zoomIncrement);
@@ -1605,7 +1581,7 @@ void DicomViewer::zoomIn()
 
 void DicomViewer::zoomOut()
 {
-    logMessage(LOG_DEBUG, "[USER ACTION] Zoom out requested");
+    LOG_AT(LOG_DEBUG, "[USER ACTION] Zoom out requested");
     if (m_graphicsView && m_zoomFactor > m_minZoomFactor) {
         m_zoomFactor /= m_zoomIncrement;
         m_graphicsView->scale(1.0 / m_zoomIncrement, 1.0 / m_zoomIncrement);
@@ -1712,7 +1688,7 @@ void DicomViewer::onThumbnailItemSelected(QListWidgetItem* current, QListWidgetI
             // Queue the selection instead of processing immediately
             QMutexLocker pendingLocker(&m_pendingSelectionsMutex);
             m_pendingSelections.enqueue(filePath);
-            logMessage(LOG_DEBUG, QString("Queued thumbnail selection during generation: %1").arg(filePath));
+            LOG_AT(LOG_DEBUG, QString("Queued thumbnail selection during generation: %1").arg(filePath));
             return;
         }
         
@@ -1720,64 +1696,25 @@ void DicomViewer::onThumbnailItemSelected(QListWidgetItem* current, QListWidgetI
         {
             QString canonicalPath = getCanonicalPath(filePath);
             if (m_copyInProgress && !QFile::exists(canonicalPath)) {
-                logMessage(LOG_DEBUG, QString("File not ready for selection: %1").arg(QFileInfo(filePath).fileName()));
+                LOG_AT(LOG_DEBUG, QString("File not ready for selection: %1").arg(QFileInfo(filePath).fileName()));
                 return;
             }
         }
         
-        logMessage(LOG_DEBUG, QString("[THUMBNAIL] Selected thumbnail with path: %1").arg(filePath));
-        logMessage(LOG_DEBUG, QString("[THUMBNAIL] Thumbnail selection - File path: %1").arg(filePath));
-        logMessage(LOG_DEBUG, QString("[THUMBNAIL] Copy in progress: %1").arg(m_copyInProgress ? "true" : "false"));
+        LOG_AT(LOG_DEBUG, QString("[THUMBNAIL] Selected thumbnail with path: %1").arg(filePath));
+        LOG_AT(LOG_DEBUG, QString("[THUMBNAIL] Thumbnail selection - File path: %1").arg(filePath));
+        LOG_AT(LOG_DEBUG, QString("[THUMBNAIL] Copy in progress: %1").arg(m_copyInProgress ? "true" : "false"));
         
         // Use display monitor instead of direct display
         requestDisplay(filePath);
         
-        // Find and select the corresponding tree item
-        if (m_dicomTree) {
-            bool foundMatch = false;
-            QTreeWidgetItemIterator it(m_dicomTree);
-            while (*it) {
-                QVariantList userData = (*it)->data(0, Qt::UserRole).toList();
-                if (userData.size() >= 2) {
-                    QString itemType = userData[0].toString();
-                    QString itemPath = userData[1].toString();
-                    // CRITICAL FIX: Use defensive path comparison to handle short vs long path formats
-                    if ((itemType == "image" || itemType == "report") && pathsAreEquivalent(itemPath, filePath)) {
-                        logMessage(LOG_DEBUG, QString("[THUMBNAIL] Found matching tree item for path: %1").arg(filePath));
-                        logMessage(LOG_DEBUG, QString("[THUMBNAIL] Path match found - Tree path: %1").arg(itemPath));
-                        m_dicomTree->setCurrentItem(*it);
-                        foundMatch = true;
-                        break;
-                    }
-                }
-                ++it;
-            }
-            
-            if (!foundMatch) {
+        // Find and select the corresponding tree item (matched by file name, so short/long path forms agree)
+        if (m_dicomTree && m_dicomReader) {
+            if (QTreeWidgetItem* treeItem = m_dicomReader->findTreeItem(filePath)) {
+                LOG_AT(LOG_DEBUG, QString("[THUMBNAIL] Found matching tree item for path: %1").arg(filePath));
+                m_dicomTree->setCurrentItem(treeItem);
+            } else {
                 logMessage(LOG_WARN, QString("[THUMBNAIL] WARNING: No matching tree item found for thumbnail path: %1").arg(filePath));
-                logMessage(LOG_WARN, "[THUMBNAIL] This indicates a path mismatch between thumbnails and tree items");
-                
-                // Try to find a tree item with the same filename but different path
-                QString fileName = QFileInfo(filePath).fileName();
-                QTreeWidgetItemIterator it2(m_dicomTree);
-                while (*it2) {
-                    QVariantList userData = (*it2)->data(0, Qt::UserRole).toList();
-                    if (userData.size() >= 2) {
-                        QString itemType = userData[0].toString();
-                        QString itemPath = userData[1].toString();
-                        QString treeFileName = QFileInfo(itemPath).fileName();
-                        if ((itemType == "image" || itemType == "report") && treeFileName == fileName) {
-                            logMessage(LOG_DEBUG, "[THUMBNAIL] Found tree item with same filename but different path:");
-                            logMessage(LOG_DEBUG, QString("[THUMBNAIL]   Thumbnail path: %1").arg(filePath));
-                            logMessage(LOG_DEBUG, QString("[THUMBNAIL]   Tree item path: %1").arg(itemPath));
-                            logMessage(LOG_DEBUG, "[THUMBNAIL] Selecting tree item with local path");
-                            logMessage(LOG_DEBUG, QString("[THUMBNAIL] Fallback match - Thumbnail: %1 Tree: %2").arg(filePath, itemPath));
-                            m_dicomTree->setCurrentItem(*it2);
-                            break;
-                        }
-                    }
-                    ++it2;
-                }
             }
         }
         
@@ -1791,7 +1728,7 @@ void DicomViewer::updateThumbnailPanel()
 {
     // Prevent recursive thumbnail panel updates
     if (m_thumbnailPanelProcessingActive) {
-        logMessage("DEBUG", "[THUMBNAIL PANEL] Already processing - ignoring update request");
+        LOG_AT(LOG_DEBUG, "[THUMBNAIL PANEL] Already processing - ignoring update request");
         return;
     }
     
@@ -1802,13 +1739,13 @@ void DicomViewer::updateThumbnailPanel()
     
     // Prevent updating thumbnails if already in progress
     if (m_thumbnailGenerationActive) {
-        logMessage("DEBUG", "Thumbnail generation already in progress - skipping update");
+        LOG_AT(LOG_DEBUG, "Thumbnail generation already in progress - skipping update");
         return;
     }
     
     // Only create thumbnails if ALL files exist on disk
     if (!areAllFilesComplete()) {
-        logMessage("DEBUG", "[THUMBNAIL PANEL] Delaying thumbnail creation - not all files exist yet");
+        LOG_AT(LOG_DEBUG, "[THUMBNAIL PANEL] Delaying thumbnail creation - not all files exist yet");
         return;
     }
     
@@ -1820,7 +1757,7 @@ void DicomViewer::updateThumbnailPanel()
         m_thumbnailPanelProcessingActive = false;
     });
     
-    logMessage("DEBUG", "[THUMBNAIL PANEL] Updating thumbnail panel...");
+    LOG_AT(LOG_DEBUG, "[THUMBNAIL PANEL] Updating thumbnail panel...");
     
     // Clear existing thumbnails and reset counters
     m_thumbnailList->clear();
@@ -1871,20 +1808,29 @@ void DicomViewer::updateThumbnailPanel()
         ++it;
     }
     
+    // Thumbnails of unchanged files come straight from the persistent cache
+    QList<QPair<QString, DicomThumbnailCache::Entry>> cachedThumbnails;
+    
     // Add items grouped by patient in tree order
     for (const QString& patientName : patientOrder) {
         if (!patientGroups.contains(patientName)) continue;
         
         QList<QPair<QString, QString>> patientFiles = patientGroups[patientName];
         
-        logMessage("DEBUG", QString("Creating thumbnails for patient: %1 with %2 files").arg(patientName).arg(patientFiles.size()));
+        LOG_AT(LOG_DEBUG, QString("Creating thumbnails for patient: %1 with %2 files").arg(patientName).arg(patientFiles.size()));
         
         // Add thumbnails for this patient with embedded patient name
         for (const auto& filePair : patientFiles) {
             QString filePath = filePair.first;
             QString itemType = filePair.second;
             
-            m_pendingThumbnailPaths.append(filePath);
+            DicomThumbnailCache::Entry cached;
+            if (m_thumbnailCache.lookup(filePath, m_dicomReader->getImageInfoForFile(filePath).sopInstanceUID, cached) &&
+                !cached.thumbnail.isNull()) {
+                cachedThumbnails.append(qMakePair(filePath, cached));
+            } else {
+                m_pendingThumbnailPaths.append(filePath);
+            }
             m_totalThumbnails++;
             
             // Create placeholder thumbnail item
@@ -1903,10 +1849,16 @@ void DicomViewer::updateThumbnailPanel()
         }
     }
     
-    logMessage("DEBUG", QString("Found %1 images for thumbnail generation").arg(m_totalThumbnails));
+    LOG_AT(LOG_DEBUG, QString("Found %1 images for thumbnail generation, %2 served from cache")
+               .arg(int(m_totalThumbnails)).arg(cachedThumbnails.size()));
+    
+    for (const auto& cached : cachedThumbnails) {
+        onThumbnailGeneratedWithMetadata(cached.first, QPixmap::fromImage(cached.second.thumbnail),
+                                         cached.second.instanceNumber);
+    }
     
-    // Start background thumbnail generation if we have images
-    if (m_totalThumbnails > 0) {
+    // Start background thumbnail generation for the files the cache could not serve
+    if (!m_pendingThumbnailPaths.isEmpty()) {
         m_allThumbnailsComplete = false;  // Reset completion flag when starting generation
         updateStatusBar(QString("Generating thumbnails... (0/%1)").arg(m_totalThumbnails), 0);
         generateThumbnailsInBackground();
@@ -1921,7 +1873,7 @@ void DicomViewer::generateThumbnailsInBackground()
 {
     // Check if generation already active
     if (!m_thumbnailGenerationActive.testAndSetAcquire(0, 1)) {
-        logMessage("DEBUG", "Thumbnail generation already active - skipping");
+        LOG_AT(LOG_DEBUG, "Thumbnail generation already active - skipping");
         return;
     }
     
@@ -1931,46 +1883,79 @@ void DicomViewer::generateThumbnailsInBackground()
     m_activeThumbnailTasks = m_pendingThumbnailPaths.size();
     updateStatusBar(QString("Generating thumbnails... (0/%1)").arg(int(m_totalThumbnails)), 0);
     
-    logMessage("DEBUG", QString("Starting parallel thumbnail generation for %1 files using QThreadPool").arg(int(m_totalThumbnails)));
+    LOG_AT(LOG_DEBUG, QString("Starting parallel thumbnail generation for %1 files using QThreadPool").arg(int(m_totalThumbnails)));
     
     // Submit each thumbnail as a separate task to the thread pool
     for (const QString& filePath : m_pendingThumbnailPaths) {
-        ThumbnailTask* task = new ThumbnailTask(filePath, this);
+        bool fileReady = !m_copyInProgress ||
+                         (QFile::exists(filePath) && m_fullyCompletedFiles.contains(QFileInfo(filePath).fileName()));
+        // Tasks must not touch widgets, so the item type is resolved here on the GUI thread
+        QString itemType = m_dicomReader->treeItemType(filePath);
+        ThumbnailTask* task = new ThumbnailTask(filePath, itemType.isEmpty() ? QString("image") : itemType, fileReady, this);
         
         // Connect task completion signal to our slot with queued connection for thread safety
         connect(task, &ThumbnailTask::taskCompleted, 
                 this, &DicomViewer::onThumbnailTaskCompleted, 
                 Qt::QueuedConnection);
         
-        // Submit task to global thread pool for parallel execution
-        QThreadPool::globalInstance()->start(task);
+        // Submit task to the thumbnail pool for parallel execution
+        m_thumbnailPool.start(task);
     }
     
-    logMessage("DEBUG", QString("Submitted %1 thumbnail tasks to thread pool (max threads: %2)")
+    LOG_AT(LOG_DEBUG, QString("Submitted %1 thumbnail tasks to thread pool (max threads: %2)")
                .arg(m_pendingThumbnailPaths.size())
-               .arg(QThreadPool::globalInstance()->maxThreadCount()));
+               .arg(m_thumbnailPool.maxThreadCount()));
 }
 
-void DicomViewer::onThumbnailTaskCompleted(const QString& filePath, const QPixmap& thumbnail, const QString& instanceNumber)
+void DicomViewer::onThumbnailTaskCompleted(const QString& filePath, const QImage& thumbnail,
+                                           const QString& instanceNumber, int frameCount)
 {
-    // Call the existing thumbnail completion handler
-    onThumbnailGeneratedWithMetadata(filePath, thumbnail, instanceNumber);
-    
-    // Thread-safe decrement of active tasks counter
-    int remainingTasks = --m_activeThumbnailTasks;
-    
-    logMessage("DEBUG", QString("Thumbnail task completed for: %1, remaining tasks: %2")
-               .arg(QFileInfo(filePath).baseName()).arg(remainingTasks));
+    // Queue the result; all thumbnails that arrive during this event-loop pass
+    // are converted and applied together
+    m_completedThumbnailQueue.append({filePath, thumbnail, instanceNumber, frameCount});
+    if (!m_thumbnailFlushScheduled) {
+        m_thumbnailFlushScheduled = true;
+        QTimer::singleShot(0, this, &DicomViewer::flushCompletedThumbnails);
+    }
+}
+
+void DicomViewer::flushCompletedThumbnails()
+{
+    m_thumbnailFlushScheduled = false;
+    QVector<CompletedThumbnail> completed;
+    completed.swap(m_completedThumbnailQueue);
     
-    // Check if all tasks are complete
-    if (remainingTasks == 0) {
-        logMessage("DEBUG", "All thumbnail tasks completed - triggering completion handler");
+    for (const CompletedThumbnail& result : completed) {
+        // Workers only produce QImages; the pixmap is created here on the GUI thread
+        QPixmap thumbnail = result.image.isNull() ? QPixmap() : QPixmap::fromImage(result.image);
+        onThumbnailGeneratedWithMetadata(result.filePath, thumbnail, result.instanceNumber);
+        
+        // Keep it for the next time this disc is opened
+        if (!result.image.isNull()) {
+            DicomThumbnailCache::Entry entry;
+            entry.sopInstanceUID = m_dicomReader->getImageInfoForFile(result.filePath).sopInstanceUID;
+            entry.filePath = result.filePath;
+            entry.frameCount = result.frameCount;
+            entry.instanceNumber = result.instanceNumber;
+            entry.thumbnail = result.image;
+            m_thumbnailCache.insert(entry);
+        }
+        
+        int remainingTasks = --m_activeThumbnailTasks;
         
-        // Reset active flag  
-        m_thumbnailGenerationActive = 0;
+        LOG_AT(LOG_DEBUG, QString("Thumbnail task completed for: %1, remaining tasks: %2")
+                   .arg(QFileInfo(result.filePath).baseName()).arg(remainingTasks));
         
-        // Trigger completion
-        onAllThumbnailsGenerated();
+        // Check if all tasks are complete
+        if (remainingTasks == 0) {
+            LOG_AT(LOG_DEBUG, "All thumbnail tasks completed - triggering completion handler");
+            
+            // Reset active flag  
+            m_thumbnailGenerationActive = 0;
+            
+            // Trigger completion
+            onAllThumbnailsGenerated();
+        }
     }
 }
 
@@ -1981,12 +1966,12 @@ void DicomViewer::checkAndShowThumbnailPanel()
     if (m_allThumbnailsComplete && !m_copyInProgress) {
         if (m_thumbnailPanel) {
             m_thumbnailPanel->setVisible(true);
-            logMessage("DEBUG", "Thumbnail panel shown - thumbnails complete and no copy in progress");
+            LOG_AT(LOG_DEBUG, "Thumbnail panel shown - thumbnails complete and no copy in progress");
         }
     } else {
         if (m_thumbnailPanel) {
             m_thumbnailPanel->setVisible(false);
-            logMessage("DEBUG", QString("Thumbnail panel hidden - thumbnailsComplete: %1, copyInProgress: %2")
+            LOG_AT(LOG_DEBUG, QString("Thumbnail panel hidden - thumbnailsComplete: %1, copyInProgress: %2")
                        .arg(m_allThumbnailsComplete).arg(m_copyInProgress));
         }
     }
@@ -2040,9 +2025,10 @@ QPixmap DicomViewer::createFrameTypeIcon(int frameCount)
     return icon;
 }
 
-QPixmap DicomViewer::createReportThumbnail(const QString& filePath)
+QImage DicomViewer::createReportThumbnail(const QString& filePath)
 {
-    QPixmap reportThumbnail(190, 150);
+    // Painted on thumbnail worker threads, so QImage rather than QPixmap
+    QImage reportThumbnail(190, 150, QImage::Format_ARGB32_Premultiplied);
     reportThumbnail.fill(QColor(42, 42, 42));
     
     QPainter painter(&reportThumbnail);
@@ -2069,18 +2055,17 @@ QPixmap DicomViewer::createReportThumbnail(const QString& filePath)
     QString reportType = "Structure Report";
     QString instanceNumber = "RPT";
     
-    // Try to extract more specific information from the file
+    // Try to extract more specific information from the file (header tags only)
     try {
-        DicomFrameProcessor tempProcessor;
-        if (tempProcessor.loadDicomFile(filePath)) {
-            // Get Instance Number from DICOM tag (0020,0013)
-            QString dicomInstanceNumber = tempProcessor.getDicomTagValue("0020,0013");
-            if (!dicomInstanceNumber.isEmpty()) {
-                instanceNumber = dicomInstanceNumber;
+        DicomHeaderInfo header = DicomHeaderProbe::read(filePath);
+        if (header.valid) {
+            // Instance Number (0020,0013)
+            if (header.instanceNumber > 0) {
+                instanceNumber = QString::number(header.instanceNumber);
             }
             
-            // Try to get more specific report type from other tags if available
-            QString seriesDescription = tempProcessor.getDicomTagValue("0008,103E");
+            // Series Description (0008,103E) is a more specific report type
+            const QString seriesDescription = header.seriesDescription;
             if (!seriesDescription.isEmpty()) {
                 reportType = seriesDescription;
                 // Truncate if too long
@@ -2108,17 +2093,17 @@ QPixmap DicomViewer::createReportThumbnail(const QString& filePath)
     
     // Load and draw report/list icon at top-right
     QString iconPath = "DicomViewer_CPP/resources/icons/List.png";
-    QPixmap iconPixmap(iconPath);
-    if (iconPixmap.isNull()) {
+    QImage iconImage(iconPath);
+    if (iconImage.isNull()) {
         // Try absolute path if relative doesn't work
         QString absoluteIconPath = "d:/Repos/EikonDicomViewer/DicomViewer_CPP/resources/icons/List.png";
-        iconPixmap.load(absoluteIconPath);
+        iconImage.load(absoluteIconPath);
     }
     
-    if (!iconPixmap.isNull()) {
+    if (!iconImage.isNull()) {
         // Scale icon to proper size (16x16 for top overlay)
-        QPixmap scaledIcon = iconPixmap.scaled(16, 16, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        painter.drawPixmap(reportThumbnail.width() - 20, 2, scaledIcon);
+        QImage scaledIcon = iconImage.scaled(16, 16, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        painter.drawImage(reportThumbnail.width() - 20, 2, scaledIcon);
     } else {
         // Fallback: draw a simple text icon
         painter.setPen(QColor(100, 149, 237));
@@ -2192,7 +2177,7 @@ QListWidgetItem* DicomViewer::createPatientSeparator(const QString& patientName)
     m_thumbnailList->addItem(separatorItem);
     m_thumbnailList->setItemWidget(separatorItem, separatorWidget);
     
-    logMessage("DEBUG", QString("Created compact patient separator for: %1").arg(patientName));
+    LOG_AT(LOG_DEBUG, QString("Created compact patient separator for: %1").arg(patientName));
     
     return separatorItem;
     separatorItem->setFlags(Qt::ItemIsEnabled); // Not selectable
@@ -2217,7 +2202,7 @@ void DicomViewer::toggleThumbnailPanel()
         m_thumbnailPanel->setFixedWidth(220);  // Full width
     }
     
-    logMessage("DEBUG", QString("Thumbnail panel %1").arg(m_thumbnailPanelCollapsed ? "collapsed" : "expanded"));
+    LOG_AT(LOG_DEBUG, QString("Thumbnail panel %1").arg(m_thumbnailPanelCollapsed ? "collapsed" : "expanded"));
 }
 
 void DicomViewer::onTreeItemSelected(QTreeWidgetItem *current, QTreeWidgetItem *previous)
@@ -2227,7 +2212,7 @@ void DicomViewer::onTreeItemSelected(QTreeWidgetItem *current, QTreeWidgetItem *
         return;
     }
     
-    logMessage("DEBUG", QString("[USER ACTION] Tree item selected: %1 (Copy in progress: %2)").arg(current->text(0)).arg(m_copyInProgress));
+    LOG_AT(LOG_DEBUG, QString("[USER ACTION] Tree item selected: %1 (Copy in progress: %2)").arg(current->text(0)).arg(m_copyInProgress));
     
     // Extract file path and type from tree item
     QVariantList userData = current->data(0, Qt::UserRole).toList();
@@ -2253,7 +2238,7 @@ void DicomViewer::onTreeItemSelected(QTreeWidgetItem *current, QTreeWidgetItem *
         QString canonicalPath = getCanonicalPath(filePath);
         bool fileExists = QFile::exists(canonicalPath);
         
-        logMessage("DEBUG", QString("[USER CLICK DEBUG] Copy in progress - File: %1, Canonical: %2, Exists: %3")
+        LOG_AT(LOG_DEBUG, QString("[USER CLICK DEBUG] Copy in progress - File: %1, Canonical: %2, Exists: %3")
             .arg(QFileInfo(filePath).fileName())
             .arg(QFileInfo(canonicalPath).fileName())
             .arg(fileExists));
@@ -2265,7 +2250,7 @@ void DicomViewer::onTreeItemSelected(QTreeWidgetItem *current, QTreeWidgetItem *
             return;
         }
         
-        logMessage("DEBUG", QString("[USER CLICK ALLOWED] File is available during copy: %1")
+        LOG_AT(LOG_DEBUG, QString("[USER CLICK ALLOWED] File is available during copy: %1")
             .arg(QFileInfo(filePath).fileName()));
     }
     
@@ -2289,7 +2274,7 @@ void DicomViewer::onTreeItemSelected(QTreeWidgetItem *current, QTreeWidgetItem *
             // If thumbnails are not yet visible, store this selection to restore later
             if (!m_thumbnailPanel->isVisible()) {
                 m_pendingTreeSelection = filePath;  // Store original path for proper thumbnail matching
-                logMessage("DEBUG", QString("Storing pending selection (thumbnails not ready): %1").arg(QFileInfo(filePath).fileName()));
+                LOG_AT(LOG_DEBUG, QString("Storing pending selection (thumbnails not ready): %1").arg(QFileInfo(filePath).fileName()));
             }
             
             // Handle thumbnail synchronization if needed (use original path for matching)
@@ -2357,7 +2342,7 @@ bool DicomViewer::eventFilter(QObject *obj, QEvent *event)
         QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
         if (keyEvent && (keyEvent->key() == Qt::Key_Left || keyEvent->key() == Qt::Key_Right)) {
             // SAFETY: Only process if viewer is fully initialized
-            if (m_frameProcessor && m_totalFrames > 1 && !m_currentImagePath.isEmpty()) {
+            if (m_totalFrames > 1 && !m_currentImagePath.isEmpty()) {
                 try {
                     if (keyEvent->key() == Qt::Key_Left) {
                         onPreviousFrameRequested();
@@ -2413,50 +2398,50 @@ void DicomViewer::keyPressEvent(QKeyEvent *event)
 
 void DicomViewer::closeEvent(QCloseEvent *event)
 {
-    logMessage("DEBUG", "CloseEvent: Starting application shutdown...");
+    LOG_AT(LOG_DEBUG, "CloseEvent: Starting application shutdown...");
     
     // Stop all timers first
     if (m_playbackTimer && m_playbackTimer->isActive()) {
         m_playbackTimer->stop();
-        logMessage("DEBUG", "CloseEvent: Playback timer stopped");
+        LOG_AT(LOG_DEBUG, "CloseEvent: Playback timer stopped");
     }
     
     if (m_progressiveTimer && m_progressiveTimer->isActive()) {
         m_progressiveTimer->stop();
-        logMessage("DEBUG", "CloseEvent: Progressive timer stopped");
+        LOG_AT(LOG_DEBUG, "CloseEvent: Progressive timer stopped");
     }
     
     if (m_copyProgressTimer && m_copyProgressTimer->isActive()) {
         m_copyProgressTimer->stop();
-        logMessage("DEBUG", "CloseEvent: Copy progress timer stopped");
+        LOG_AT(LOG_DEBUG, "CloseEvent: Copy progress timer stopped");
     }
     
     // Stop and clean up progressive loader thread
     if (m_progressiveLoader) {
-        logMessage("DEBUG", "CloseEvent: Stopping progressive loader...");
+        LOG_AT(LOG_DEBUG, "CloseEvent: Stopping progressive loader...");
         m_progressiveLoader->stop();
         m_progressiveLoader->wait(3000); // 3 second timeout
         delete m_progressiveLoader;
         m_progressiveLoader = nullptr;
-        logMessage("DEBUG", "CloseEvent: Progressive loader cleaned up");
+        LOG_AT(LOG_DEBUG, "CloseEvent: Progressive loader cleaned up");
     }
     
     // Robocopy process is now handled by DvdCopyWorker
     
     // Clean up DVD worker thread
     if (m_dvdWorkerThread) {
-        logMessage("DEBUG", "CloseEvent: Stopping DVD worker thread...");
+        LOG_AT(LOG_DEBUG, "CloseEvent: Stopping DVD worker thread...");
         m_dvdWorkerThread->quit();
         if (!m_dvdWorkerThread->wait(3000)) { // 3 second timeout
             logMessage("WARN", "CloseEvent: Force terminating DVD worker thread...");
             m_dvdWorkerThread->terminate();
             m_dvdWorkerThread->wait(1000);
         }
-        logMessage("DEBUG", "CloseEvent: DVD worker thread stopped");
+        LOG_AT(LOG_DEBUG, "CloseEvent: DVD worker thread stopped");
     }
     
     // Force cleanup of any remaining resources
-    logMessage("DEBUG", "CloseEvent: Final cleanup and quit...");
+    LOG_AT(LOG_DEBUG, "CloseEvent: Final cleanup and quit...");
     
     // Accept the close event and force quit
     event->accept();
@@ -2569,6 +2554,9 @@ void DicomViewer::updateOverlayInfo()
     
     // Frame information - show actually displayed frame, not requested frame
     bottomLeftText += QString("Frame %1/%2").arg(m_currentDisplayedFrame + 1).arg(m_totalFrames);
+    if (m_currentDisplayedFrame >= 0 && m_currentFrame != m_currentDisplayedFrame) {
+        bottomLeftText += QString(" (loading %1)").arg(m_currentFrame + 1);
+    }
     
     // Bottom Right Corner: Technical parameters, zoom, and window/level
     QString bottomRightText;
@@ -2605,7 +2593,7 @@ void DicomViewer::updateOverlayInfo()
         double pipelineWidth = m_imagePipeline->getWindowWidth();
         if (pipelineWidth > 0) {
             bottomRightText += QString("WL: %1 WW: %2").arg(pipelineCenter, 0, 'f', 0).arg(pipelineWidth, 0, 'f', 0);
-            logMessage("DEBUG", QString("UI OVERLAY FALLBACK: WL=%1 WW=%2 (from pipeline - should NOT happen)")
+            LOG_AT(LOG_DEBUG, QString("UI OVERLAY FALLBACK: WL=%1 WW=%2 (from pipeline - should NOT happen)")
                 .arg(pipelineCenter, 0, 'f', 0).arg(pipelineWidth, 0, 'f', 0));
         }
     }
@@ -2627,6 +2615,8 @@ void DicomViewer::positionOverlays()
 
 void DicomViewer::updateImageDisplay()
 {
+    PerfSpan span("DicomViewer::updateImageDisplay", PerfStage::Display);
+    
     if (!m_currentPixmap.isNull() && m_graphicsScene && m_graphicsView) {
         // Clear previous image
         if (m_pixmapItem) {
@@ -2698,23 +2688,33 @@ void DicomViewer::processThroughPipeline()
         return;
     }
     
-    // Use original pixmap if available, otherwise use current pixmap
-    QPixmap sourcePixmap = m_originalPixmap.isNull() ? m_currentPixmap : m_originalPixmap;
-    if (sourcePixmap.isNull()) {
-        return;
+    QImage processedImage;
+    if (!m_currentPixelFrame.isNull()) {
+        // Native frame available - window straight from the stored values
+        PerfSpan windowSpan("ImageProcessingPipeline::processFrame", PerfStage::WindowLevel);
+        processedImage = m_imagePipeline->processFrame(m_currentPixelFrame);
+    } else {
+        // Use original pixmap if available, otherwise use current pixmap
+        QPixmap sourcePixmap = m_originalPixmap.isNull() ? m_currentPixmap : m_originalPixmap;
+        if (sourcePixmap.isNull()) {
+            return;
+        }
+        
+        // Convert to image and process through pipeline
+        QImage sourceImage = sourcePixmap.toImage();
+        PerfSpan windowSpan("ImageProcessingPipeline::processImage", PerfStage::WindowLevel);
+        processedImage = m_imagePipeline->processImage(sourceImage);
     }
     
-    
-    // Convert to image and process through pipeline
-    QImage sourceImage = sourcePixmap.toImage();
-    QImage processedImage = m_imagePipeline->processImage(sourceImage);
-    
     if (processedImage.isNull()) {
         return;
     }
     
     // Convert back to pixmap and update display
-    m_currentPixmap = QPixmap::fromImage(processedImage);
+    {
+        PerfSpan convertSpan("QPixmap::fromImage", PerfStage::Convert);
+        m_currentPixmap = QPixmap::fromImage(processedImage, Qt::NoFormatConversion);
+    }
     
     // Do NOT sync W/L values from pipeline back to UI variables!
     // m_currentWindowCenter and m_currentWindowWidth should always contain
@@ -2789,25 +2789,8 @@ void DicomViewer::updateWindowing(const QPoint& pos)
     m_currentWindowCenter = newCenter;
     m_currentWindowWidth = newWidth;
     
-    // Scale window values for pipeline processing based on bit depth
-    double pipelineCenter, pipelineWidth;
-    int bitsStored = m_imagePipeline->getBitsStored();
-    
-    if (bitsStored > 8) {
-        // For >8-bit images, scale window values to 8-bit range for pipeline processing
-        double maxOriginalValue = (1 << bitsStored) - 1;  // e.g., 16383 for 14-bit
-        double scaleFactor = 255.0 / maxOriginalValue;    // e.g., 255/16383 ≈ 0.0156
-        
-        pipelineCenter = newCenter * scaleFactor;
-        pipelineWidth = newWidth * scaleFactor;
-    } else {
-        // For 8-bit images, use values directly
-        pipelineCenter = newCenter;
-        pipelineWidth = newWidth;
-    }
-    
-    // Update the pipeline with scaled values for internal processing
-    m_imagePipeline->setWindowLevel(pipelineCenter, pipelineWidth);
+    // The pipeline works in the same modality units as the DICOM values
+    m_imagePipeline->setWindowLevel(newCenter, newWidth);
     
     // Apply window/level to current image through pipeline
     processThroughPipeline();
@@ -2887,24 +2870,8 @@ void DicomViewer::toggleWindowLevelMode()
 
 void DicomViewer::applyWindowLevel(double center, double width)
 {
-    // Scale window values for pipeline processing based on bit depth
-    double pipelineCenter, pipelineWidth;
-    int bitsStored = m_imagePipeline->getBitsStored();
-    
-    if (bitsStored > 8) {
-        // For >8-bit images, scale window values to 8-bit range for pipeline processing
-        double maxOriginalValue = (1 << bitsStored) - 1;  // e.g., 16383 for 14-bit
-        double scaleFactor = 255.0 / maxOriginalValue;    // e.g., 255/16383 ≈ 0.0156
-        
-        pipelineCenter = center * scaleFactor;
-        pipelineWidth = width * scaleFactor;
-    } else {
-        // For 8-bit images, use values directly
-        pipelineCenter = center;
-        pipelineWidth = width;
-    }
-    
-    m_imagePipeline->setWindowLevel(pipelineCenter, pipelineWidth);
+    // The pipeline works in the same modality units as the DICOM values
+    m_imagePipeline->setWindowLevel(center, width);
     // Only enable if toggle button is ON
     if (m_windowLevelModeEnabled) {
         m_imagePipeline->setWindowLevelEnabled(true);
@@ -2915,7 +2882,7 @@ void DicomViewer::applyWindowLevel(double center, double width)
 
 void DicomViewer::loadDicomDir(const QString& dicomdirPath)
 {
-    logMessage("DEBUG", QString("loadDicomDir called with path: %1").arg(dicomdirPath));
+    LOG_AT(LOG_DEBUG, QString("loadDicomDir called with path: %1").arg(dicomdirPath));
     
     try {
         // Clear existing data
@@ -2935,12 +2902,12 @@ void DicomViewer::loadDicomDir(const QString& dicomdirPath)
         // Populate tree widget using DicomReader
         m_dicomReader->populateTreeWidget(m_dicomTree);
         
-        logMessage("DEBUG", "[LOAD DICOMDIR] Tree populated, about to call detectAndStartDvdCopy()");
+        LOG_AT(LOG_DEBUG, "[LOAD DICOMDIR] Tree populated, about to call detectAndStartDvdCopy()");
         
         // Start DVD detection and copy if needed BEFORE thumbnail generation
         detectAndStartDvdCopy();
         
-        logMessage("DEBUG", "[LOAD DICOMDIR] detectAndStartDvdCopy() completed");
+        LOG_AT(LOG_DEBUG, "[LOAD DICOMDIR] detectAndStartDvdCopy() completed");
         
        
         // Expand first level items and select first image if available
@@ -2950,11 +2917,11 @@ void DicomViewer::loadDicomDir(const QString& dicomdirPath)
         if (m_copyInProgress) {
             if (m_thumbnailPanel) {
                 m_thumbnailPanel->hide();
-                logMessage("DEBUG", "[THUMBNAIL PANEL] Hidden during copy operations");
+                LOG_AT(LOG_DEBUG, "[THUMBNAIL PANEL] Hidden during copy operations");
             }
         } else {
             // For non-DVD mode, start thumbnail generation immediately
-            logMessage("DEBUG", "[LOAD DICOMDIR] Starting thumbnail generation for non-DVD mode");
+            LOG_AT(LOG_DEBUG, "[LOAD DICOMDIR] Starting thumbnail generation for non-DVD mode");
             QTimer::singleShot(0, this, &DicomViewer::updateThumbnailPanel);
         }
         
@@ -2964,7 +2931,7 @@ void DicomViewer::loadDicomDir(const QString& dicomdirPath)
         
         // For local files (no DVD copy needed), auto-select first image after tree is ready
         if (!m_copyInProgress && !m_dvdDetectionInProgress) {
-            logMessage("DEBUG", "[LOCAL FILES] Scheduling auto-selection for local DICOMDIR");
+            LOG_AT(LOG_DEBUG, "[LOCAL FILES] Scheduling auto-selection for local DICOMDIR");
             
             // Defer to next event loop cycle to ensure tree widget is fully ready
             QTimer::singleShot(0, [this]() {
@@ -3055,7 +3022,7 @@ void DicomViewer::checkInitialFfmpegAvailability()
             m_saveRunAction->setEnabled(true);
             m_ffmpegCopyCompleted = true; // Mark as completed
         }
-        logMessage("DEBUG", "FFmpeg found locally - Video export ready");
+        LOG_AT(LOG_DEBUG, "FFmpeg found locally - Video export ready");
         return; // Exit early - no need to wait for copy
     }
     
@@ -3073,19 +3040,19 @@ QString DicomViewer::findFfmpegExecutable()
     QString executablePath = QApplication::applicationDirPath();
     QString localFfmpegPath = QDir(executablePath).absoluteFilePath("ffmpeg.exe");
     
-    logMessage("DEBUG", QString("Checking for ffmpeg.exe in executable directory: %1").arg(localFfmpegPath));
+    LOG_AT(LOG_DEBUG, QString("Checking for ffmpeg.exe in executable directory: %1").arg(localFfmpegPath));
     
     if (QFile::exists(localFfmpegPath)) {
-        logMessage("DEBUG", "Found ffmpeg.exe in local directory");
+        LOG_AT(LOG_DEBUG, "Found ffmpeg.exe in local directory");
         return localFfmpegPath;
     }
     
     // Check temp folder where DVD copy might have placed it
     QString tempFfmpegPath = QDir::tempPath() + "/Ekn_TempData/ffmpeg.exe";
-    logMessage("DEBUG", QString("Checking for ffmpeg.exe in temp folder: %1").arg(tempFfmpegPath));
+    LOG_AT(LOG_DEBUG, QString("Checking for ffmpeg.exe in temp folder: %1").arg(tempFfmpegPath));
     
     if (QFile::exists(tempFfmpegPath)) {
-        logMessage("DEBUG", "Found ffmpeg.exe in temp folder");
+        LOG_AT(LOG_DEBUG, "Found ffmpeg.exe in temp folder");
         return tempFfmpegPath;
     }
     
@@ -3093,10 +3060,10 @@ QString DicomViewer::findFfmpegExecutable()
     if (!m_dvdSourcePath.isEmpty()) {
         QString dvdFfmpegPath = m_dvdSourcePath + "/ffmpeg.exe";
         
-        logMessage("DEBUG", QString("Checking for ffmpeg.exe on DVD drive: %1").arg(dvdFfmpegPath));
+        LOG_AT(LOG_DEBUG, QString("Checking for ffmpeg.exe on DVD drive: %1").arg(dvdFfmpegPath));
         
         if (QFile::exists(dvdFfmpegPath)) {
-            logMessage("DEBUG", "Found ffmpeg.exe on DVD drive");
+            LOG_AT(LOG_DEBUG, "Found ffmpeg.exe on DVD drive");
             return dvdFfmpegPath;
         }
     }
@@ -3107,13 +3074,13 @@ QString DicomViewer::findFfmpegExecutable()
     for (const QString& drive : drivesToCheck) {
         QString driveFfmpegPath = drive + "/ffmpeg.exe";
         
-        logMessage("DEBUG", QString("Checking for ffmpeg.exe on drive: %1").arg(driveFfmpegPath));
+        LOG_AT(LOG_DEBUG, QString("Checking for ffmpeg.exe on drive: %1").arg(driveFfmpegPath));
         
         if (QFile::exists(driveFfmpegPath)) {
             // Verify this is likely the DVD drive by checking for DicomFiles directory
             QString dicomPath = drive + "/DicomFiles";
             if (QDir(dicomPath).exists()) {
-                logMessage("DEBUG", QString("Found ffmpeg.exe on DVD drive: %1").arg(driveFfmpegPath));
+                LOG_AT(LOG_DEBUG, QString("Found ffmpeg.exe on DVD drive: %1").arg(driveFfmpegPath));
                 return driveFfmpegPath;
             }
         }
@@ -3125,13 +3092,16 @@ QString DicomViewer::findFfmpegExecutable()
 
 void DicomViewer::initializeLogging()
 {
-    // Initialize minimum log level based on build configuration
-    m_minLogLevel = static_cast<LogLevel>(DEFAULT_LOG_LEVEL);
-    
     // Set up log file in the same directory as the executable
     QString executablePath = QApplication::applicationDirPath();
     m_logFilePath = QDir(executablePath).absoluteFilePath("DicomViewer.log");
     
+    // Levels below DEFAULT_LOG_LEVEL are filtered at compile time; the writer
+    // thread owns the file from here on
+    if (!AsyncLogger::instance().start(m_logFilePath)) {
+        qWarning() << "Could not open log file" << m_logFilePath;
+    }
+    
     // Write initial log entry
     logMessage("INFO", "DicomViewer application started");
     
@@ -3158,59 +3128,19 @@ void DicomViewer::logMessage(const QString& level, const QString& message) const
     else if (level == "ERROR") enumLevel = LOG_ERROR;
     else enumLevel = LOG_INFO; // Default fallback
     
-    // Filter based on minimum log level
-    if (enumLevel < m_minLogLevel) {
-        return; // Skip this log message
-    }
-    
-    QMutexLocker locker(&m_logMutex);
-    
-    QFile logFile(m_logFilePath);
-    if (logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
-        QTextStream stream(&logFile);
-        
-        QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
-        Qt::HANDLE threadId = QThread::currentThreadId();
-        QString threadIdStr = QString("0x%1").arg(reinterpret_cast<quintptr>(threadId), 0, 16);
-        QString logEntry = QString("[%1] [Thread:%2] %3: %4").arg(timestamp, threadIdStr, level, message);
-        
-        stream << logEntry << Qt::endl;
-        logFile.close();
-        
-        // Output to console for debugging (only in debug builds)
-        #ifdef _DEBUG
-        std::cout << logEntry.toStdString() << std::endl;
-        #endif
-    }
+    AsyncLogger::instance().log(enumLevel, message);
 }
 
 // Enum-based logMessage method
 void DicomViewer::logMessage(LogLevel level, const QString& message) const
 {
-    // Filter based on minimum log level
-    if (level < m_minLogLevel) {
-        return; // Skip this log message
-    }
-    
-    // Convert enum to string for the legacy method
-    QString levelStr;
-    switch (level) {
-        case LOG_DEBUG: levelStr = "DEBUG"; break;
-        case LOG_INFO:  levelStr = "INFO"; break;
-        case LOG_WARN:  levelStr = "WARN"; break;
-        case LOG_ERROR: levelStr = "ERROR"; break;
-        default:    levelStr = "INFO"; break;
-    }
-    
-    // Delegate to the string-based method
-    logMessage(levelStr, message);
+    AsyncLogger::instance().log(level, message);
 }
 
 // Message-first enum-based logMessage method (for convenience)
 void DicomViewer::logMessage(const QString& message, LogLevel level) const
 {
-    // Just call the level-first version
-    logMessage(level, message);
+    AsyncLogger::instance().log(level, message);
 }
 
 bool DicomViewer::copyFfmpegExe()
@@ -3230,7 +3160,7 @@ bool DicomViewer::copyFfmpegExe()
             m_dvdSourcePath = testDrive;
         } else {
             // Fallback to auto-detection
-            logMessage("DEBUG", "DVD source path empty - attempting detection");
+            LOG_AT(LOG_DEBUG, "DVD source path empty - attempting detection");
             QStringList drives = {"D:", "E:", "F:", "G:", "H:"};
             
             for (const QString& drive : drives) {
@@ -3242,7 +3172,7 @@ bool DicomViewer::copyFfmpegExe()
             }
             
             if (m_dvdSourcePath.isEmpty()) {
-                logMessage("DEBUG", "No DVD detected - skipping copy");
+                LOG_AT(LOG_DEBUG, "No DVD detected - skipping copy");
                 emit ffmpegCopyCompleted(true); // Still enable exports if local ffmpeg exists
                 return true;
             }
@@ -3314,10 +3244,10 @@ bool DicomViewer::copyFfmpegExe()
 
 void DicomViewer::expandFirstItems()
 {
-    logMessage("DEBUG", "[EXPAND FIRST] expandFirstItems() called");
+    LOG_AT(LOG_DEBUG, "[EXPAND FIRST] expandFirstItems() called");
     
     if (m_dicomTree->topLevelItemCount() > 0) {
-        logMessage("DEBUG", QString("[EXPAND FIRST] Found %1 top level items").arg(m_dicomTree->topLevelItemCount()));
+        LOG_AT(LOG_DEBUG, QString("[EXPAND FIRST] Found %1 top level items").arg(m_dicomTree->topLevelItemCount()));
         
         // Temporarily disable selection signals to prevent automatic selection during expansion
         disconnect(m_dicomTree, &QTreeWidget::currentItemChanged,
@@ -3338,7 +3268,7 @@ void DicomViewer::expandFirstItems()
                     QTreeWidgetItem* firstSeries = firstStudy->child(0);
                     firstSeries->setExpanded(true);
                     
-                    logMessage("DEBUG", "[EXPAND FIRST] Tree expanded without auto-selection to prevent recursion");
+                    LOG_AT(LOG_DEBUG, "[EXPAND FIRST] Tree expanded without auto-selection to prevent recursion");
                 }
             }
         }
@@ -3354,7 +3284,7 @@ void DicomViewer::expandFirstItems()
         QTimer::singleShot(100, this, &DicomViewer::autoSelectFirstAvailableImage);
         
     } else {
-        logMessage("DEBUG", "[EXPAND FIRST] No top level items found in tree");
+        LOG_AT(LOG_DEBUG, "[EXPAND FIRST] No top level items found in tree");
     }
 }
 
@@ -3362,9 +3292,6 @@ void DicomViewer::loadDicomImage(const QString& filePath)
 {
     if (filePath.isEmpty()) return;
     
-    // NEW: Protect DCMTK operations
-    QMutexLocker dcmtkLocker(&m_dcmtkAccessMutex);
-    
     // NEW: Verify file readiness
     {
         if (m_copyInProgress && !QFile::exists(filePath)) {
@@ -3375,10 +3302,9 @@ void DicomViewer::loadDicomImage(const QString& filePath)
     
 #ifdef HAVE_DCMTK
     
-    // Clear DICOM info cache when loading a new image
-    if (m_currentImagePath != filePath) {
-        m_cachedDicomInfoFilePath.clear();
-        m_cachedDicomInfoHtml.clear();
+    // Release the previous image's dataset held by the tag panel
+    if (m_currentImagePath != filePath && m_dicomTagModel) {
+        m_dicomTagModel->clear();
     }
     
     // Switch to image widget
@@ -3407,7 +3333,7 @@ void DicomViewer::loadDicomImage(const QString& filePath)
     if (filePath != m_currentImagePath) {
         clearFrameCache();
         m_isLoadingProgressively = false;
-        m_allFramesCached = false;
+        m_initialWindowLoaded = false;
         m_zoomFactor = 1.0; // Reset zoom for new image
     } else {
         // Keep existing cache and state for same image
@@ -3451,28 +3377,22 @@ void DicomViewer::loadDicomImage(const QString& filePath)
                 QString testPath = dir.absoluteFilePath(file);
                 
                 try {
-                    DcmFileFormat dcmFile;
-                    OFCondition status = dcmFile.loadFile(testPath.toLocal8Bit().constData());
-                    if (status.good()) {
-                        DcmDataset* dataset = dcmFile.getDataset();
-                        if (dataset) {
-                            // Check if it has pixel data (actual medical image)
-                            DcmElement* pixelDataElement = nullptr;
-                            if (dataset->findAndGetElement(DCM_PixelData, pixelDataElement).good() && pixelDataElement) {
-                                // Check if it's a real image (not just a dose report)
-                                OFString seriesDesc;
-                                dataset->findAndGetOFString(DCM_SeriesDescription, seriesDesc);
-                                QString series = QString::fromStdString(seriesDesc.c_str()).toLower();
-                                
-                                // Skip dose reports and structured reports
-                                if (!series.contains("dose") && !series.contains("report") && !series.contains("sr")) {
-                                    imageFiles.append(testPath);
-                                } else {
-                                    nonImageFiles.append(testPath);
-                                }
+                    // Header only - the scan must not read every file's pixel data
+                    DicomHeaderInfo header = DicomHeaderProbe::read(testPath);
+                    if (header.valid) {
+                        // Check if it has image dimensions (actual medical image)
+                        if (header.isImage()) {
+                            // Check if it's a real image (not just a dose report)
+                            QString series = header.seriesDescription.toLower();
+                            
+                            // Skip dose reports and structured reports
+                            if (!series.contains("dose") && !series.contains("report") && !series.contains("sr")) {
+                                imageFiles.append(testPath);
                             } else {
                                 nonImageFiles.append(testPath);
                             }
+                        } else {
+                            nonImageFiles.append(testPath);
                         }
                     }
                 } catch (...) {
@@ -3510,7 +3430,7 @@ void DicomViewer::loadDicomImage(const QString& filePath)
     bool fileIsCompleted = m_fullyCompletedFiles.contains(filename);
     
     if (m_copyInProgress && !fileIsCompleted) {
-        logMessage("DEBUG", QString("[FILE ACCESS] File not yet completed: %1 - copy still in progress").arg(filename));
+        LOG_AT(LOG_DEBUG, QString("[FILE ACCESS] File not yet completed: %1 - copy still in progress").arg(filename));
         
         // Show progress in status bar, not on image display
         if (m_copyInProgress && m_currentCopyProgress > 0) {
@@ -3524,23 +3444,38 @@ void DicomViewer::loadDicomImage(const QString& filePath)
         return;
     }
     
-    logMessage("DEBUG", QString("[FILE ACCESS] File is ready for access: %1 completed: %2").arg(filename).arg(fileIsCompleted));
+    LOG_AT(LOG_DEBUG, QString("[FILE ACCESS] File is ready for access: %1 completed: %2").arg(filename).arg(fileIsCompleted));
     
     // Store current image path
     m_currentImagePath = actualFilePath;
     
     try {
-        // Quick metadata check to determine if this is a valid DICOM image
-        DcmFileFormat dcmFile;
-        OFCondition status = dcmFile.loadFile(actualFilePath.toLocal8Bit().constData());
+        // Structured reports are parsed (once) by displayReport() on a worker;
+        // the header tells them apart without a full parse here
+        DicomHeaderInfo header = DicomHeaderProbe::read(actualFilePath);
+        if (header.valid && !header.isImage() && header.isStructuredReport()) {
+            if (header.isRadiationDoseSR()) {
+                logMessage("INFO", QString("Loading RDSR (Radiation Dose Structured Report): %1").arg(actualFilePath));
+            } else {
+                logMessage("INFO", QString("Loading Structured Report: %1").arg(actualFilePath));
+            }
+            m_currentDataset.reset();
+            displayReport(actualFilePath);
+            return;
+        }
+        
+        // Parse the file once - the handle is shared with the frame processor,
+        // the progressive loader and playback setup below
+        m_currentDataset = DicomDatasetHandle::open(actualFilePath);
         
-        if (status.bad()) {
+        if (!m_currentDataset) {
             m_imageLabel->setText("Error loading DICOM file");
             setTransformationActionsEnabled(true);
             return;
         }
         
-        DcmDataset* dataset = dcmFile.getDataset();
+        QMutexLocker datasetLocker(m_currentDataset->mutex());
+        DcmDataset* dataset = m_currentDataset->dataset();
         if (!dataset) {
             m_imageLabel->setText("Invalid DICOM file");
             setTransformationActionsEnabled(true);
@@ -3552,25 +3487,11 @@ void DicomViewer::loadDicomImage(const QString& filePath)
         if (!dataset->findAndGetUint16(DCM_Rows, rows).good() || 
             !dataset->findAndGetUint16(DCM_Columns, columns).good()) {
             
-            // Check what type of DICOM object this is
+            // Structured reports were routed to displayReport() from the header above
             OFString sopClassUID;
             if (dataset->findAndGetOFString(DCM_SOPClassUID, sopClassUID).good()) {
-                logMessage("DEBUG", QString("DICOM file SOP Class UID: %1").arg(QString::fromLatin1(sopClassUID.c_str())));
-                
-                // Check if it's a Structured Report
-                if (sopClassUID.find("1.2.840.10008.5.1.4.1.1.88") != OFString_npos) {
-                    // Check specifically for RDSR
-                    if (sopClassUID == "1.2.840.10008.5.1.4.1.1.88.67") {
-                        logMessage("INFO", QString("Loading RDSR (Radiation Dose Structured Report): %1").arg(actualFilePath));
-                    } else {
-                        logMessage("INFO", QString("Loading Structured Report: %1").arg(actualFilePath));
-                    }
-                    // This is a Structured Report - display it
-                    displayReport(actualFilePath);
-                    return;
-                } else {
-                    m_imageLabel->setText(QString("Selected DICOM file is not an image.\nSOP Class: %1").arg(sopClassUID.c_str()));
-                }
+                LOG_AT(LOG_DEBUG, QString("DICOM file SOP Class UID: %1").arg(QString::fromLatin1(sopClassUID.c_str())));
+                m_imageLabel->setText(QString("Selected DICOM file is not an image.\nSOP Class: %1").arg(sopClassUID.c_str()));
             } else {
                 m_imageLabel->setText("Selected file is not a DICOM image.\nMissing image dimensions (Rows/Columns tags).");
             }
@@ -3587,26 +3508,22 @@ void DicomViewer::loadDicomImage(const QString& filePath)
         if (!numberOfFramesStr.empty()) {
             totalFrames = atoi(numberOfFramesStr.c_str());
         }
-        
+        datasetLocker.unlock();
         
         // Extract DICOM metadata for overlays
-        extractDicomMetadata(actualFilePath);
+        extractDicomMetadata(m_currentDataset);
         
         // Show loading message
         m_imageLabel->setText(QString("Loading... (0/%1 frames)").arg(totalFrames));
         
-        // Load file in DicomFrameProcessor for direct access
-        if (m_frameProcessor && m_frameProcessor->loadDicomFile(actualFilePath)) {
-        }
-        
-        // Start progressive loading
-        m_progressiveLoader = new ProgressiveFrameLoader(actualFilePath);
+        // Start progressive loading; the loader indexes the pixel data on its own thread
+        m_progressiveLoader = new ProgressiveFrameLoader(m_currentDataset, m_frameStore);
         
         // Connect signals with Qt::QueuedConnection for responsive cross-thread communication
         connect(m_progressiveLoader, &ProgressiveFrameLoader::frameReady,
                 this, &DicomViewer::onFrameReady, Qt::QueuedConnection);
-        connect(m_progressiveLoader, &ProgressiveFrameLoader::allFramesLoaded,
-                this, &DicomViewer::onAllFramesLoaded, Qt::QueuedConnection);
+        connect(m_progressiveLoader, &ProgressiveFrameLoader::initialWindowLoaded,
+                this, &DicomViewer::onInitialWindowLoaded, Qt::QueuedConnection);
         connect(m_progressiveLoader, &ProgressiveFrameLoader::firstFrameInfo,
                 this, &DicomViewer::onFirstFrameInfo, Qt::QueuedConnection);
         connect(m_progressiveLoader, &ProgressiveFrameLoader::errorOccurred,
@@ -3640,12 +3557,14 @@ void DicomViewer::loadDicomImage(const QString& filePath)
 #endif
 }
 
-QPixmap DicomViewer::convertDicomFrameToPixmap(const QString& filePath, int frameIndex)
+QImage DicomViewer::convertDicomFrameToImage(const QString& filePath, int frameIndex)
 {
 #ifdef HAVE_DCMTK
     try {
-        // Create DicomImage object with automatic decompression
-        DicomImage* dicomImage = new DicomImage(filePath.toLocal8Bit().constData(), CIF_AcrNemaCompatibility);
+        // Load only the requested frame; partial access reads just that frame's pixel bytes
+        DicomImage* dicomImage = new DicomImage(filePath.toLocal8Bit().constData(),
+                                                CIF_AcrNemaCompatibility | CIF_UsePartialAccessToPixelData,
+                                                frameIndex, 1);
         
         if (dicomImage == nullptr || dicomImage->getStatus() != EIS_Normal) {
             // Get detailed error information
@@ -3656,64 +3575,51 @@ QPixmap DicomViewer::convertDicomFrameToPixmap(const QString& filePath, int fram
             }
             
             delete dicomImage;
-            return QPixmap();
+            return QImage();
         }
         
-        // Check if frame index is valid
-        if (frameIndex >= (int)dicomImage->getFrameCount()) {
+        // Check if frame index is valid (the image holds just that one frame)
+        if (frameIndex >= (int)dicomImage->getNumberOfFrames() || dicomImage->getFrameCount() < 1) {
             delete dicomImage;
-            return QPixmap();
+            return QImage();
         }
         
         // Get image dimensions
         unsigned long width = dicomImage->getWidth();
         unsigned long height = dicomImage->getHeight();
-        unsigned long depth = dicomImage->getDepth();
-        
-        
-        // Select specific frame for multiframe images
-        if (dicomImage->getFrameCount() > 1) {
-            dicomImage = dicomImage->createScaledImage(width, height, 1, frameIndex);
-            if (!dicomImage || dicomImage->getStatus() != EIS_Normal) {
-                delete dicomImage;
-                return QPixmap();
-            }
-        }
-        
-
         
         // Convert to 8-bit for display (with window/level applied by DCMTK)
         const void* pixelData = dicomImage->getOutputData(8 /* bits per sample */);
         if (!pixelData) {
             delete dicomImage;
-            return QPixmap();
+            return QImage();
         }
         
-        // Create QImage from pixel data
-        QImage qImage((const uchar*)pixelData, width, height, QImage::Format_Grayscale8);
-        
-        // Convert to RGB format for better compatibility
-        QImage rgbImage = qImage.convertToFormat(QImage::Format_RGB888);
+        // Wrap the 8-bit output: one sample per pixel for monochrome, interleaved RGB for colour
+        const bool isColor = !dicomImage->isMonochrome();
+        QImage qImage((const uchar*)pixelData, width, height, isColor ? width * 3 : width,
+                      isColor ? QImage::Format_RGB888 : QImage::Format_Grayscale8);
         
-        // Create pixmap
-        QPixmap pixmap = QPixmap::fromImage(rgbImage);
+        // Deep copy: the image must not reference DCMTK's buffer once the DicomImage is released.
+        // Callers run on worker threads, so no QPixmap is created here.
+        QImage image = qImage.copy();
         
         delete dicomImage;
-        return pixmap;
+        return image;
         
     } catch (const std::exception& e) {
-        return QPixmap();
+        return QImage();
     } catch (...) {
-        return QPixmap();
+        return QImage();
     }
 #else
     Q_UNUSED(filePath)
     Q_UNUSED(frameIndex)
-    return QPixmap();
+    return QImage();
 #endif
 }
 
-void DicomViewer::setupMultiframePlayback(const QString& filePath)
+void DicomViewer::setupMultiframePlayback(const std::shared_ptr<DicomDatasetHandle>& datasetHandle)
 {
 #ifdef HAVE_DCMTK
     // Initialize legacy timer if framework is not available (backwards compatibility)
@@ -3723,15 +3629,13 @@ void DicomViewer::setupMultiframePlayback(const QString& filePath)
     }
     
     try {
-        // Load DICOM file to get frame timing information
-        DcmFileFormat dcmFile;
-        OFCondition status = dcmFile.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (status.bad()) {
+        // Read frame timing information from the already parsed dataset
+        if (!datasetHandle) {
             return;
         }
         
-        DcmDataset* dataset = dcmFile.getDataset();
+        QMutexLocker datasetLocker(datasetHandle->mutex());
+        DcmDataset* dataset = datasetHandle->dataset();
         if (!dataset) {
             return;
         }
@@ -3789,6 +3693,7 @@ void DicomViewer::setupMultiframePlayback(const QString& filePath)
             } else {
             }
         }
+        datasetLocker.unlock();
         
         // Apply frame rate limits to prevent display issues
         const int MIN_FRAME_TIME_MS = 16;  // ~60 FPS max
@@ -3829,28 +3734,21 @@ void DicomViewer::setupMultiframePlayback(const QString& filePath)
     } catch (...) {
     }
 #else
-    Q_UNUSED(filePath)
+    Q_UNUSED(datasetHandle)
 #endif
 }
 
 // Progressive loading slot implementations
 void DicomViewer::onFrameReady(int frameNumber)
 {
-    auto uiStart = std::chrono::high_resolution_clock::now();
-    auto uiStartTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(uiStart.time_since_epoch()).count();
-    
+    PerfSpan span("DicomViewer::onFrameReady", PerfStage::None);
     
     // Fetch frame data from thread-safe cache instead of receiving through signal
     if (!m_progressiveLoader || !m_progressiveLoader->isFrameReady(frameNumber)) {
         return;
     }
     
-    auto fetchStart = std::chrono::high_resolution_clock::now();
-    QPixmap pixmap = m_progressiveLoader->getFramePixmap(frameNumber);
-    QByteArray originalPixelData = m_progressiveLoader->getFrameOriginalData(frameNumber);
-    auto fetchEnd = std::chrono::high_resolution_clock::now();
-    auto fetchDuration = std::chrono::duration_cast<std::chrono::milliseconds>(fetchEnd - fetchStart).count();
-    
+    StoredFrame storedFrame = m_frameStore->frame(frameNumber);
     
     // CRITICAL: Check if this frame belongs to the currently loading image
     // Prevent contamination from previous image loading processes
@@ -3858,24 +3756,36 @@ void DicomViewer::onFrameReady(int frameNumber)
         return;
     }
     
-    if (!m_isLoadingProgressively) {
+    // The loader already put the frame into the shared store
+    if (storedFrame.isNull()) {
         return;
     }
     
-    // Cache the frame and original pixel data
-    m_frameCache[frameNumber] = pixmap;
-    m_originalPixelCache[frameNumber] = originalPixelData;
+    if (!m_isLoadingProgressively) {
+        // After the first window the loader decodes around the playhead;
+        // show the frame the viewer is waiting for when it arrives
+        if (frameNumber == m_currentFrame && frameNumber != m_currentDisplayedFrame) {
+            displayCachedFrame(frameNumber);
+        }
+        return;
+    }
     
     // For the first frame (frame 0), display it immediately and set as current
     if (frameNumber == 0) {
+        // Native frames are previewed over their full stored range until W/L is applied
+        QImage firstImage = storedFrame.image.isNull()
+            ? DicomFrameProcessor::pixelFrameToGrayscale8(storedFrame.pixels) : storedFrame.image;
+        QPixmap pixmap;
+        {
+            PerfSpan convertSpan("QPixmap::fromImage", PerfStage::Convert);
+            pixmap = QPixmap::fromImage(firstImage, Qt::NoFormatConversion);
+        }
         m_currentFrame = 0;
         m_currentPixmap = pixmap;
         m_originalPixmap = pixmap;  // Store the original unmodified pixmap
+        m_currentPixelFrame = storedFrame.pixels;
         m_currentDisplayedFrame = 0;
-        auto displayStart = std::chrono::high_resolution_clock::now();
         updateImageDisplay();
-        auto displayEnd = std::chrono::high_resolution_clock::now();
-        auto displayDuration = std::chrono::duration_cast<std::chrono::milliseconds>(displayEnd - displayStart).count();
         
         updateOverlayInfo();
         
@@ -3884,10 +3794,6 @@ void DicomViewer::onFrameReady(int frameNumber)
             fitToWindow();
         }
         
-        auto uiEnd = std::chrono::high_resolution_clock::now();
-        auto uiDuration = std::chrono::duration_cast<std::chrono::milliseconds>(uiEnd - uiStart).count();
-        auto uiEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(uiEnd.time_since_epoch()).count();
-        
         // Enable transformations after first frame loads
         setTransformationActionsEnabled(true);
         
@@ -3899,14 +3805,21 @@ void DicomViewer::onFrameReady(int frameNumber)
         // For multi-frame images, setup playback controller but don't start timer yet
         // We want progressive display during first load, timer-based replay afterward
         if (m_totalFrames > 1) {
-            setupMultiframePlayback(m_currentImagePath);
+            setupMultiframePlayback(m_currentDataset);
         }
+    } else if (frameNumber == m_currentFrame && frameNumber != m_currentDisplayedFrame) {
+        // The frame the user jumped to has arrived - show it straight away
+        displayCachedFrame(frameNumber);
+        m_lastProgressiveDisplayTime = QDateTime::currentMSecsSinceEpoch();
     } else {
         // Implement smart progressive display strategy:
         // 1) First loading: Display frames as they become ready, but respect FPS timing
         // 2) Subsequent replays: Timer handles all display using cached frames
+        // Frames arrive in decode-window order, so the display walks on to the frame
+        // after the one shown whenever that one is in the store
+        frameNumber = (m_currentDisplayedFrame + 1) % qMax(1, m_totalFrames);
         
-        if (!m_isPlaying) {
+        if (!m_isPlaying && isFrameAvailable(frameNumber)) {
             // Progressive display strategy: Show ALL frames in sequence at target FPS
             // - If frame time has elapsed: Display immediately when frame is ready
             // - If frame arrives early: Wait until proper time, then display
@@ -3917,51 +3830,30 @@ void DicomViewer::onFrameReady(int frameNumber)
             if (m_lastProgressiveDisplayTime == 0 || 
                 (currentTime - m_lastProgressiveDisplayTime) >= frameInterval) {
                 // Frame time has elapsed OR this is first frame - display immediately
-                auto displayStart = std::chrono::high_resolution_clock::now();
-                qint64 timeSinceLastFrame = (m_lastProgressiveDisplayTime == 0) ? 0 : (currentTime - m_lastProgressiveDisplayTime);
                 displayCachedFrame(frameNumber);
-                auto displayEnd = std::chrono::high_resolution_clock::now();
-                auto displayDuration = std::chrono::duration_cast<std::chrono::milliseconds>(displayEnd - displayStart).count();
                 
                 m_currentDisplayedFrame = frameNumber;
                 m_currentFrame = frameNumber;
                 
-                auto uiEnd = std::chrono::high_resolution_clock::now();
-                auto uiDuration = std::chrono::duration_cast<std::chrono::milliseconds>(uiEnd - uiStart).count();
-                auto uiEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(uiEnd.time_since_epoch()).count();
                 updateOverlayInfo();
                 
                 m_lastProgressiveDisplayTime = currentTime;
             } else {
                 // Frame came too quickly - schedule display at the right time
                 int delayMs = frameInterval - (currentTime - m_lastProgressiveDisplayTime);
-                qint64 timeSinceLastFrame = currentTime - m_lastProgressiveDisplayTime;
-                
-                auto uiEnd = std::chrono::high_resolution_clock::now();
-                auto uiDuration = std::chrono::duration_cast<std::chrono::milliseconds>(uiEnd - uiStart).count();
-                auto uiEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(uiEnd.time_since_epoch()).count();
                 
                 // Schedule display at the precise FPS timing - NO FRAME SKIPPING
                 QTimer::singleShot(delayMs, this, [this, frameNumber]() {
-                    if (!m_isPlaying && m_frameCache.contains(frameNumber)) {
-                        auto scheduledStart = std::chrono::high_resolution_clock::now();
-                        auto scheduledStartTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(scheduledStart.time_since_epoch()).count();
+                    if (!m_isPlaying && isFrameAvailable(frameNumber)) {
+                        PerfSpan scheduledSpan("DicomViewer::onFrameReady (scheduled)", PerfStage::None);
                         qint64 actualTime = QDateTime::currentMSecsSinceEpoch();
                         
-                        
-                        auto displayStart = std::chrono::high_resolution_clock::now();
                         displayCachedFrame(frameNumber);
-                        auto displayEnd = std::chrono::high_resolution_clock::now();
-                        auto displayDuration = std::chrono::duration_cast<std::chrono::milliseconds>(displayEnd - displayStart).count();
                         
                         m_currentDisplayedFrame = frameNumber;
                         m_currentFrame = frameNumber;
                         updateOverlayInfo();
                         
-                        auto scheduledEnd = std::chrono::high_resolution_clock::now();
-                        auto scheduledDuration = std::chrono::duration_cast<std::chrono::milliseconds>(scheduledEnd - scheduledStart).count();
-                        auto scheduledEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(scheduledEnd.time_since_epoch()).count();
-                        
                         m_lastProgressiveDisplayTime = actualTime;
                     }
                 });
@@ -3971,10 +3863,10 @@ void DicomViewer::onFrameReady(int frameNumber)
     }
 }
 
-void DicomViewer::onAllFramesLoaded(int totalFrames)
+void DicomViewer::onInitialWindowLoaded(int totalFrames)
 {
     
-    m_allFramesCached = true;
+    m_initialWindowLoaded = true;
     m_isLoadingProgressively = false;
     
     // Re-enable transformation actions now that loading is complete
@@ -4046,14 +3938,17 @@ void DicomViewer::onLoadingProgress(int currentFrame, int totalFrames)
 
 void DicomViewer::displayCachedFrame(int frameIndex)
 {
-    if (m_frameCache.contains(frameIndex)) {
+    StoredFrame storedFrame = m_frameStore->frame(frameIndex);
+    if (!storedFrame.isNull()) {
+        reportPlayhead(frameIndex);
         
         // Update current frame number
         m_currentFrame = frameIndex;
         
-        // Use the cached frame as original source
-        QPixmap cachedPixmap = m_frameCache[frameIndex];
-        m_originalPixmap = cachedPixmap;  // Store the original unmodified pixmap
+        // Native frames are windowed from their samples; 8-bit frames are the pipeline source
+        m_originalPixmap = storedFrame.image.isNull()
+            ? QPixmap() : QPixmap::fromImage(storedFrame.image, Qt::NoFormatConversion);
+        m_currentPixelFrame = storedFrame.pixels;
         m_currentDisplayedFrame = frameIndex;
         
         // Process through pipeline to apply any active transformations
@@ -4066,6 +3961,21 @@ void DicomViewer::displayCachedFrame(int frameIndex)
     }
 }
 
+void DicomViewer::showFramePending(int frameIndex)
+{
+    // Keep the shown frame on screen and let the loader decode this one next;
+    // onFrameReady displays it when it arrives. The overlay marks it as loading.
+    m_currentFrame = frameIndex;
+    reportPlayhead(frameIndex);
+    updateOverlayInfo();
+}
+
+bool DicomViewer::isFrameAvailable(int frameIndex) const
+{
+    // Decoding is the loader's job; the GUI thread only shows stored frames
+    return m_frameStore->contains(frameIndex);
+}
+
 void DicomViewer::clearFrameCache()
 {
     
@@ -4084,12 +3994,12 @@ void DicomViewer::clearFrameCache()
     }
     
     // Clear all cached data
-    m_frameCache.clear();
-    m_originalPixelCache.clear();
+    m_frameStore->clear();
+    m_currentPixelFrame = DicomPixelFrame();
     m_currentFrame = 0;
     m_currentDisplayedFrame = -1;
     m_totalFrames = 1;
-    m_allFramesCached = false;
+    m_initialWindowLoaded = false;
     
 }
 
@@ -4115,17 +4025,16 @@ QString DicomViewer::cleanDicomText(const QString& text)
     return result.replace('^', ' ').trimmed();
 }
 
-void DicomViewer::extractDicomMetadata(const QString& filePath)
+void DicomViewer::extractDicomMetadata(const std::shared_ptr<DicomDatasetHandle>& datasetHandle)
 {
 #ifdef HAVE_DCMTK
     try {
-        DcmFileFormat dcmFile;
-        OFCondition status = dcmFile.loadFile(filePath.toLocal8Bit().constData());
-        if (status.bad()) {
+        if (!datasetHandle) {
             return;
         }
         
-        DcmDataset* dataset = dcmFile.getDataset();
+        QMutexLocker datasetLocker(datasetHandle->mutex());
+        DcmDataset* dataset = datasetHandle->dataset();
         if (!dataset) {
             return;
         }
@@ -4294,8 +4203,19 @@ void DicomViewer::extractDicomMetadata(const QString& filePath)
         // Extract BitsStored and BitsAllocated for proper scaling
         Uint16 bitsStored = 8;  // Default to 8-bit
         Uint16 bitsAllocated = 8;
+        Uint16 pixelRepresentation = 0;
         dataset->findAndGetUint16(DCM_BitsStored, bitsStored);
         dataset->findAndGetUint16(DCM_BitsAllocated, bitsAllocated);
+        dataset->findAndGetUint16(DCM_PixelRepresentation, pixelRepresentation);
+        
+        // Rescale Slope/Intercept map stored values to the units the window is given in
+        Float64 rescaleSlope = 1.0;
+        Float64 rescaleIntercept = 0.0;
+        dataset->findAndGetFloat64(DCM_RescaleSlope, rescaleSlope);
+        dataset->findAndGetFloat64(DCM_RescaleIntercept, rescaleIntercept);
+        if (rescaleSlope == 0.0) {
+            rescaleSlope = 1.0;
+        }
         
         // Extract Window/Level values - Tags (0028,1050) and (0028,1051)
         // Store these as the ORIGINAL DICOM values that should never be modified
@@ -4322,40 +4242,19 @@ void DicomViewer::extractDicomMetadata(const QString& filePath)
         m_currentWindowCenter = originalDicomCenter;
         m_currentWindowWidth = originalDicomWidth;
         
-        // Store BitsStored for pipeline processing
+        // Store BitsStored and rescale for pipeline processing
         m_imagePipeline->setBitsStored(bitsStored);
+        m_imagePipeline->setRescale(rescaleSlope, rescaleIntercept);
         
         // If window/level values found, apply them to the display pipeline
         if (foundWindowLevel && originalDicomWidth > 0) {
-            // IMPORTANT: DCMTK's getOutputData(8) converts >8-bit data to 8-bit range (0-255)
-            // We need to scale the window/level values from original bit depth to 8-bit range
-            
-            double pipelineCenter, pipelineWidth;
+            // The pipeline windows native stored values directly (rescaled to
+            // modality units), so the DICOM values are used unscaled
+            LOG_AT(LOG_DEBUG, QString("Window values applied: C=%1 W=%2 (BitsStored=%3, slope=%4, intercept=%5)")
+                .arg(originalDicomCenter).arg(originalDicomWidth).arg(bitsStored)
+                .arg(rescaleSlope).arg(rescaleIntercept));
             
-            if (bitsStored > 8) {
-                // For >8-bit images, scale window values to 8-bit range
-                double maxOriginalValue = (1 << bitsStored) - 1;  // e.g., 16383 for 14-bit
-                double scaleFactor = 255.0 / maxOriginalValue;    // e.g., 255/16383 ≈ 0.0156
-                
-                pipelineCenter = originalDicomCenter * scaleFactor;
-                pipelineWidth = originalDicomWidth * scaleFactor;
-                
-                logMessage("DEBUG", QString("Scaled window values: Original C=%1 W=%2 -> 8-bit C=%3 W=%4 (scale=%5, BitsStored=%6)")
-                    .arg(originalDicomCenter).arg(originalDicomWidth)
-                    .arg(pipelineCenter).arg(pipelineWidth)
-                    .arg(scaleFactor).arg(bitsStored));
-            } else {
-                // For 8-bit images, use original values
-                pipelineCenter = originalDicomCenter;
-                pipelineWidth = originalDicomWidth;
-                
-                logMessage("DEBUG", QString("Window values applied directly: C=%1 W=%2 (8-bit image, BitsStored=%3)")
-                    .arg(originalDicomCenter).arg(originalDicomWidth).arg(bitsStored));
-            }
-            
-            // Apply scaled values to pipeline (internal processing only)
-            // This does NOT affect m_currentWindowCenter/Width which are used for UI
-            m_imagePipeline->setWindowLevel(pipelineCenter, pipelineWidth);
+            m_imagePipeline->setWindowLevel(originalDicomCenter, originalDicomWidth);
             
             // Only enable if toggle button is ON
             if (m_windowLevelModeEnabled) {
@@ -4363,17 +4262,18 @@ void DicomViewer::extractDicomMetadata(const QString& filePath)
             } else {
             }
         } else {
-            // Calculate default window/level for 8-bit display
-            // Use 8-bit range (0-255) regardless of original bit depth
-            // since we're displaying on 8-bit pipeline
-            m_currentWindowWidth = 255.0;      // Full 8-bit range
-            m_currentWindowCenter = 127.5;     // Middle of 8-bit range
+            // Default window covers the full stored range, expressed in modality units
+            int bits = qBound(1, static_cast<int>(bitsStored), 16);
+            double minStored = (pixelRepresentation == 1) ? -static_cast<double>(1 << (bits - 1)) : 0.0;
+            double storedRange = static_cast<double>((1 << bits) - 1);
+            m_currentWindowWidth = storedRange * qAbs(rescaleSlope);
+            m_currentWindowCenter = (minStored + storedRange / 2.0) * rescaleSlope + rescaleIntercept;
             m_originalWindowCenter = m_currentWindowCenter;
             m_originalWindowWidth = m_currentWindowWidth;
             m_imagePipeline->setWindowLevel(m_currentWindowCenter, m_currentWindowWidth);
             
-            logMessage("DEBUG", QString("Default windowing: C=%1 W=%2 (8-bit defaults)")
-                .arg(m_currentWindowCenter).arg(m_currentWindowWidth));
+            LOG_AT(LOG_DEBUG, QString("Default windowing: C=%1 W=%2 (full %3-bit range)")
+                .arg(m_currentWindowCenter).arg(m_currentWindowWidth).arg(bits));
                 
             // Only enable if toggle button is ON
             if (m_windowLevelModeEnabled) {
@@ -4387,7 +4287,7 @@ void DicomViewer::extractDicomMetadata(const QString& filePath)
     } catch (...) {
     }
 #else
-    Q_UNUSED(filePath);
+    Q_UNUSED(datasetHandle);
 #endif
 }
 
@@ -4467,29 +4367,40 @@ void DicomViewer::onPlaybackStateChanged(DicomPlaybackController::PlaybackState
     }
 }
 
+void DicomViewer::reportPlayhead(int frameIndex)
+{
+    // Let the loader move its decode window to the playhead, and the
+    // store evict the frames furthest ahead of it
+    if (m_progressiveLoader) {
+        m_progressiveLoader->setPlayhead(frameIndex);
+    }
+    m_frameStore->setPlayhead(frameIndex, m_totalFrames);
+}
+
 void DicomViewer::onCurrentFrameChanged(int frameIndex, int totalFrames)
 {
     
     m_currentFrame = frameIndex;
     m_totalFrames = totalFrames;
     
-    if (m_frameCache.contains(frameIndex)) {
+    if (isFrameAvailable(frameIndex)) {
         displayCachedFrame(frameIndex);
         m_currentDisplayedFrame = frameIndex;
         // Update overlay only when frame is actually displayed
         updateOverlayInfo();
     } else {
-        // Do not display anything yet - wait for the actual frame to be loaded
-        // Do NOT update overlay here - frame number should only change when frame is actually shown
-        // When frameReady() is emitted, it will trigger another onCurrentFrameChanged call
-        // This ensures each frame is displayed exactly once, no duplicates
+        // Not decoded yet - it is decoded next, and onFrameReady shows it
+        // when it arrives. Each frame is still displayed exactly once.
+        showFramePending(frameIndex);
     }
 }
 
 void DicomViewer::onFrameRequested(int frameIndex)
 {
-    if (m_frameCache.contains(frameIndex)) {
+    if (isFrameAvailable(frameIndex)) {
         displayCachedFrame(frameIndex);
+    } else {
+        showFramePending(frameIndex);
     }
 }
 
@@ -4821,7 +4732,7 @@ void DicomViewer::performVideoExport(const SaveRunDialog::ExportSettings& settin
 {
     try {
         // Check if we have frames to export
-        if (m_frameCache.isEmpty()) {
+        if (m_frameStore->isEmpty()) {
             throw std::runtime_error("No frames available for video export");
         }
         
@@ -4849,14 +4760,26 @@ void DicomViewer::performVideoExport(const SaveRunDialog::ExportSettings& settin
         // Export each frame as JPEG for FFmpeg processing
         QStringList frameFiles;
         int frameCount = 0;
+        std::unique_ptr<DicomFrameProcessor> exportProcessor;
         for (int i = 0; i < m_totalFrames; ++i) {
-            if (m_frameCache.contains(i)) {
-                // Get the frame and process it through the pipeline
-                QPixmap originalFrame = m_frameCache[i];
-                m_originalPixmap = originalFrame;
-                
+            // Frames evicted under the memory budget are decoded again; the pixel
+            // data is only indexed for that when the first such frame comes up
+            StoredFrame storedFrame = m_frameStore->frame(i);
+            if (storedFrame.isNull() && m_currentDataset) {
+                if (!exportProcessor) {
+                    exportProcessor.reset(new DicomFrameProcessor());
+                    exportProcessor->loadDicomFile(m_currentDataset);
+                }
+                storedFrame.pixels = exportProcessor->decodePixelFrame(i);
+                if (storedFrame.pixels.isNull()) {
+                    storedFrame.image = exportProcessor->getFrameAsQImage(i);
+                }
+            }
+            if (!storedFrame.isNull()) {
                 // Process through pipeline to apply current transformations
-                QImage frameImage = m_imagePipeline->processImage(originalFrame.toImage());
+                QImage frameImage = !storedFrame.pixels.isNull()
+                    ? m_imagePipeline->processFrame(storedFrame.pixels)
+                    : m_imagePipeline->processImage(storedFrame.image);
                 
                 // Save frame as JPEG with sequential numbering for video processing
                 QString frameFilename = QString("frame_%1.jpg").arg(frameCount, 6, 10, QChar('0'));
@@ -4951,10 +4874,10 @@ bool DicomViewer::createMP4Video(const QString& frameDir, const QString& outputP
 {
     // Use FFmpeg to create MP4 video from JPEG frames
     
-    logMessage("DEBUG", "Starting MP4 video creation");
-    logMessage("DEBUG", QString("Frame directory: %1").arg(frameDir));
-    logMessage("DEBUG", QString("Output path: %1").arg(outputPath));
-    logMessage("DEBUG", QString("Framerate: %1").arg(framerate));
+    LOG_AT(LOG_DEBUG, "Starting MP4 video creation");
+    LOG_AT(LOG_DEBUG, QString("Frame directory: %1").arg(frameDir));
+    LOG_AT(LOG_DEBUG, QString("Output path: %1").arg(outputPath));
+    LOG_AT(LOG_DEBUG, QString("Framerate: %1").arg(framerate));
     
     // Find ffmpeg executable using our helper function
     QString ffmpegPath = findFfmpegExecutable();
@@ -4964,7 +4887,7 @@ bool DicomViewer::createMP4Video(const QString& frameDir, const QString& outputP
         return false;
     }
     
-    logMessage("DEBUG", QString("Using FFmpeg executable at: %1").arg(ffmpegPath));
+    LOG_AT(LOG_DEBUG, QString("Using FFmpeg executable at: %1").arg(ffmpegPath));
     
     // Test if ffmpeg executable is working
     QProcess testProcess;
@@ -4989,7 +4912,7 @@ bool DicomViewer::createMP4Video(const QString& frameDir, const QString& outputP
     arguments << outputPath;
     
     QString fullCommand = ffmpegPath + " " + arguments.join(" ");
-    logMessage("DEBUG", QString("FFmpeg command: %1").arg(fullCommand));
+    LOG_AT(LOG_DEBUG, QString("FFmpeg command: %1").arg(fullCommand));
     
     // Check if ffmpeg is running from DVD/CD (slower operation)
     bool isFromDVD = ffmpegPath.length() >= 2 && ffmpegPath.at(1) == ':' && 
@@ -5075,7 +4998,7 @@ bool DicomViewer::createMP4Video(const QString& frameDir, const QString& outputP
         return false;
     }
     
-    logMessage("DEBUG", QString("FFmpeg video creation successful: %1").arg(outputPath));
+    LOG_AT(LOG_DEBUG, QString("FFmpeg video creation successful: %1").arg(outputPath));
     return true;
 }
 
@@ -5087,616 +5010,25 @@ void DicomViewer::displayReport(const QString& filePath)
         return;
     }
     
-    QString reportContent = formatSRReport(filePath);
-    m_reportArea->setHtml(reportContent);
+    // A dose report with hundreds of irradiation events takes seconds to parse,
+    // so the file is read once into a content tree and rendered on a worker.
+    // Only the result of the most recent request is shown.
+    const quint64 requestId = ++m_reportRequestId;
+    m_reportArea->setHtml(QString("<html><body style='font-family: Arial, sans-serif; color: #7f8c8d; margin: 20px;'>"
+                                  "Loading report %1...</body></html>").arg(QFileInfo(filePath).fileName().toHtmlEscaped()));
+    
+    // Ahead of queued thumbnails; the destructor waits for the pool
+    m_thumbnailPool.start([this, filePath, requestId]() {
+        QString html = DicomSRHtmlRenderer::render(DicomSRDocument::load(filePath));
+        QMetaObject::invokeMethod(this, [this, requestId, html]() {
+            if (requestId == m_reportRequestId && m_reportArea) {
+                m_reportArea->setHtml(html);
+            }
+        }, Qt::QueuedConnection);
+    }, 1);
 }
 
-QString DicomViewer::formatSRReport(const QString& filePath)
-{
-    #ifdef HAVE_DCMTK
-    try {
-        // First check if the file path is valid
-        QFileInfo fileInfo(filePath);
-        if (!fileInfo.exists()) {
-            return QString("<!DOCTYPE html><html><head><style>.error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; padding: 15px; border: 1px solid #fadbd8; font-family: Arial, sans-serif; }</style></head><body><div class='error'>Error: File does not exist<br><br>File: %1<br>Check if the file path is correct.</div></body></html>")
-                   .arg(filePath);
-        }
-        
-        if (fileInfo.isDir()) {
-            return QString("<!DOCTYPE html><html><head><style>.error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; padding: 15px; border: 1px solid #fadbd8; font-family: Arial, sans-serif; }</style></head><body><div class='error'>Error: Path is a directory, not a file<br><br>Path: %1<br>SR documents must be individual DICOM files.</div></body></html>")
-                   .arg(filePath);
-        }
-        
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return QString("<!DOCTYPE html><html><head><style>.error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; padding: 15px; border: 1px solid #fadbd8; font-family: Arial, sans-serif; }</style></head><body><div class='error'>Error: Could not load DICOM file<br><br>File: %1<br>Error: %2<br>File size: %3 bytes</div></body></html>")
-                   .arg(filePath, result.text())
-                   .arg(fileInfo.size());
-        }
-        
-        DcmDataset *dataset = fileformat.getDataset();
-        if (!dataset) {
-            return QString("<!DOCTYPE html><html><head><style>.error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; padding: 15px; border: 1px solid #fadbd8; font-family: Arial, sans-serif; }</style></head><body><div class='error'>Error: No dataset found in DICOM file<br><br>File: %1</div></body></html>").arg(filePath);
-        }
-        
-        // Check if it's a Radiation Dose SR
-        if (isRadiationDoseSR(filePath)) {
-            return formatRadiationDoseReport(filePath);
-        }
-        
-        // For other SR types, show basic info with HTML formatting
-        QString report;
-        
-        // Start HTML document with professional styling
-        report += "<!DOCTYPE html><html><head><style>";
-        report += "body { font-family: 'Segoe UI', Tahoma, Arial, sans-serif; font-size: 11pt; line-height: 1.4; margin: 20px; background-color: #fdfdfd; }";
-        report += "h1 { font-size: 18pt; font-weight: bold; color: #2c3e50; text-align: center; margin: 20px 0; border-bottom: 3px solid #3498db; padding-bottom: 10px; }";
-        report += "h2 { font-size: 14pt; font-weight: bold; color: #34495e; margin: 20px 0 10px 0; border-left: 4px solid #3498db; padding-left: 10px; background-color: #f8f9fa; padding: 8px; }";
-        report += ".info-row { margin: 8px 0; padding: 4px 0; border-bottom: 1px dotted #ddd; }";
-        report += ".label { font-weight: bold; color: #2c3e50; display: inline-block; min-width: 150px; }";
-        report += ".value { color: #34495e; }";
-        report += ".warning { color: #f39c12; font-weight: bold; background-color: #fef9e7; padding: 10px; border: 1px solid #fcf3cf; margin: 10px 0; }";
-        report += "</style></head><body>";
-        
-        report += "<h1>Structured Report Document</h1>";
-        report += "<h2>Basic Information</h2>";
-        report += QString("<div class='info-row'><span class='label'>File Path:</span> <span class='value'>%1</span></div>").arg(filePath);
-        
-        // Try to get basic SR info
-        OFString sopClassUID, modality, conceptNameCodeMeaning;
-        if (dataset->findAndGetOFString(DCM_SOPClassUID, sopClassUID).good()) {
-            report += QString("<div class='info-row'><span class='label'>SOP Class UID:</span> <span class='value'>%1</span></div>").arg(sopClassUID.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_Modality, modality).good()) {
-            report += QString("<div class='info-row'><span class='label'>Modality:</span> <span class='value'>%1</span></div>").arg(modality.c_str());
-        }
-        
-        report += "<div class='warning'>";
-        report += "<strong>Note:</strong> This structured report type is not fully supported for detailed formatting.<br>";
-        report += "Please use a dedicated DICOM viewer for complete SR analysis.";
-        report += "</div>";
-        
-        report += "</body></html>";
-        
-        return report;
-        
-    } catch (const std::exception& e) {
-        return QString("Error: Exception occurred while reading DICOM file\n\nFile: %1\nError: %2")
-               .arg(filePath, e.what());
-    }
-    #else
-    return QString("Error: DCMTK support not available\n\nFile: %1\n\nDCMTK library is required for DICOM file reading.")
-           .arg(filePath);
-    #endif
-}
-
-bool DicomViewer::isRadiationDoseSR(const QString& filePath)
-{
-    #ifdef HAVE_DCMTK
-    try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return false;
-        }
-        
-        DcmDataset *dataset = fileformat.getDataset();
-        if (!dataset) {
-            return false;
-        }
-        
-        // Check SOP Class UID for X-Ray Radiation Dose SR
-        OFString sopClassUID;
-        if (dataset->findAndGetOFString(DCM_SOPClassUID, sopClassUID).good()) {
-            // X-Ray Radiation Dose SR SOP Class UID
-            if (sopClassUID == "1.2.840.10008.5.1.4.1.1.88.67") {
-                return true;
-            }
-        }
-        
-        // Also check concept name code meaning in content sequence
-        DcmSequenceOfItems *contentSeq = nullptr;
-        if (dataset->findAndGetSequence(DCM_ContentSequence, contentSeq).good() && contentSeq) {
-            for (unsigned long i = 0; i < contentSeq->card(); i++) {
-                DcmItem *item = contentSeq->getItem(i);
-                if (item) {
-                    DcmSequenceOfItems *conceptNameSeq = nullptr;
-                    if (item->findAndGetSequence(DCM_ConceptNameCodeSequence, conceptNameSeq).good() && conceptNameSeq && conceptNameSeq->card() > 0) {
-                        DcmItem *conceptItem = conceptNameSeq->getItem(0);
-                        if (conceptItem) {
-                            OFString codeMeaning;
-                            if (conceptItem->findAndGetOFString(DCM_CodeMeaning, codeMeaning).good()) {
-                                if (codeMeaning.find("Dose Report") != OFString_npos ||
-                                    codeMeaning.find("Radiation Dose") != OFString_npos ||
-                                    codeMeaning.find("X-Ray Dose") != OFString_npos) {
-                                    return true;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        
-        return false;
-        
-    } catch (const std::exception& e) {
-        return false;
-    }
-    #else
-    return false;
-    #endif
-}
-
-QString DicomViewer::formatRadiationDoseReport(const QString& filePath)
-{
-    QString report;
-    
-    // Start HTML document with professional styling
-    report += "<!DOCTYPE html><html><head><style>";
-    report += "body { font-family: 'Segoe UI', Tahoma, Arial, sans-serif; font-size: 11pt; line-height: 1.4; margin: 20px; background-color: #fdfdfd; }";
-    report += "h1 { font-size: 18pt; font-weight: bold; color: #2c3e50; text-align: center; margin: 20px 0; border-bottom: 3px solid #3498db; padding-bottom: 10px; }";
-    report += "h2 { font-size: 14pt; font-weight: bold; color: #34495e; margin: 20px 0 10px 0; border-left: 4px solid #3498db; padding-left: 10px; background-color: #f8f9fa; padding: 8px; }";
-    report += "h3 { font-size: 12pt; font-weight: bold; color: #2c3e50; margin: 15px 0 8px 0; }";
-    report += ".info-row { margin: 8px 0; padding: 4px 0; border-bottom: 1px dotted #ddd; }";
-    report += ".label { font-weight: bold; color: #2c3e50; display: inline-block; min-width: 150px; }";
-    report += ".value { color: #34495e; }";
-    report += ".event { background-color: #f8f9fa; margin: 10px 0; padding: 15px; border-left: 3px solid #e74c3c; }";
-    report += ".measurement { margin: 5px 0 5px 20px; }";
-    report += ".error { color: #e74c3c; font-weight: bold; background-color: #fdf2f2; padding: 10px; border: 1px solid #fadbd8; }";
-    report += "</style></head><body>";
-    
-    // Main Header
-    report += "<h1>RADIATION DOSE STRUCTURED REPORT</h1>";
-    
-    // Add sections
-    report += formatRDSRHeader(filePath);
-    report += formatRDSRProcedureInfo(filePath);
-    report += formatAccumulatedDoseData(filePath);
-    report += formatIrradiationEvents(filePath);
-    
-    // Close HTML
-    report += "</body></html>";
-    
-    return report;
-}
-
-QString DicomViewer::formatRDSRHeader(const QString& filePath)
-{
-    #ifdef HAVE_DCMTK
-    try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return "Error: Could not load DICOM file for header information";
-        }
-        
-        DcmDataset *dataset = fileformat.getDataset();
-        if (!dataset) {
-            return "Error: No dataset found";
-        }
-        
-        QString header;
-        header += "<h2>Patient & Study Information</h2>";
-        
-        // Patient Information
-        OFString patientName, patientID, patientSex, patientAge;
-        if (dataset->findAndGetOFString(DCM_PatientName, patientName).good()) {
-            QString cleanName = QString(patientName.c_str()).replace("^", " ").trimmed();
-            header += QString("<div class='info-row'><span class='label'>Patient Name:</span> <span class='value'>%1</span></div>").arg(cleanName);
-        }
-        if (dataset->findAndGetOFString(DCM_PatientID, patientID).good()) {
-            header += QString("<div class='info-row'><span class='label'>Patient ID:</span> <span class='value'>%1</span></div>").arg(patientID.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_PatientSex, patientSex).good()) {
-            header += QString("<div class='info-row'><span class='label'>Patient Sex:</span> <span class='value'>%1</span></div>").arg(patientSex.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_PatientAge, patientAge).good()) {
-            header += QString("<div class='info-row'><span class='label'>Patient Age:</span> <span class='value'>%1</span></div>").arg(patientAge.c_str());
-        }
-        
-        // Study Information
-        OFString studyDate, studyTime, studyDescription, institutionName;
-        if (dataset->findAndGetOFString(DCM_StudyDate, studyDate).good()) {
-            header += QString("<div class='info-row'><span class='label'>Study Date:</span> <span class='value'>%1</span></div>").arg(formatDateTime(studyDate.c_str()));
-        }
-        if (dataset->findAndGetOFString(DCM_StudyTime, studyTime).good()) {
-            header += QString("<div class='info-row'><span class='label'>Study Time:</span> <span class='value'>%1</span></div>").arg(formatDateTime(studyTime.c_str()));
-        }
-        if (dataset->findAndGetOFString(DCM_StudyDescription, studyDescription).good()) {
-            header += QString("<div class='info-row'><span class='label'>Study Description:</span> <span class='value'>%1</span></div>").arg(studyDescription.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_InstitutionName, institutionName).good()) {
-            header += QString("<div class='info-row'><span class='label'>Institution:</span> <span class='value'>%1</span></div>").arg(institutionName.c_str());
-        }
-        
-        header += "<h3>Device Information</h3>";
-        
-        // Device Information
-        OFString manufacturer, manufacturerModelName, deviceSerialNumber;
-        if (dataset->findAndGetOFString(DCM_Manufacturer, manufacturer).good()) {
-            header += QString("<div class='info-row'><span class='label'>Manufacturer:</span> <span class='value'>%1</span></div>").arg(manufacturer.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_ManufacturerModelName, manufacturerModelName).good()) {
-            header += QString("<div class='info-row'><span class='label'>Device Model:</span> <span class='value'>%1</span></div>").arg(manufacturerModelName.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_DeviceSerialNumber, deviceSerialNumber).good()) {
-            header += QString("<div class='info-row'><span class='label'>Serial Number:</span> <span class='value'>%1</span></div>").arg(deviceSerialNumber.c_str());
-        }
-        
-        return header;
-        
-    } catch (const std::exception& e) {
-        return QString("<div class='error'>Error reading header: %1</div>").arg(e.what());
-    }
-    #else
-    return "Error: DCMTK support not available";
-    #endif
-}
-
-QString DicomViewer::formatRDSRProcedureInfo(const QString& filePath)
-{
-    #ifdef HAVE_DCMTK
-    try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return "Error: Could not load DICOM file for procedure information";
-        }
-        
-        DcmDataset *dataset = fileformat.getDataset();
-        if (!dataset) {
-            return "Error: No dataset found";
-        }
-        
-        QString procedure;
-        procedure += "<h2>Procedure Information</h2>";
-        
-        // Basic procedure info
-        OFString studyDescription, seriesDescription, protocolName;
-        if (dataset->findAndGetOFString(DCM_StudyDescription, studyDescription).good()) {
-            procedure += QString("<div class='info-row'><span class='label'>Procedure:</span> <span class='value'>%1</span></div>").arg(studyDescription.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_SeriesDescription, seriesDescription).good()) {
-            procedure += QString("<div class='info-row'><span class='label'>Series Description:</span> <span class='value'>%1</span></div>").arg(seriesDescription.c_str());
-        }
-        if (dataset->findAndGetOFString(DCM_ProtocolName, protocolName).good()) {
-            procedure += QString("<div class='info-row'><span class='label'>Protocol:</span> <span class='value'>%1</span></div>").arg(protocolName.c_str());
-        }
-        
-        // Try to extract procedure info from content sequence
-        DcmSequenceOfItems *contentSeq = nullptr;
-        if (dataset->findAndGetSequence(DCM_ContentSequence, contentSeq).good() && contentSeq) {
-            for (unsigned long i = 0; i < contentSeq->card(); i++) {
-                DcmItem *item = contentSeq->getItem(i);
-                if (item) {
-                    // Look for procedure-related information in the structured content
-                    DcmSequenceOfItems *conceptNameSeq = nullptr;
-                    if (item->findAndGetSequence(DCM_ConceptNameCodeSequence, conceptNameSeq).good() && 
-                        conceptNameSeq && conceptNameSeq->card() > 0) {
-                        DcmItem *conceptItem = conceptNameSeq->getItem(0);
-                        if (conceptItem) {
-                            OFString codeMeaning;
-                            if (conceptItem->findAndGetOFString(DCM_CodeMeaning, codeMeaning).good()) {
-                                // Look for procedure-specific information
-                                if (codeMeaning.find("Procedure") != OFString_npos ||
-                                    codeMeaning.find("Protocol") != OFString_npos) {
-                                    
-                                    OFString textValue;
-                                    if (item->findAndGetOFString(DCM_TextValue, textValue).good()) {
-                                        procedure += QString("Protocol Detail: %1\n").arg(textValue.c_str());
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        
-        if (procedure.endsWith(QString("-").repeated(30) + "\n")) {
-            procedure += "No detailed procedure information available\n";
-        }
-        
-        return procedure;
-        
-    } catch (const std::exception& e) {
-        return QString("Error reading procedure info: %1").arg(e.what());
-    }
-    #else
-    return "Error: DCMTK support not available";
-    #endif
-}
-
-QString DicomViewer::formatAccumulatedDoseData(const QString& filePath)
-{
-    #ifdef HAVE_DCMTK
-    try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return "Error: Could not load DICOM file for dose data";
-        }
-        
-        DcmDataset *dataset = fileformat.getDataset();
-        if (!dataset) {
-            return "Error: No dataset found";
-        }
-        
-        QString doseData;
-        doseData += "<h2>Accumulated Dose Data</h2>";
-        
-        // Look for dose measurements in content sequence
-        DcmSequenceOfItems *contentSeq = nullptr;
-        if (dataset->findAndGetSequence(DCM_ContentSequence, contentSeq).good() && contentSeq) {
-            
-            QStringList foundDoseValues;
-            
-            for (unsigned long i = 0; i < contentSeq->card(); i++) {
-                DcmItem *item = contentSeq->getItem(i);
-                if (item) {
-                    DcmSequenceOfItems *conceptNameSeq = nullptr;
-                    if (item->findAndGetSequence(DCM_ConceptNameCodeSequence, conceptNameSeq).good() && 
-                        conceptNameSeq && conceptNameSeq->card() > 0) {
-                        
-                        DcmItem *conceptItem = conceptNameSeq->getItem(0);
-                        if (conceptItem) {
-                            OFString codeMeaning;
-                            if (conceptItem->findAndGetOFString(DCM_CodeMeaning, codeMeaning).good()) {
-                                
-                                // Look for various dose measurements
-                                QString conceptStr = QString(codeMeaning.c_str());
-                                
-                                if (conceptStr.contains("Dose", Qt::CaseInsensitive) ||
-                                    conceptStr.contains("DAP", Qt::CaseInsensitive) ||
-                                    conceptStr.contains("Air Kerma", Qt::CaseInsensitive) ||
-                                    conceptStr.contains("Exposure", Qt::CaseInsensitive)) {
-                                    
-                                    // Get the measured value
-                                    DcmSequenceOfItems *measuredValueSeq = nullptr;
-                                    if (item->findAndGetSequence(DCM_MeasuredValueSequence, measuredValueSeq).good() && 
-                                        measuredValueSeq && measuredValueSeq->card() > 0) {
-                                        
-                                        DcmItem *measuredItem = measuredValueSeq->getItem(0);
-                                        if (measuredItem) {
-                                            OFString numericValue;
-                                            if (measuredItem->findAndGetOFString(DCM_NumericValue, numericValue).good()) {
-                                                
-                                                // Get units if available
-                                                DcmSequenceOfItems *measurementUnitsSeq = nullptr;
-                                                QString unit = "";
-                                                if (measuredItem->findAndGetSequence(DCM_MeasurementUnitsCodeSequence, measurementUnitsSeq).good() && 
-                                                    measurementUnitsSeq && measurementUnitsSeq->card() > 0) {
-                                                    
-                                                    DcmItem *unitItem = measurementUnitsSeq->getItem(0);
-                                                    if (unitItem) {
-                                                        OFString unitMeaning;
-                                                        if (unitItem->findAndGetOFString(DCM_CodeMeaning, unitMeaning).good()) {
-                                                            unit = QString(unitMeaning.c_str());
-                                                        }
-                                                    }
-                                                }
-                                                
-                                                QString measurement = formatMeasurement(conceptStr, QString(numericValue.c_str()), unit);
-                                                if (!foundDoseValues.contains(measurement)) {
-                                                    foundDoseValues.append(measurement);
-                                                    doseData += measurement + "\n";
-                                                }
-                                            }
-                                        }
-                                    }
-                                    
-                                    // Also check for simple text values
-                                    OFString textValue;
-                                    if (item->findAndGetOFString(DCM_TextValue, textValue).good()) {
-                                        QString measurement = formatMeasurement(conceptStr, QString(textValue.c_str()));
-                                        if (!foundDoseValues.contains(measurement)) {
-                                            foundDoseValues.append(measurement);
-                                            doseData += measurement + "\n";
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            
-            if (foundDoseValues.isEmpty()) {
-                doseData += "No dose measurements found in structured report\n";
-            }
-        } else {
-            doseData += "No content sequence found\n";
-        }
-        
-        return doseData;
-        
-    } catch (const std::exception& e) {
-        return QString("Error reading dose data: %1").arg(e.what());
-    }
-    #else
-    return "Error: DCMTK support not available";
-    #endif
-}
-
-QString DicomViewer::formatIrradiationEvents(const QString& filePath)
-{
-    #ifdef HAVE_DCMTK
-    try {
-        DcmFileFormat fileformat;
-        OFCondition result = fileformat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (result.bad()) {
-            return "Error: Could not load DICOM file for irradiation events";
-        }
-        
-        DcmDataset *dataset = fileformat.getDataset();
-        if (!dataset) {
-            return "Error: No dataset found";
-        }
-        
-        QString events;
-        events += "<h2>Irradiation Events</h2>";
-        
-        // Look for irradiation event data in content sequence
-        DcmSequenceOfItems *contentSeq = nullptr;
-        if (dataset->findAndGetSequence(DCM_ContentSequence, contentSeq).good() && contentSeq) {
-            
-            int eventCount = 0;
-            
-            for (unsigned long i = 0; i < contentSeq->card(); i++) {
-                DcmItem *item = contentSeq->getItem(i);
-                if (item) {
-                    DcmSequenceOfItems *conceptNameSeq = nullptr;
-                    if (item->findAndGetSequence(DCM_ConceptNameCodeSequence, conceptNameSeq).good() && 
-                        conceptNameSeq && conceptNameSeq->card() > 0) {
-                        
-                        DcmItem *conceptItem = conceptNameSeq->getItem(0);
-                        if (conceptItem) {
-                            OFString codeMeaning;
-                            if (conceptItem->findAndGetOFString(DCM_CodeMeaning, codeMeaning).good()) {
-                                
-                                QString conceptStr = QString(codeMeaning.c_str());
-                                
-                                // Look for irradiation events
-                                if (conceptStr.contains("Irradiation Event", Qt::CaseInsensitive) ||
-                                    conceptStr.contains("Radiation Event", Qt::CaseInsensitive) ||
-                                    conceptStr.contains("Exposure Event", Qt::CaseInsensitive)) {
-                                    
-                                    eventCount++;
-                                    events += QString("<div class='event'><h3>Event %1</h3>").arg(eventCount);
-                                    
-                                    // Look for child sequences containing event details
-                                    DcmSequenceOfItems *childContentSeq = nullptr;
-                                    if (item->findAndGetSequence(DCM_ContentSequence, childContentSeq).good() && childContentSeq) {
-                                        
-                                        for (unsigned long j = 0; j < childContentSeq->card(); j++) {
-                                            DcmItem *childItem = childContentSeq->getItem(j);
-                                            if (childItem) {
-                                                DcmSequenceOfItems *childConceptSeq = nullptr;
-                                                if (childItem->findAndGetSequence(DCM_ConceptNameCodeSequence, childConceptSeq).good() && 
-                                                    childConceptSeq && childConceptSeq->card() > 0) {
-                                                    
-                                                    DcmItem *childConceptItem = childConceptSeq->getItem(0);
-                                                    if (childConceptItem) {
-                                                        OFString childCodeMeaning;
-                                                        if (childConceptItem->findAndGetOFString(DCM_CodeMeaning, childCodeMeaning).good()) {
-                                                            
-                                                            QString childConceptStr = QString(childCodeMeaning.c_str());
-                                                            
-                                                            // Get value for this concept
-                                                            OFString textValue;
-                                                            if (childItem->findAndGetOFString(DCM_TextValue, textValue).good()) {
-                                                                events += formatMeasurement(childConceptStr, QString(textValue.c_str()), QString(), 2) + "\n";
-                                                            } else {
-                                                                // Check for measured values
-                                                                DcmSequenceOfItems *childMeasuredSeq = nullptr;
-                                                                if (childItem->findAndGetSequence(DCM_MeasuredValueSequence, childMeasuredSeq).good() && 
-                                                                    childMeasuredSeq && childMeasuredSeq->card() > 0) {
-                                                                    
-                                                                    DcmItem *childMeasuredItem = childMeasuredSeq->getItem(0);
-                                                                    if (childMeasuredItem) {
-                                                                        OFString numericValue;
-                                                                        if (childMeasuredItem->findAndGetOFString(DCM_NumericValue, numericValue).good()) {
-                                                                            
-                                                                            QString unit = "";
-                                                                            DcmSequenceOfItems *unitSeq = nullptr;
-                                                                            if (childMeasuredItem->findAndGetSequence(DCM_MeasurementUnitsCodeSequence, unitSeq).good() && 
-                                                                                unitSeq && unitSeq->card() > 0) {
-                                                                                DcmItem *unitItem = unitSeq->getItem(0);
-                                                                                if (unitItem) {
-                                                                                    OFString unitMeaning;
-                                                                                    if (unitItem->findAndGetOFString(DCM_CodeMeaning, unitMeaning).good()) {
-                                                                                        unit = QString(unitMeaning.c_str());
-                                                                                    }
-                                                                                }
-                                                                            }
-                                                                            
-                                                                            events += formatMeasurement(childConceptStr, QString(numericValue.c_str()), unit, 2) + "\n";
-                                                                        }
-                                                                    }
-                                                                }
-                                                            }
-                                                        }
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                    
-                                    events += "</div>";
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            
-            if (eventCount == 0) {
-                events += "<div class='info-row'>No irradiation events found in structured report</div>";
-            }
-        } else {
-            events += "<div class='info-row'>No content sequence found</div>";
-        }
-        
-        return events;
-        
-    } catch (const std::exception& e) {
-        return QString("<div class='error'>Error reading irradiation events: %1</div>").arg(e.what());
-    }
-    #else
-    return "Error: DCMTK support not available";
-    #endif
-}
-
-QString DicomViewer::formatDateTime(const QString& dtString)
-{
-    if (dtString.length() >= 8) {
-        QString year = dtString.mid(0, 4);
-        QString month = dtString.mid(4, 2);
-        QString day = dtString.mid(6, 2);
-        
-        QString formatted = QString("%1-%2-%3").arg(day, month, year);
-        
-        if (dtString.length() >= 14) {
-            QString hour = dtString.mid(8, 2);
-            QString minute = dtString.mid(10, 2);
-            QString second = dtString.mid(12, 2);
-            formatted += QString(" %1:%2:%3").arg(hour, minute, second);
-        }
-        
-        return formatted;
-    }
-    
-    return dtString;
-}
-
-QString DicomViewer::formatMeasurement(const QString& name, const QString& value, const QString& unit, int indent)
-{
-    Q_UNUSED(indent); // Not needed for HTML formatting
-    
-    QString result = QString("<div class='measurement'><span class='label'>%1:</span> <span class='value'>%2").arg(name, value);
-    
-    if (!unit.isEmpty() && unit != value) {
-        QString cleanUnit = unit;
-        // Fix degree symbol encoding issues
-        if (cleanUnit.contains("?") || cleanUnit.contains("?") || cleanUnit.toLower().contains("degree")) {
-            cleanUnit = "degrees";
-        }
-        result += " " + cleanUnit;
-    }
-    
-    result += "</span></div>";
-    return result;
-}
-
-QString DicomViewer::getCodeSequenceValue(const QString& filePath, const QString& tagPath)
+QString DicomViewer::getCodeSequenceValue(const QString& filePath, const QString& tagPath)
 {
     // This is a placeholder for more complex code sequence navigation
     // In a full implementation, this would navigate through nested sequences
@@ -5797,7 +5129,7 @@ void DicomViewer::updateStatusBar(const QString& message, int progress)
 
 void DicomViewer::toggleDicomInfo()
 {
-    logMessage("DEBUG", "[DICOM INFO] toggleDicomInfo() called");
+    LOG_AT(LOG_DEBUG, "[DICOM INFO] toggleDicomInfo() called");
     
     if (!m_dicomInfoWidget) {
         logMessage("ERROR", "[DICOM INFO] ERROR: m_dicomInfoWidget is null!");
@@ -5805,7 +5137,7 @@ void DicomViewer::toggleDicomInfo()
     }
     
     m_dicomInfoVisible = !m_dicomInfoVisible;
-    logMessage("DEBUG", QString("[DICOM INFO] Toggled to visible: %1").arg(m_dicomInfoVisible));
+    LOG_AT(LOG_DEBUG, QString("[DICOM INFO] Toggled to visible: %1").arg(m_dicomInfoVisible));
     
     if (m_dicomInfoVisible) {
         // Show the panel (it's now inline in the layout like Python version)
@@ -5814,137 +5146,137 @@ void DicomViewer::toggleDicomInfo()
             populateDicomInfo(m_currentImagePath);
         } else {
             // Show default message if no image is loaded
-            if (m_dicomInfoTextEdit) {
-                m_dicomInfoTextEdit->setHtml("<div style='text-align: center; padding: 20px; color: white; background-color: #2a2a2a;'>"
-                                           "<h3>DICOM Tags</h3><p>No image loaded. Please select a DICOM image to view its tags.</p></div>");
+            if (m_dicomInfoMessage) {
+                m_dicomInfoMessage->setText("No image loaded. Please select a DICOM image to view its tags.");
+                m_dicomInfoMessage->show();
+                m_dicomInfoView->hide();
             }
         }
         
         m_dicomInfoWidget->show();
-        logMessage("DEBUG", QString("[DICOM INFO] Widget should now be visible. IsVisible: %1").arg(m_dicomInfoWidget->isVisible()));
+        LOG_AT(LOG_DEBUG, QString("[DICOM INFO] Widget should now be visible. IsVisible: %1").arg(m_dicomInfoWidget->isVisible()));
     } else {
         m_dicomInfoWidget->hide();
-        logMessage("DEBUG", "[DICOM INFO] Widget hidden");
+        LOG_AT(LOG_DEBUG, "[DICOM INFO] Widget hidden");
     }
 }
 
+void DicomViewer::createDicomInfoPanel()
+{
+    m_dicomInfoWidget = new QFrame;
+    m_dicomInfoWidget->setObjectName("dicom_info_panel"); 
+    m_dicomInfoWidget->setFixedWidth(400);  // Same as Python version
+    m_dicomInfoWidget->setStyleSheet("QFrame#dicom_info_panel { background-color: #2a2a2a; border-right: 1px solid #666; }");
+    m_dicomInfoWidget->hide();  // Initially hidden like Python
+    
+    QVBoxLayout* dicomInfoLayout = new QVBoxLayout(m_dicomInfoWidget);
+    dicomInfoLayout->setContentsMargins(0, 0, 0, 0);
+    dicomInfoLayout->setSpacing(0);
+    
+    // Header with title (like Python)
+    QVBoxLayout* headerLayout = new QVBoxLayout;
+    headerLayout->setContentsMargins(5, 5, 5, 5);
+    
+    QLabel* titleLabel = new QLabel("DICOM Tags");
+    titleLabel->setStyleSheet("color: white; font-weight: bold; font-size: 14px; padding: 5px;");
+    headerLayout->addWidget(titleLabel);
+    
+    dicomInfoLayout->addLayout(headerLayout);
+    
+    // Tag tree; rows and sequence contents are created by the model as they scroll or expand into view
+    m_dicomTagModel = new DicomTagModel(this);
+    m_dicomInfoView = new QTreeView;
+    m_dicomInfoView->setObjectName("dicom_info_view");
+    m_dicomInfoView->setModel(m_dicomTagModel);
+    m_dicomInfoView->setUniformRowHeights(true);
+    m_dicomInfoView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_dicomInfoView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_dicomInfoView->setIndentation(12);
+    m_dicomInfoView->setColumnWidth(DicomTagModel::TagColumn, 95);
+    m_dicomInfoView->setColumnWidth(DicomTagModel::NameColumn, 180);
+    m_dicomInfoView->header()->setStretchLastSection(true);
+    m_dicomInfoView->setStyleSheet(R"(
+        QTreeView {
+            background-color: #2b2b2b;
+            alternate-background-color: #2a2a2a;
+            color: white;
+            border: 1px solid #666666;
+            font-size: 11px;
+            selection-background-color: #0078d4;
+        }
+        QTreeView::item {
+            border-bottom: 1px solid #444444;
+            padding: 1px 4px;
+        }
+        QHeaderView::section {
+            background-color: #404040;
+            color: white;
+            font-weight: bold;
+            padding: 4px;
+            border: 1px solid #666666;
+        }
+    )");
+    dicomInfoLayout->addWidget(m_dicomInfoView);
+    
+    m_dicomInfoMessage = new QLabel;
+    m_dicomInfoMessage->setAlignment(Qt::AlignCenter);
+    m_dicomInfoMessage->setWordWrap(true);
+    m_dicomInfoMessage->setStyleSheet("color: white; background-color: #2a2a2a; padding: 20px;");
+    m_dicomInfoMessage->hide();
+    dicomInfoLayout->addWidget(m_dicomInfoMessage);
+}
+
 void DicomViewer::populateDicomInfo(const QString& filePath)
 {
-    if (!m_dicomInfoWidget || !m_dicomInfoTextEdit || filePath.isEmpty()) {
+    if (!m_dicomInfoWidget || !m_dicomTagModel || filePath.isEmpty()) {
         return;
     }
     
-    // Check if we already have cached HTML for this file
-    if (m_cachedDicomInfoFilePath == filePath && !m_cachedDicomInfoHtml.isEmpty()) {
-        m_dicomInfoTextEdit->setHtml(m_cachedDicomInfoHtml);
+    // The open image's dataset is already parsed and is shown straight away
+    const quint64 requestId = ++m_dicomInfoRequestId;
+    if (m_currentDataset && QFileInfo(m_currentDataset->filePath()) == QFileInfo(filePath)) {
+        showDicomInfo(filePath, m_currentDataset);
         return;
     }
     
-#ifdef HAVE_DCMTK
-    try {
-        DcmFileFormat fileFormat;
-        OFCondition status = fileFormat.loadFile(filePath.toLocal8Bit().constData());
-        
-        if (status.bad()) {
-            m_dicomInfoTextEdit->setPlainText(QString("Error reading DICOM file: %1").arg(status.text()));
-            return;
-        }
-        
-        DcmDataset* dataset = fileFormat.getDataset();
-        if (!dataset) {
-            m_dicomInfoTextEdit->setPlainText("Error: No dataset found in DICOM file");
-            return;
-        }
-        
-        // Helper lambda to get VR-based color like Python version
-        auto getVRColor = [](const QString& vr) -> QString {
-            if (vr == "SQ") {
-                return "#6496FF";  // Sequences in blue (100, 150, 255)
-            } else if (vr == "UI" || vr == "SH" || vr == "LO" || vr == "ST" || vr == "LT" || vr == "UT" || vr == "CS" || vr == "PN") {
-                return "#96FF96";  // String types in light green (150, 255, 150) 
-            } else if (vr == "US" || vr == "SS" || vr == "UL" || vr == "SL" || vr == "FL" || vr == "FD" || vr == "DS" || vr == "IS") {
-                return "#FFFF96";  // Numeric types in yellow (255, 255, 150)
-            } else {
-                return "#FFFFFF";  // Default white (255, 255, 255)
-            }
-        };
-        
-        // Helper lambda to create DICOM tag row with VR-based coloring like Python
-        auto formatDicomTag = [&](DcmElement* elem) -> QString {
-            DcmTag tag = elem->getTag();
-            QString tagStr = QString("(%1,%2)").arg(tag.getGTag(), 4, 16, QChar('0')).arg(tag.getETag(), 4, 16, QChar('0')).toUpper();
-            DcmVR vr(elem->getVR());
-            QString vrStr = QString::fromLatin1(vr.getVRName());
-            QString color = getVRColor(vrStr);
-            
-            // Get tag name 
-            QString tagName = QString::fromLatin1(tag.getTagName());
-            if (tagName.isEmpty()) {
-                tagName = QString("Unknown Tag %1").arg(tagStr);
-            }
-            
-            // Get value
-            QString value;
-            OFString ofString;
-            if (elem->getOFString(ofString, 0).good()) {
-                value = QString::fromLatin1(ofString.c_str());
-                if (value.length() > 100) {
-                    value = value.left(97) + "...";
-                }
-            } else {
-                value = "[Empty]";
-            }
-            
-            return QString("<tr style='background-color: #2a2a2a;'>"
-                          "<td style='color: %1; font-family: Consolas, monospace; font-size: 10px; padding: 2px 6px; border: 1px solid #444;'>%2</td>"
-                          "<td style='color: %1; font-weight: bold; padding: 2px 6px; border: 1px solid #444;'>%3</td>"
-                          "<td style='color: %1; font-family: Consolas, monospace; font-size: 11px; padding: 2px 6px; border: 1px solid #444; word-break: break-all;'>%4</td>"
-                          "</tr>").arg(color, tagStr, tagName, value);
-        };
-        
-        QString htmlContent = "<html><body style='margin: 0; padding: 8px; background-color: #1e1e1e; font-family: \"Segoe UI\", Arial, sans-serif; font-size: 11px;'>";
-        
-        // Add professional title header like Python version
-        htmlContent += "<div style='text-align: center; background: linear-gradient(135deg, #0078d4, #005a9e); "
-                      "color: white; padding: 12px; margin: -8px -8px 16px -8px; border-radius: 0 0 8px 8px;'>"
-                      "<h2 style='margin: 0; font-size: 14px; font-weight: bold; letter-spacing: 1px;'>DICOM TAGS</h2>"
-                      "</div>";
-        
-        // Create table structure like Python version
-        htmlContent += "<table style='width: 100%; border-collapse: collapse; font-family: Consolas, monospace;'>";
-        htmlContent += "<tr style='background-color: #404040;'>"
-                      "<th style='color: white; font-weight: bold; padding: 6px; border: 1px solid #666; text-align: left; width: 80px;'>Group,Elem.</th>"
-                      "<th style='color: white; font-weight: bold; padding: 6px; border: 1px solid #666; text-align: left; width: 180px;'>TAG Description</th>"
-                      "<th style='color: white; font-weight: bold; padding: 6px; border: 1px solid #666; text-align: left;'>Value</th>"
-                      "</tr>";
-        
-        // Iterate through all DICOM elements like Python version
-        for (unsigned long i = 0; i < dataset->card(); i++) {
-            DcmElement* elem = dataset->getElement(i);
-            if (elem) {
-                htmlContent += formatDicomTag(elem);
+    // Any other file is parsed on a worker, like a report; only the most
+    // recent request is shown
+    m_dicomInfoMessage->setText(QString("Loading %1...").arg(QFileInfo(filePath).fileName()));
+    m_dicomInfoMessage->show();
+    m_dicomInfoView->hide();
+    
+    m_thumbnailPool.start([this, filePath, requestId]() {
+        std::shared_ptr<DicomDatasetHandle> dataset = DicomDatasetHandle::open(filePath);
+        QMetaObject::invokeMethod(this, [this, filePath, requestId, dataset]() {
+            if (requestId == m_dicomInfoRequestId) {
+                showDicomInfo(filePath, dataset);
             }
-        }
-        
-        htmlContent += "</table>";
-        
-        htmlContent += "</body></html>";
-        
-        m_dicomInfoTextEdit->setHtml(htmlContent);
-        
-        // Cache the HTML content for this file to avoid regenerating it
-        m_cachedDicomInfoFilePath = filePath;
-        m_cachedDicomInfoHtml = htmlContent;
-        
-    } catch (...) {
-        m_dicomInfoTextEdit->setPlainText("Error: Exception occurred while reading DICOM file");
-        // Clear cache on error
-        m_cachedDicomInfoFilePath.clear();
-        m_cachedDicomInfoHtml.clear();
+        }, Qt::QueuedConnection);
+    }, 1);
+}
+
+void DicomViewer::showDicomInfo(const QString& filePath, const std::shared_ptr<DicomDatasetHandle>& dataset)
+{
+    if (!m_dicomInfoWidget || !m_dicomTagModel) {
+        return;
     }
+    
+    if (!dataset) {
+#ifdef HAVE_DCMTK
+        m_dicomInfoMessage->setText(QString("Error reading DICOM file: %1").arg(QFileInfo(filePath).fileName()));
 #else
-    m_dicomInfoTextEdit->setPlainText("DICOM support not available (DCMTK not compiled)");
+        m_dicomInfoMessage->setText("DICOM support not available (DCMTK not compiled)");
 #endif
+        m_dicomTagModel->clear();
+        m_dicomInfoMessage->show();
+        m_dicomInfoView->hide();
+        return;
+    }
+    
+    // No-op when the panel already shows this dataset
+    m_dicomTagModel->setDataset(dataset);
+    m_dicomInfoMessage->hide();
+    m_dicomInfoView->show();
 }
 
 // ==============================
@@ -5957,58 +5289,13 @@ void DicomViewer::onCopyProgressTimeout()
     if (m_copyInProgress && m_dicomReader) {
         qDebugT() << "[PERIODIC REFRESH] Checking for newly available files...";
         
-        // Store current selection before repopulating
-        QString selectedFilePath;
-        bool wasImageSelected = false;
-        QTreeWidgetItem* currentItem = m_dicomTree->currentItem();
-        if (currentItem) {
-            QVariantList itemData = currentItem->data(0, Qt::UserRole).toList();
-            if (itemData.size() >= 2) {
-                selectedFilePath = itemData[1].toString();
-                wasImageSelected = (itemData[0].toString() == "image");
-                qDebugT() << "[PERIODIC REFRESH] Preserving selection:" << selectedFilePath 
-                         << "Type:" << (wasImageSelected ? "image" : "series");
-            }
-        }
-        
-        // Refresh file existence status in DicomReader
-        m_dicomReader->refreshFileExistenceStatus();
+        // Pick up files that appeared without a progress event; their frame counts follow asynchronously
+        QStringList appearedFiles = m_dicomReader->refreshFileExistenceStatus();
         
-        // Update the tree display to reflect new file availability
-        m_dicomReader->populateTreeWidget(m_dicomTree);
-        
-        // Restore the previous selection if it existed
-        if (!selectedFilePath.isEmpty()) {
-            // Temporarily disconnect selection signal to avoid triggering onTreeItemSelected
-            disconnect(m_dicomTree, &QTreeWidget::currentItemChanged,
-                      this, &DicomViewer::onTreeItemSelected);
-            
-            QTreeWidgetItemIterator it(m_dicomTree);
-            while (*it) {
-                QVariantList itemData = (*it)->data(0, Qt::UserRole).toList();
-                if (itemData.size() >= 2) {
-                    QString itemPath = itemData[1].toString();
-                    QString itemType = itemData[0].toString();
-                    
-                    if (itemPath == selectedFilePath) {
-                        if (wasImageSelected && itemType == "image") {
-                            m_dicomTree->setCurrentItem(*it);
-                            qDebugT() << "[PERIODIC REFRESH] Restored image selection:" << selectedFilePath;
-                            break;
-                        } else if (!wasImageSelected && itemType == "series") {
-                            m_dicomTree->setCurrentItem(*it);
-                            qDebugT() << "[PERIODIC REFRESH] Restored series selection:" << selectedFilePath;
-                            break;
-                        }
-                    }
-                }
-                ++it;
-            }
-            
-            // Reconnect the selection signal
-            connect(m_dicomTree, &QTreeWidget::currentItemChanged,
-                    this, &DicomViewer::onTreeItemSelected);
-        }
+        // Only the items of those files change; the tree is never rebuilt, so the
+        // selection and expansion state stay as they are
+        m_dicomReader->updateTreeItems(appearedFiles);
+        probeFrameCountsAsync(appearedFiles);
         
         // REMOVED: updateThumbnailPanel() to prevent tree selection jumping
         // Old behavior: updateThumbnailPanel() called every 2-3 seconds during copy
@@ -6036,7 +5323,7 @@ void DicomViewer::onCopyProgressTimeout()
         // Stop timer if copy is no longer in progress
         if (m_copyProgressTimer && m_copyProgressTimer->isActive()) {
             m_copyProgressTimer->stop();
-            logMessage("DEBUG", "Stopped periodic tree refresh timer - copy completed");
+            LOG_AT(LOG_DEBUG, "Stopped periodic tree refresh timer - copy completed");
         }
     }
 }
@@ -6057,7 +5344,7 @@ void DicomViewer::handleMissingFile(const QString& path)
             m_imageLabel->setText(QString("Waiting for file...\n\nFile: %1").arg(filename));
             
             // File is missing - trigger copy from DVD if not already in progress
-            logMessage("DEBUG", QString("File missing, starting DVD copy: %1").arg(path));
+            LOG_AT(LOG_DEBUG, QString("File missing, starting DVD copy: %1").arg(path));
             detectAndStartDvdCopy();
         } else {
             m_imageLabel->setText(QString("File not found\n\nFile: %1").arg(filename));
@@ -6084,11 +5371,11 @@ qint64 DicomViewer::getExpectedFileSize(const QString& filePath)
 
 bool DicomViewer::hasActuallyMissingFiles()
 {
-    logMessage("DEBUG", "[MISSING FILES CHECK] Function called");
+    LOG_AT(LOG_DEBUG, "[MISSING FILES CHECK] Function called");
     
     // Check if we have loaded a DICOM tree and if any files are actually missing
     if (!m_dicomReader || !m_dicomTree) {
-        logMessage("DEBUG", "[MISSING FILES CHECK] No DICOM reader or tree available");
+        LOG_AT(LOG_DEBUG, "[MISSING FILES CHECK] No DICOM reader or tree available");
         return false;
     }
     
@@ -6115,12 +5402,12 @@ bool DicomViewer::hasActuallyMissingFiles()
     
     checkItemsRecursively(m_dicomTree->invisibleRootItem());
     
-    logMessage("DEBUG", QString("File check: %1 missing out of %2 total files").arg(missingCount).arg(totalCount));
+    LOG_AT(LOG_DEBUG, QString("File check: %1 missing out of %2 total files").arg(missingCount).arg(totalCount));
     
     // Only consider it "missing files" if we have a significant number missing
     // This avoids triggering DVD copy for just a few missing files
     bool result = missingCount > 0 && (missingCount > totalCount * 0.1 || missingCount > 5);
-    logMessage("DEBUG", QString("[MISSING FILES CHECK] Result: %1 - Missing: %2 Total: %3").arg(result).arg(missingCount).arg(totalCount));
+    LOG_AT(LOG_DEBUG, QString("[MISSING FILES CHECK] Result: %1 - Missing: %2 Total: %3").arg(result).arg(missingCount).arg(totalCount));
     return result;
 }
 
@@ -6139,7 +5426,7 @@ QStringList DicomViewer::getOrderedFileList()
         return orderedFiles;
     }
     
-    logMessage("DEBUG", "Extracting ordered file list from tree view...");
+    LOG_AT(LOG_DEBUG, "Extracting ordered file list from tree view...");
     
     // Walk through tree in display order (top to bottom) to get files as they appear to user
     QTreeWidgetItemIterator it(m_dicomTree);
@@ -6169,14 +5456,14 @@ QStringList DicomViewer::getOrderedFileList()
                 
                 if (!fileName.isEmpty()) {
                     orderedFiles.append(fileName);
-                    logMessage("DEBUG", QString("[ORDERED FILE %1] %2 (type: %3)").arg(orderedFiles.size()).arg(fileName).arg(itemType));
+                    LOG_AT(LOG_DEBUG, QString("[ORDERED FILE %1] %2 (type: %3)").arg(orderedFiles.size()).arg(fileName).arg(itemType));
                 }
             }
         }
         ++it;
     }
     
-    logMessage("DEBUG", QString("Extracted %1 files from tree view in display order").arg(orderedFiles.size()));
+    LOG_AT(LOG_DEBUG, QString("Extracted %1 files from tree view in display order").arg(orderedFiles.size()));
     return orderedFiles;
 }
 
@@ -6194,43 +5481,43 @@ void DicomViewer::detectAndStartDvdCopy()
     
     // Only run DVD detection if we have missing files that need to be copied
     if (!hasActuallyMissingFiles()) {
-        logMessage("DEBUG", "[DVD CHECK] No missing files detected, skipping DVD detection");
-        logMessage("DEBUG", "[DVD CHECK] All required files appear to be available locally");
-        logMessage("DEBUG", QString("[DVD CHECK] m_dvdDetectionInProgress remains: %1").arg(m_dvdDetectionInProgress));
+        LOG_AT(LOG_DEBUG, "[DVD CHECK] No missing files detected, skipping DVD detection");
+        LOG_AT(LOG_DEBUG, "[DVD CHECK] All required files appear to be available locally");
+        LOG_AT(LOG_DEBUG, QString("[DVD CHECK] m_dvdDetectionInProgress remains: %1").arg(m_dvdDetectionInProgress));
         return;
     }
     
-    logMessage("DEBUG", "[DVD CHECK] Missing files detected, proceeding with DVD detection");
+    LOG_AT(LOG_DEBUG, "[DVD CHECK] Missing files detected, proceeding with DVD detection");
     
     // Check if worker thread is already running
     if (m_dvdWorkerThread && m_dvdWorkerThread->isRunning()) {
-        logMessage("DEBUG", "[DVD CHECK] DVD worker already running, skipping new detection");
+        LOG_AT(LOG_DEBUG, "[DVD CHECK] DVD worker already running, skipping new detection");
         return;
     }
     
     if (m_copyInProgress) {
-        logMessage("DEBUG", "[DVD CHECK] Copy already in progress, skipping DVD detection");
+        LOG_AT(LOG_DEBUG, "[DVD CHECK] Copy already in progress, skipping DVD detection");
         return;
     }
     
     // Set detection in progress flag ONLY after confirming missing files need copying
     m_dvdDetectionInProgress = true;
     
-    logMessage("DEBUG", "[DVD WORKER] Starting background DVD detection and copy...");
-    logMessage("DEBUG", "[DVD WORKER] Looking for DVD drives with DicomFiles folder...");
+    LOG_AT(LOG_DEBUG, "[DVD WORKER] Starting background DVD detection and copy...");
+    LOG_AT(LOG_DEBUG, "[DVD WORKER] Looking for DVD drives with DicomFiles folder...");
     
     // Start worker thread for all DVD operations
     if (m_dvdWorkerThread && m_dvdWorker && !m_dvdWorkerThread->isRunning()) {
-        logMessage("DEBUG", "[DVD WORKER] Starting worker thread for DVD operations...");
+        LOG_AT(LOG_DEBUG, "[DVD WORKER] Starting worker thread for DVD operations...");
         m_dvdWorkerThread->start();
         
         // Give the thread a moment to start properly
         QThread::msleep(100);
-        logMessage("DEBUG", "[DVD WORKER] Worker thread started successfully");
+        LOG_AT(LOG_DEBUG, "[DVD WORKER] Worker thread started successfully");
     }
     
     // Worker thread will handle all DVD detection and copying
-    logMessage("DEBUG", "[DVD DETECTION] Letting worker thread handle DVD detection and copying...");
+    LOG_AT(LOG_DEBUG, "[DVD DETECTION] Letting worker thread handle DVD detection and copying...");
 }
 
 
@@ -6239,7 +5526,7 @@ void DicomViewer::detectAndStartDvdCopy()
 
 QString DicomViewer::findDvdWithDicomFiles()
 {
-    logMessage("DEBUG", "[DVD SCAN] Scanning for DVD drives with DicomFiles folder...");
+    LOG_AT(LOG_DEBUG, "[DVD SCAN] Scanning for DVD drives with DicomFiles folder...");
     
     // Check common DVD drive letters
     QStringList drivesToCheck = {"D:", "E:", "F:", "G:", "H:"};
@@ -6248,39 +5535,39 @@ QString DicomViewer::findDvdWithDicomFiles()
         QString dicomPath = drive + "/DicomFiles";
         QDir dir(dicomPath);
         
-        logMessage("DEBUG", QString("[DVD SCAN] Checking %1...").arg(dicomPath));
+        LOG_AT(LOG_DEBUG, QString("[DVD SCAN] Checking %1...").arg(dicomPath));
         
         if (dir.exists()) {
-            logMessage("DEBUG", QString("[DVD FOUND] DicomFiles folder exists at %1").arg(dicomPath));
+            LOG_AT(LOG_DEBUG, QString("[DVD FOUND] DicomFiles folder exists at %1").arg(dicomPath));
             
             // Check if it contains DICOM files
             QStringList filters;
             filters << "*.dcm" << "*.DCM" << "*"; // Include files without extension
             QStringList files = dir.entryList(filters, QDir::Files);
             
-            logMessage("DEBUG", QString("[DVD CONTENT] Found %1 files in DicomFiles folder").arg(files.count()));
+            LOG_AT(LOG_DEBUG, QString("[DVD CONTENT] Found %1 files in DicomFiles folder").arg(files.count()));
             
             if (!files.isEmpty()) {
-                logMessage("DEBUG", QString("[DVD SUCCESS] ? Found %1 DICOM files at: %2").arg(files.size()).arg(dicomPath));
+                LOG_AT(LOG_DEBUG, QString("[DVD SUCCESS] ? Found %1 DICOM files at: %2").arg(files.size()).arg(dicomPath));
                 
                 // Log first few filenames for verification
                 for (int i = 0; i < qMin(3, files.size()); i++) {
-                    logMessage("DEBUG", QString("[DVD FILES]   - %1").arg(files[i]));
+                    LOG_AT(LOG_DEBUG, QString("[DVD FILES]   - %1").arg(files[i]));
                 }
                 if (files.size() > 3) {
-                    logMessage("DEBUG", QString("[DVD FILES]   ... and %1 more files").arg(files.size() - 3));
+                    LOG_AT(LOG_DEBUG, QString("[DVD FILES]   ... and %1 more files").arg(files.size() - 3));
                 }
                 
                 return drive; // Return drive letter, not full path
             } else {
-                logMessage("DEBUG", QString("[DVD EMPTY] DicomFiles folder is empty at %1").arg(dicomPath));
+                LOG_AT(LOG_DEBUG, QString("[DVD EMPTY] DicomFiles folder is empty at %1").arg(dicomPath));
             }
         } else {
-            logMessage("DEBUG", QString("[DVD SCAN] No DicomFiles folder at %1").arg(dicomPath));
+            LOG_AT(LOG_DEBUG, QString("[DVD SCAN] No DicomFiles folder at %1").arg(dicomPath));
         }
     }
     
-    logMessage("DEBUG", "[DVD SCAN] ? No DVD with DICOM files found in any drive");
+    LOG_AT(LOG_DEBUG, "[DVD SCAN] ? No DVD with DICOM files found in any drive");
     return QString(); // No DVD with DICOM files found
 }
 
@@ -6298,20 +5585,20 @@ void DicomViewer::onWorkerReady()
     
     // If we have pending sequential copy data, start it now
     if (!m_pendingDvdPath.isEmpty() && !m_pendingOrderedFiles.isEmpty()) {
-        logMessage("DEBUG", QString("[PENDING COPY] Starting pending sequential copy for: %1").arg(m_pendingDvdPath));
-        logMessage("DEBUG", QString("[PENDING COPY] Files to copy: %1").arg(m_pendingOrderedFiles.size()));
+        LOG_AT(LOG_DEBUG, QString("[PENDING COPY] Starting pending sequential copy for: %1").arg(m_pendingDvdPath));
+        LOG_AT(LOG_DEBUG, QString("[PENDING COPY] Files to copy: %1").arg(m_pendingOrderedFiles.size()));
         
         emit requestSequentialRobocopyStart(m_pendingDvdPath, m_pendingOrderedFiles);
         
         // EVENT-BASED FIRST IMAGE: First image will be auto-selected when
         // updateTreeIconForFile() detects the first available file
-        logMessage("DEBUG", "[DVD COPY] Using event-based first image selection");
+        LOG_AT(LOG_DEBUG, "[DVD COPY] Using event-based first image selection");
         
         // Clear pending data
         m_pendingDvdPath.clear();
         m_pendingOrderedFiles.clear();
     } else {
-        logMessage("DEBUG", "[WORKER READY] No pending copy data");
+        LOG_AT(LOG_DEBUG, "[WORKER READY] No pending copy data");
     }
 }
 
@@ -6334,7 +5621,7 @@ void DicomViewer::onDvdDetected(const QString& dvdPath)
     }
     
     // Clear any previous completion tracking to start fresh
-    logMessage("DEBUG", "[INIT DEBUG] Clearing completed files set at DVD detection");
+    LOG_AT(LOG_DEBUG, "[INIT DEBUG] Clearing completed files set at DVD detection");
     m_fullyCompletedFiles.clear();
     m_firstImageAutoSelected = false;  // Reset auto-selection flag for new session
     
@@ -6342,30 +5629,30 @@ void DicomViewer::onDvdDetected(const QString& dvdPath)
     QStringList orderedFiles = getOrderedFileList();
     
     if (!orderedFiles.isEmpty()) {
-        logMessage("DEBUG", QString("[SEQUENTIAL COPY] Storing sequential copy data for path: %1").arg(dvdPath));
-        logMessage("DEBUG", QString("[SEQUENTIAL COPY] Files to copy in order: %1").arg(orderedFiles.size()));
+        LOG_AT(LOG_DEBUG, QString("[SEQUENTIAL COPY] Storing sequential copy data for path: %1").arg(dvdPath));
+        LOG_AT(LOG_DEBUG, QString("[SEQUENTIAL COPY] Files to copy in order: %1").arg(orderedFiles.size()));
         
         m_pendingDvdPath = dvdPath;
         m_pendingOrderedFiles = orderedFiles;
         
         // Check if worker is already ready - if so, start immediately
         if (m_workerReady) {
-            logMessage("DEBUG", "[IMMEDIATE START] Worker is ready, starting sequential copy immediately");
+            LOG_AT(LOG_DEBUG, "[IMMEDIATE START] Worker is ready, starting sequential copy immediately");
             emit requestSequentialRobocopyStart(m_pendingDvdPath, m_pendingOrderedFiles);
             
             // EVENT-BASED FIRST IMAGE: First image will be auto-selected when
             // updateTreeIconForFile() detects the first available file
-            logMessage("DEBUG", "[DVD COPY] Using event-based first image selection");
+            LOG_AT(LOG_DEBUG, "[DVD COPY] Using event-based first image selection");
             
             // Clear pending data since we started immediately
             m_pendingDvdPath.clear();
             m_pendingOrderedFiles.clear();
         } else {
-            logMessage("DEBUG", "[SEQUENTIAL COPY] Worker not ready yet, waiting for worker ready signal");
+            LOG_AT(LOG_DEBUG, "[SEQUENTIAL COPY] Worker not ready yet, waiting for worker ready signal");
         }
     } else {
         logMessage("WARN", "[WARNING] No ordered files found in tree view - DVD copying may not work properly");
-        logMessage("DEBUG", "[INFO] Ensure DICOMDIR is loaded and tree view is populated before DVD detection");
+        LOG_AT(LOG_DEBUG, "[INFO] Ensure DICOMDIR is loaded and tree view is populated before DVD detection");
     }
     
     if (m_imageLabel) {
@@ -6397,11 +5684,11 @@ void DicomViewer::onCopyStarted()
             QString itemText = item->text(0);
             if (itemText.contains("%") || itemText.contains("Loading")) {
                 itemsWithProgress++;
-                logMessage("DEBUG", QString("[COPY START DEBUG] Item with progress detected: %1").arg(itemText));
+                LOG_AT(LOG_DEBUG, QString("[COPY START DEBUG] Item with progress detected: %1").arg(itemText));
             }
             ++it;
         }
-        logMessage("DEBUG", QString("[COPY START DEBUG] Total items with progress indicators: %1").arg(itemsWithProgress));
+        LOG_AT(LOG_DEBUG, QString("[COPY START DEBUG] Total items with progress indicators: %1").arg(itemsWithProgress));
     }
     
     // Update status bar instead of blocking image display
@@ -6419,7 +5706,7 @@ void DicomViewer::onFileProgress(const QString& fileName, int progress)
     
     // Update file state based on copy progress
     QString fullPath = PathNormalizer::constructFilePath(m_localDestPath, fileName); // Construct normalized full path
-    logMessage(LOG_DEBUG, QString("PathNormalizer: Constructed file path for progress tracking: %1").arg(fullPath));
+    LOG_AT(LOG_DEBUG, QString("PathNormalizer: Constructed file path for progress tracking: %1").arg(fullPath));
     
     if (progress >= 100) {
         // Trigger thumbnail generation if not already queued
@@ -6431,7 +5718,7 @@ void DicomViewer::onFileProgress(const QString& fileName, int progress)
         // RESTORE WORKING FIRST IMAGE SELECTION: Auto-select first available image if none selected
         // Use immediate auto-selection like the WithoutThumbnails version
         if (!m_firstImageAutoSelected && !isDisplayingAnything()) {
-            logMessage("DEBUG", "[FIRST IMAGE] File completed, attempting immediate auto-selection");
+            LOG_AT(LOG_DEBUG, "[FIRST IMAGE] File completed, attempting immediate auto-selection");
             autoSelectFirstCompletedImage();
         }
     }
@@ -6448,13 +5735,13 @@ void DicomViewer::onFileProgress(const QString& fileName, int progress)
     // Start periodic tree refresh during copy operations (every 2 seconds)
     if (!m_copyProgressTimer->isActive() && m_copyInProgress) {
         m_copyProgressTimer->start(2000); // Check every 2 seconds
-        logMessage("DEBUG", "Started periodic tree refresh timer during copy operation");
+        LOG_AT(LOG_DEBUG, "Started periodic tree refresh timer during copy operation");
     }
 }
 
 void DicomViewer::onOverallProgress(int percentage, const QString& statusText)
 {
-    logMessage("DEBUG", QString("Overall DVD copy progress: %1% - %2").arg(percentage).arg(statusText));
+    LOG_AT(LOG_DEBUG, QString("Overall DVD copy progress: %1% - %2").arg(percentage).arg(statusText));
     
     // Update status bar instead of blocking image display
     updateStatusBar(statusText, percentage);
@@ -6474,7 +5761,7 @@ void DicomViewer::onCopyCompleted(bool success)
     updateAllTreeIcons();
     
     // TRIGGER THUMBNAIL GENERATION: Now that copying is complete, start thumbnails
-    logMessage("DEBUG", "[DVD COPY COMPLETE] Starting thumbnail generation");
+    LOG_AT(LOG_DEBUG, "[DVD COPY COMPLETE] Starting thumbnail generation");
     updateThumbnailPanel();
     
     // Check if thumbnail panel should be shown now that copy is complete
@@ -6482,7 +5769,7 @@ void DicomViewer::onCopyCompleted(bool success)
     
     // Ensure first image is selected if none was selected during copy
     if (!m_firstImageAutoSelected) {
-        logMessage("DEBUG", "[COPY COMPLETE] No first image was auto-selected during copy, trying now");
+        LOG_AT(LOG_DEBUG, "[COPY COMPLETE] No first image was auto-selected during copy, trying now");
         QTimer::singleShot(100, this, &DicomViewer::autoSelectFirstCompletedImage);
     }
 }
@@ -6510,7 +5797,7 @@ void DicomViewer::onWorkerError(const QString& error)
 
 void DicomViewer::onFfmpegCopyCompleted(bool success)
 {
-    logMessage("DEBUG", QString("[FFMPEG COPY] FFmpeg copy completed. Success: %1").arg(success));
+    LOG_AT(LOG_DEBUG, QString("[FFMPEG COPY] FFmpeg copy completed. Success: %1").arg(success));
     
     m_ffmpegCopyCompleted = success;
     
@@ -6532,8 +5819,8 @@ void DicomViewer::updateTreeItemWithProgress(const QString& fileName, int progre
     // Extract just the filename from the full path for tree matching
     QString baseFileName = QFileInfo(fileName).fileName();
     
-    logMessage("DEBUG", QString("File progress update: %1 %2%").arg(fileName).arg(progress));
-    logMessage("DEBUG", QString("Extracted filename for tree matching: %1").arg(baseFileName));
+    LOG_AT(LOG_DEBUG, QString("File progress update: %1 %2%").arg(fileName).arg(progress));
+    LOG_AT(LOG_DEBUG, QString("Extracted filename for tree matching: %1").arg(baseFileName));
     
     // Find and update the specific tree item for this file using just the filename
     updateSpecificTreeItemProgress(baseFileName, progress);
@@ -6541,46 +5828,35 @@ void DicomViewer::updateTreeItemWithProgress(const QString& fileName, int progre
     // When a file completes (reaches 100%), refresh tree to show it's available
     if (progress >= 100) {
         QString baseFileName = QFileInfo(fileName).fileName();
-        logMessage("DEBUG", "=== FILE COMPLETION DEBUG ===");
-        logMessage("DEBUG", QString("File completed: %1").arg(baseFileName));
-        logMessage("DEBUG", QString("m_firstImageAutoSelected: %1").arg(m_firstImageAutoSelected));
-        logMessage("DEBUG", QString("Current m_fullyCompletedFiles size: %1").arg(m_fullyCompletedFiles.size()));
+        LOG_AT(LOG_DEBUG, "=== FILE COMPLETION DEBUG ===");
+        LOG_AT(LOG_DEBUG, QString("File completed: %1").arg(baseFileName));
+        LOG_AT(LOG_DEBUG, QString("m_firstImageAutoSelected: %1").arg(m_firstImageAutoSelected));
+        LOG_AT(LOG_DEBUG, QString("Current m_fullyCompletedFiles size: %1").arg(m_fullyCompletedFiles.size()));
         
         // Prevent duplicate completions
         if (m_fullyCompletedFiles.contains(baseFileName)) {
-            logMessage("DEBUG", QString("File already completed, skipping: %1").arg(baseFileName));
+            LOG_AT(LOG_DEBUG, QString("File already completed, skipping: %1").arg(baseFileName));
             return;
         }
         
         // Add to the set of fully completed files
         m_fullyCompletedFiles.insert(baseFileName);
-        logMessage("DEBUG", QString("After adding, m_fullyCompletedFiles size: %1").arg(m_fullyCompletedFiles.size()));
-        
-        // Refresh file existence status in DicomReader
-        m_dicomReader->refreshFileExistenceStatus();
+        LOG_AT(LOG_DEBUG, QString("After adding, m_fullyCompletedFiles size: %1").arg(m_fullyCompletedFiles.size()));
         
-        // Update frame count for this specific file now that it's available
-        m_dicomReader->updateFrameCountForFile(baseFileName);
+        // Only this file changed; its frame count is probed off the GUI thread
+        if (m_dicomReader->markFileAvailable(baseFileName)) {
+            probeFrameCountsAsync(QStringList() << m_dicomReader->getImageInfoForFile(baseFileName).filePath);
+        }
         
-        // Update the tree display to reflect new file availability with correct icons
-        m_dicomReader->populateTreeWidget(m_dicomTree);
+        // Update just this file's tree item to reflect its availability with correct icons
+        m_dicomReader->updateTreeItems(QStringList() << baseFileName);
         
         // CRITICAL: Update tree icon for this specific completed file to trigger event-based selection
-        QTreeWidgetItemIterator treeIt(m_dicomTree);
-        while (*treeIt) {
-            QVariantList userData = (*treeIt)->data(0, Qt::UserRole).toList();
-            if (userData.size() >= 2 && userData[0].toString() == "image") {
-                QString itemFilePath = userData[1].toString();
-                QString itemFileName = QFileInfo(itemFilePath).fileName();
-                if (itemFileName == baseFileName) {
-                    updateTreeIconForFile(*treeIt);
-                    break;
-                }
-            }
-            ++treeIt;
+        if (m_dicomReader->treeItemType(baseFileName) == "image") {
+            updateTreeIconForFile(m_dicomReader->findTreeItem(baseFileName));
         }
         
-        logMessage("DEBUG", QString("Tree refreshed after file completion with updated frame count: %1").arg(fileName));
+        LOG_AT(LOG_DEBUG, QString("Tree refreshed after file completion: %1").arg(fileName));
         
         // NEW: Check if ALL files are now complete and trigger thumbnail creation if so
         // But only if thumbnails haven't been created yet to prevent multiple calls
@@ -6591,62 +5867,36 @@ void DicomViewer::updateTreeItemWithProgress(const QString& fileName, int progre
         
         // Auto-select and display the first completed image for better UX
         if (!m_firstImageAutoSelected) {
-            logMessage("DEBUG", "[EARLY AUTO-SELECT] First file completed, attempting immediate auto-selection");
+            LOG_AT(LOG_DEBUG, "[EARLY AUTO-SELECT] First file completed, attempting immediate auto-selection");
             autoSelectFirstCompletedImage();
             
             // If auto-selection failed, try a more aggressive approach for the very first file
             if (!m_firstImageAutoSelected && m_fullyCompletedFiles.size() == 1) {
-                logMessage("DEBUG", "[IMMEDIATE SELECT] This is the very first file - forcing immediate selection");
+                LOG_AT(LOG_DEBUG, "[IMMEDIATE SELECT] This is the very first file - forcing immediate selection");
                 
-                // Find any tree item that matches this completed file
-                QTreeWidgetItemIterator it(m_dicomTree);
-                int itemCount = 0;
-                while (*it) {
-                    itemCount++;
-                    QTreeWidgetItem* item = *it;
-                    QVariantList userData = item->data(0, Qt::UserRole).toList();
+                // The only completed file is this one - look its item up directly
+                QTreeWidgetItem* item = m_dicomReader->findTreeItem(baseFileName);
+                if (item && m_dicomReader->treeItemType(baseFileName) == "image") {
+                    LOG_AT(LOG_DEBUG, QString("[IMMEDIATE SELECT] Found completed item, selecting: %1").arg(item->text(0)));
                     
-                    if (itemCount <= 5) {
-                        logMessage("DEBUG", QString("[DEBUG ITEM %1] Text: %2, UserData size: %3")
-                               .arg(itemCount).arg(item->text(0)).arg(userData.size()));
-                        if (userData.size() >= 2) {
-                            logMessage("DEBUG", QString("  Type: %1 Path: %2").arg(userData[0].toString()).arg(userData[1].toString()));
-                        }
+                    // Expand parents
+                    QTreeWidgetItem* parent = item->parent();
+                    while (parent) {
+                        parent->setExpanded(true);
+                        parent = parent->parent();
                     }
                     
-                    if (userData.size() >= 2 && userData[0].toString() == "image") {
-                        QString itemFilename = QFileInfo(userData[1].toString()).fileName();
-                        logMessage("DEBUG", QString("[CHECKING ITEM] %1 -> filename: %2").arg(item->text(0)).arg(itemFilename));
-                        
-                        if (m_fullyCompletedFiles.contains(itemFilename)) {
-                            logMessage("DEBUG", QString("[IMMEDIATE SELECT] Found completed item, selecting: %1").arg(item->text(0)));
-                            
-                            // Expand parents
-                            QTreeWidgetItem* parent = item->parent();
-                            while (parent) {
-                                logMessage("DEBUG", QString("[EXPANDING] Parent: %1").arg(parent->text(0)));
-                                parent->setExpanded(true);
-                                parent = parent->parent();
-                            }
-                            
-                            // Select and trigger loading immediately
-                            m_dicomTree->setCurrentItem(item);
-                            m_dicomTree->scrollToItem(item);
-                            logMessage("DEBUG", "[IMMEDIATE SELECT] About to call onTreeItemSelected");
-                            onTreeItemSelected(item, nullptr);
-                            m_firstImageAutoSelected = true;
-                            
-                            logMessage("DEBUG", "[IMMEDIATE SELECT] Successfully selected first completed file!");
-                            break;
-                        }
-                    }
-                    ++it;
+                    // Select and trigger loading immediately
+                    m_dicomTree->setCurrentItem(item);
+                    m_dicomTree->scrollToItem(item);
+                    onTreeItemSelected(item, nullptr);
+                    m_firstImageAutoSelected = true;
+                    
+                    LOG_AT(LOG_DEBUG, "[IMMEDIATE SELECT] Successfully selected first completed file!");
                 }
-                
-                logMessage("DEBUG", QString("[IMMEDIATE SELECT] Checked %1 total tree items").arg(itemCount));
             }
         } else {
-            logMessage("DEBUG", "[EARLY AUTO-SELECT] Skipping auto-selection - already done");
+            LOG_AT(LOG_DEBUG, "[EARLY AUTO-SELECT] Skipping auto-selection - already done");
         }
         
         // Also update the header to show current progress
@@ -6665,7 +5915,7 @@ void DicomViewer::updateTreeItemWithProgress(const QString& fileName, int progre
         double displayProgress = qMin(overallProgress * 100.0, 100.0);
         int completedFiles = qMin(int(overallProgress * totalImages), totalImages);
         
-        logMessage("DEBUG", QString("Overall progress: %1% (%2/%3 files)")
+        LOG_AT(LOG_DEBUG, QString("Overall progress: %1% (%2/%3 files)")
                  .arg(QString::number(displayProgress, 'f', 1)).arg(completedFiles).arg(totalImages));
     }
 }
@@ -6674,173 +5924,135 @@ void DicomViewer::updateSpecificTreeItemProgress(const QString& fileName, int pr
 {
     if (!m_dicomTree) return;
     
-    logMessage("DEBUG", QString("[TREE UPDATE] Searching for file: %1 progress: %2%").arg(fileName).arg(progress));
+    LOG_AT(LOG_DEBUG, QString("[TREE UPDATE] Looking up file: %1 progress: %2%").arg(fileName).arg(progress));
     
-    // Recursively search through all tree items to find the one corresponding to this file
-    QTreeWidgetItemIterator it(m_dicomTree);
-    bool found = false;
-    int itemCount = 0;
+    // Constant-time lookup in the index kept by DicomReader::populateTreeWidget
+    QTreeWidgetItem* item = m_dicomReader ? m_dicomReader->findTreeItem(fileName) : nullptr;
+    if (!item) {
+        LOG_AT(LOG_DEBUG, QString("[TREE UPDATE] No tree item for file: %1").arg(fileName));
+        return;
+    }
     
-    while (*it) {
-        QTreeWidgetItem* item = *it;
-        itemCount++;
+    QVariantList userData = item->data(0, Qt::UserRole).toList();
+    QString itemType = userData.value(0).toString();
+    QString filePath = userData.value(1).toString();
+    
+    // Store original text if not already stored
+    if (!item->data(0, Qt::UserRole + 1).isValid()) {
+        QString originalText = item->text(0);
+        item->setData(0, Qt::UserRole + 1, originalText);
+        LOG_AT(LOG_DEBUG, QString("Stored original text for item: %1").arg(originalText));
+    }
+    
+    QString originalText = item->data(0, Qt::UserRole + 1).toString();
+    
+    if (progress < 100) {
+        // Show progress percentage in the item text
+        QString progressText = QString("%1 - Loading... %2%").arg(originalText).arg(progress);
+        item->setText(0, progressText);
         
-        // Check if this item represents an image or report
-        QVariantList userData = item->data(0, Qt::UserRole).toList();
-        if (userData.size() >= 2) {
-            QString itemType = userData[0].toString();
-            QString filePath = userData[1].toString();
-            
-            // Debug: Show first few items to understand the data structure
-            if (itemCount <= 5 && (itemType == "image" || itemType == "report")) {
-                logMessage("DEBUG", QString("[TREE DEBUG] %1 Type: %2 Path: %3 Text: %4").arg(itemCount).arg(itemType).arg(filePath).arg(item->text(0)));
-            }
+        // Set loading icon with fallback if resource not found
+        QIcon loadingIcon(":/icons/Loading.png");
+        if (loadingIcon.isNull()) {
+            // Create animated loading icon fallback
+            QPixmap loadingPixmap(16, 16);
+            loadingPixmap.fill(QColor(255, 165, 0)); // Orange loading color
+            loadingIcon = QIcon(loadingPixmap);
+        }
+        item->setIcon(0, loadingIcon);
+        item->setForeground(0, QColor(180, 180, 180));
+        
+        LOG_AT(LOG_DEBUG, QString("Updated tree item progress: %1 %2%").arg(fileName).arg(progress));
+    } else {
+        // File completed - verify it actually exists and is readable before marking complete
+        QString fullFilePath = QFileInfo(filePath).absoluteFilePath();
+        QFileInfo completedFile(fullFilePath);
+        
+        if (completedFile.exists() && completedFile.size() > 0) {
+            LOG_AT(LOG_DEBUG, QString("[FILE VERIFIED] File exists and has size: %1 bytes").arg(completedFile.size()));
             
-            // Check if this item corresponds to the file being copied
-            // Use exact filename matching only for DICOM files
-            bool isMatch = false;
+            // File completed - restore original text and icon
+            item->setText(0, originalText);
+            item->setForeground(0, QColor(0, 0, 0)); // Black text
             
-            if ((itemType == "image" || itemType == "report")) {
-                // Get the actual filename from the tree item's file path
-                QFileInfo filePathInfo(filePath);
-                QString itemFileName = filePathInfo.fileName();
+            // Set appropriate icon based on file type and actual frame count
+            if (itemType == "report") {
+                // Check if this is specifically an RDSR file
+                bool isRDSR = false;
+                if (m_dicomReader) {
+                    isRDSR = m_dicomReader->isRDSRFile(fullFilePath);
+                }
                 
-                // CRITICAL: Use exact string comparison for DICOM filenames
-                // This prevents all files starting with "1.2.392..." from matching the same item
-                if (itemFileName.compare(fileName, Qt::CaseInsensitive) == 0) {
-                    isMatch = true;
-                    logMessage("DEBUG", QString("[MATCH] Exact filename match: %1 vs %2").arg(fileName).arg(itemFileName));
+                QIcon reportIcon;
+                if (isRDSR) {
+                    reportIcon = QIcon(":/icons/RDSR.png");
+                    // If RDSR icon not found, create a distinctive fallback
+                    if (reportIcon.isNull()) {
+                        QPixmap rdrsPixmap(16, 16);
+                        rdrsPixmap.fill(QColor(255, 100, 100)); // Red background for RDSR
+                        QPainter painter(&rdrsPixmap);
+                        painter.setPen(QPen(Qt::white, 2));
+                        painter.setFont(QFont("Arial", 8, QFont::Bold));
+                        painter.drawText(QRect(0, 0, 16, 16), Qt::AlignCenter, "RD");
+                        reportIcon = QIcon(rdrsPixmap);
+                    }
                 } else {
-                    // Only log mismatches for first few items to avoid spam
-                    if (itemCount <= 5) {
-                        logMessage("DEBUG", QString("[NO MATCH] %1 != %2").arg(fileName).arg(itemFileName));
+                    reportIcon = QIcon(":/icons/List.png");
+                    // Create fallback for general SR if needed
+                    if (reportIcon.isNull()) {
+                        QPixmap srPixmap(16, 16);
+                        srPixmap.fill(QColor(100, 100, 200)); // Blue background for SR
+                        QPainter painter(&srPixmap);
+                        painter.setPen(QPen(Qt::white, 2));
+                        painter.setFont(QFont("Arial", 8, QFont::Bold));
+                        painter.drawText(QRect(0, 0, 16, 16), Qt::AlignCenter, "SR");
+                        reportIcon = QIcon(srPixmap);
                     }
                 }
-            }
-            
-            if (isMatch) {
+                item->setIcon(0, reportIcon);
                 
-                // Store original text if not already stored
-                if (!item->data(0, Qt::UserRole + 1).isValid()) {
-                    QString originalText = item->text(0);
-                    item->setData(0, Qt::UserRole + 1, originalText);
-                    logMessage("DEBUG", QString("Stored original text for item: %1").arg(originalText));
-                }
+                QString logMsg = isRDSR ? QString("Set RDSR icon for %1").arg(fileName) : 
+                                          QString("Set SR icon for %1").arg(fileName);
+                LOG_AT(LOG_DEBUG, logMsg);
+            } else {
+                // Get frame count from cached DICOM data instead of re-reading file
+                DicomImageInfo imageInfo = m_dicomReader->getImageInfoForFile(fileName);
+                int cachedFrameCount = imageInfo.frameCount;
                 
-                QString originalText = item->data(0, Qt::UserRole + 1).toString();
+                LOG_AT(LOG_DEBUG, QString("[ICON SELECTION] File: %1 Cached Frames: %2 Path: %3").arg(fileName).arg(cachedFrameCount).arg(imageInfo.filePath));
                 
-                if (progress < 100) {
-                    // Show progress percentage in the item text
-                    QString progressText = QString("%1 - Loading... %2%").arg(originalText).arg(progress);
-                    item->setText(0, progressText);
-                    
-                    // Set loading icon with fallback if resource not found
-                    QIcon loadingIcon(":/icons/Loading.png");
-                    if (loadingIcon.isNull()) {
-                        // Create animated loading icon fallback
-                        QPixmap loadingPixmap(16, 16);
-                        loadingPixmap.fill(QColor(255, 165, 0)); // Orange loading color
-                        loadingIcon = QIcon(loadingPixmap);
+                QIcon imageIcon;
+                if (cachedFrameCount > 1) {
+                    imageIcon = QIcon(":/icons/AcquisitionHeader.png");
+                    if (imageIcon.isNull()) {
+                        // Fallback for multiframe
+                        QPixmap fallback(16, 16);
+                        fallback.fill(QColor(200, 100, 100));
+                        imageIcon = QIcon(fallback);
                     }
-                    item->setIcon(0, loadingIcon);
-                    item->setForeground(0, QColor(180, 180, 180));
-                    
-                    logMessage("DEBUG", QString("Updated tree item progress: %1 %2%").arg(fileName).arg(progress));
+                    LOG_AT(LOG_DEBUG, QString("Set multiframe icon for %1 (%2 frames)").arg(fileName).arg(cachedFrameCount));
                 } else {
-                    // File completed - verify it actually exists and is readable before marking complete
-                    QString fullFilePath = QFileInfo(filePath).absoluteFilePath();
-                    QFileInfo completedFile(fullFilePath);
-                    
-                    if (completedFile.exists() && completedFile.size() > 0) {
-                        logMessage("DEBUG", QString("[FILE VERIFIED] File exists and has size: %1 bytes").arg(completedFile.size()));
-                        
-                        // File completed - restore original text and icon
-                        item->setText(0, originalText);
-                        item->setForeground(0, QColor(0, 0, 0)); // Black text
-                        
-                        // Set appropriate icon based on file type and actual frame count
-                        if (itemType == "report") {
-                            // Check if this is specifically an RDSR file
-                            bool isRDSR = false;
-                            if (m_dicomReader) {
-                                isRDSR = m_dicomReader->isRDSRFile(fullFilePath);
-                            }
-                            
-                            QIcon reportIcon;
-                            if (isRDSR) {
-                                reportIcon = QIcon(":/icons/RDSR.png");
-                                // If RDSR icon not found, create a distinctive fallback
-                                if (reportIcon.isNull()) {
-                                    QPixmap rdrsPixmap(16, 16);
-                                    rdrsPixmap.fill(QColor(255, 100, 100)); // Red background for RDSR
-                                    QPainter painter(&rdrsPixmap);
-                                    painter.setPen(QPen(Qt::white, 2));
-                                    painter.setFont(QFont("Arial", 8, QFont::Bold));
-                                    painter.drawText(QRect(0, 0, 16, 16), Qt::AlignCenter, "RD");
-                                    reportIcon = QIcon(rdrsPixmap);
-                                }
-                            } else {
-                                reportIcon = QIcon(":/icons/List.png");
-                                // Create fallback for general SR if needed
-                                if (reportIcon.isNull()) {
-                                    QPixmap srPixmap(16, 16);
-                                    srPixmap.fill(QColor(100, 100, 200)); // Blue background for SR
-                                    QPainter painter(&srPixmap);
-                                    painter.setPen(QPen(Qt::white, 2));
-                                    painter.setFont(QFont("Arial", 8, QFont::Bold));
-                                    painter.drawText(QRect(0, 0, 16, 16), Qt::AlignCenter, "SR");
-                                    reportIcon = QIcon(srPixmap);
-                                }
-                            }
-                            item->setIcon(0, reportIcon);
-                            
-                            QString logMsg = isRDSR ? QString("Set RDSR icon for %1").arg(fileName) : 
-                                                      QString("Set SR icon for %1").arg(fileName);
-                            logMessage("DEBUG", logMsg);
-                        } else {
-                            // Get frame count from cached DICOM data instead of re-reading file
-                            DicomImageInfo imageInfo = m_dicomReader->getImageInfoForFile(fileName);
-                            int cachedFrameCount = imageInfo.frameCount;
-                            
-                            logMessage("DEBUG", QString("[ICON SELECTION] File: %1 Cached Frames: %2 Path: %3").arg(fileName).arg(cachedFrameCount).arg(imageInfo.filePath));
-                            
-                            QIcon imageIcon;
-                            if (cachedFrameCount > 1) {
-                                imageIcon = QIcon(":/icons/AcquisitionHeader.png");
-                                if (imageIcon.isNull()) {
-                                    // Fallback for multiframe
-                                    QPixmap fallback(16, 16);
-                                    fallback.fill(QColor(200, 100, 100));
-                                    imageIcon = QIcon(fallback);
-                                }
-                                logMessage("DEBUG", QString("Set multiframe icon for %1 (%2 frames)").arg(fileName).arg(cachedFrameCount));
-                            } else {
-                                imageIcon = QIcon(":/icons/Camera.png");
-                                if (imageIcon.isNull()) {
-                                    // Fallback for single frame
-                                    QPixmap fallback(16, 16);
-                                    fallback.fill(QColor(100, 200, 100));
-                                    imageIcon = QIcon(fallback);
-                                }
-                                logMessage("DEBUG", QString("Set single frame icon for %1").arg(fileName));
-                            }
-                            item->setIcon(0, imageIcon);
-                        }
-                        
-                        logMessage("DEBUG", QString("File completed, restored original text: %1").arg(originalText));
-                    } else {
-                        logMessage("WARN", QString("[FILE NOT READY] File %1 marked as 100% but doesn't exist or is empty. Keeping loading state.").arg(fileName));
-                        // Keep the loading state - don't mark as complete yet
-                        QString progressText = QString("%1 - Finalizing...").arg(originalText);
-                        item->setText(0, progressText);
-                        item->setIcon(0, QIcon(":/icons/Loading.png"));
-                        item->setForeground(0, QColor(180, 180, 180));
+                    imageIcon = QIcon(":/icons/Camera.png");
+                    if (imageIcon.isNull()) {
+                        // Fallback for single frame
+                        QPixmap fallback(16, 16);
+                        fallback.fill(QColor(100, 200, 100));
+                        imageIcon = QIcon(fallback);
                     }
+                    LOG_AT(LOG_DEBUG, QString("Set single frame icon for %1").arg(fileName));
                 }
-                break;
+                item->setIcon(0, imageIcon);
             }
+            
+            LOG_AT(LOG_DEBUG, QString("File completed, restored original text: %1").arg(originalText));
+        } else {
+            logMessage("WARN", QString("[FILE NOT READY] File %1 marked as 100% but doesn't exist or is empty. Keeping loading state.").arg(fileName));
+            // Keep the loading state - don't mark as complete yet
+            QString progressText = QString("%1 - Finalizing...").arg(originalText);
+            item->setText(0, progressText);
+            item->setIcon(0, QIcon(":/icons/Loading.png"));
+            item->setForeground(0, QColor(180, 180, 180));
         }
-        ++it;
     }
 }
 
@@ -6866,12 +6078,12 @@ void DicomViewer::parseRobocopyOutput(const QString& output)
             trimmedLine.contains("Source =") ||
             trimmedLine.contains("Dest :") ||
             trimmedLine.contains("Options :")) {
-            logMessage("DEBUG", QString("[ROBOCOPY] %1").arg(trimmedLine));
+            LOG_AT(LOG_DEBUG, QString("[ROBOCOPY] %1").arg(trimmedLine));
         }
         
         // Skip files that robocopy reports as "same" (already exist and identical)
         if (trimmedLine.contains("same\t\t")) {
-            logMessage("DEBUG", QString("[ROBOCOPY SAME] Skipping file that already exists: %1").arg(trimmedLine));
+            LOG_AT(LOG_DEBUG, QString("[ROBOCOPY SAME] Skipping file that already exists: %1").arg(trimmedLine));
             continue;
         }
         
@@ -6908,33 +6120,33 @@ void DicomViewer::parseRobocopyOutput(const QString& output)
                 
                 // Enhanced progress logging
                 qint64 elapsed = s_copyTimer.elapsed();
-                logMessage("DEBUG", QString("[DVD COPY] %1% - %2 (elapsed: %3s)")
+                LOG_AT(LOG_DEBUG, QString("[DVD COPY] %1% - %2 (elapsed: %3s)")
                            .arg(progress, 3)
                            .arg(filename.isEmpty() ? "processing..." : filename)
                            .arg(elapsed / 1000.0, 0, 'f', 1));
                 
                 // Debug any non-zero progress immediately
                 if (!filename.isEmpty() && progress > 0) {
-                    logMessage("DEBUG", QString("[PROGRESS DEBUG] File progress detected: %1 %2% from line: %3").arg(filename).arg(progress).arg(trimmedLine));
+                    LOG_AT(LOG_DEBUG, QString("[PROGRESS DEBUG] File progress detected: %1 %2% from line: %3").arg(filename).arg(progress).arg(trimmedLine));
                     updateTreeItemWithProgress(filename, progress);
                 }
                 
                 if (progress >= 100) {
                     s_filesProcessed++;
-                    logMessage("DEBUG", QString("[DVD COPY] ? Completed file #%1: %2")
+                    LOG_AT(LOG_DEBUG, QString("[DVD COPY] ? Completed file #%1: %2")
                                .arg(s_filesProcessed)
                                .arg(filename));
                     
                     // Additional debug: Track which files are being marked as complete and when
-                    logMessage("DEBUG", QString("[100% DEBUG] File marked complete: %1").arg(filename));
-                    logMessage("DEBUG", QString("[100% DEBUG] Robocopy line was: %1").arg(trimmedLine));
+                    LOG_AT(LOG_DEBUG, QString("[100% DEBUG] File marked complete: %1").arg(filename));
+                    LOG_AT(LOG_DEBUG, QString("[100% DEBUG] Robocopy line was: %1").arg(trimmedLine));
                     
                     // Verify file actually exists before marking as complete
                     QString expectedPath = QString("C:/Users/gurup/AppData/Local/Temp/Ekn_TempData/DicomFiles/%1").arg(filename);
                     QFileInfo checkFile(expectedPath);
                     
                     if (checkFile.exists() && checkFile.size() > 0) {
-                        logMessage("DEBUG", QString("[VERIFICATION PASS] File exists with size: %1").arg(checkFile.size()));
+                        LOG_AT(LOG_DEBUG, QString("[VERIFICATION PASS] File exists with size: %1").arg(checkFile.size()));
                         updateTreeItemWithProgress(filename, progress);
                     } else {
                         logMessage("ERROR", QString("[VERIFICATION FAIL] File %1 reported 100% but doesn't exist or is empty!").arg(filename));
@@ -6955,7 +6167,7 @@ void DicomViewer::parseRobocopyOutput(const QString& output)
                 QString filepath = match.captured(2).trimmed();
                 QString filename = QFileInfo(filepath).fileName();
                 
-                logMessage("DEBUG", QString("[DVD COPY] ? Starting: %1 (%2 KB)")
+                LOG_AT(LOG_DEBUG, QString("[DVD COPY] ? Starting: %1 (%2 KB)")
                            .arg(filename)
                            .arg(fileSize / 1024));
             }
@@ -6967,7 +6179,7 @@ void DicomViewer::parseRobocopyOutput(const QString& output)
             trimmedLine.contains("Bytes :") ||
             trimmedLine.contains("Speed :") ||
             trimmedLine.contains("Ended :")) {
-            logMessage("DEBUG", QString("[ROBOCOPY SUMMARY] %1").arg(trimmedLine));
+            LOG_AT(LOG_DEBUG, QString("[ROBOCOPY SUMMARY] %1").arg(trimmedLine));
         }
         
         // Log any errors or warnings
@@ -6981,46 +6193,46 @@ void DicomViewer::parseRobocopyOutput(const QString& output)
 
 void DicomViewer::autoSelectFirstCompletedImage()
 {
-    logMessage("DEBUG", "[AUTO SELECT] === Function called ===");
-    logMessage("DEBUG", QString("[AUTO SELECT] m_dicomTree exists: %1").arg(m_dicomTree != nullptr));
-    logMessage("DEBUG", QString("[AUTO SELECT] m_firstImageAutoSelected: %1").arg(m_firstImageAutoSelected));
+    LOG_AT(LOG_DEBUG, "[AUTO SELECT] === Function called ===");
+    LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] m_dicomTree exists: %1").arg(m_dicomTree != nullptr));
+    LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] m_firstImageAutoSelected: %1").arg(m_firstImageAutoSelected));
     
     if (!m_dicomTree || m_firstImageAutoSelected) {
-        logMessage("DEBUG", "[AUTO SELECT] Early return - tree null or already selected");
+        LOG_AT(LOG_DEBUG, "[AUTO SELECT] Early return - tree null or already selected");
         return;
     }
     
-    logMessage("DEBUG", "[AUTO SELECT] Looking for first completed image to auto-select...");
-    logMessage("DEBUG", QString("[AUTO SELECT] Tree has %1 top level items").arg(m_dicomTree->topLevelItemCount()));
+    LOG_AT(LOG_DEBUG, "[AUTO SELECT] Looking for first completed image to auto-select...");
+    LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] Tree has %1 top level items").arg(m_dicomTree->topLevelItemCount()));
     
     // Recursive function to find the first DICOM image item (leaf node)
     std::function<QTreeWidgetItem*(QTreeWidgetItem*)> findFirstImageItem = 
         [&](QTreeWidgetItem* item) -> QTreeWidgetItem* {
         
         if (!item) {
-            logMessage("DEBUG", "[AUTO SELECT] Null item passed to findFirstImageItem");
+            LOG_AT(LOG_DEBUG, "[AUTO SELECT] Null item passed to findFirstImageItem");
             return nullptr;
         }
         
         // Check if this is a leaf item (DICOM image) by checking if it has no children
         if (item->childCount() == 0) {
-            logMessage("DEBUG", QString("[AUTO SELECT] Checking leaf item: %1").arg(item->text(0)));
+            LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] Checking leaf item: %1").arg(item->text(0)));
             
             // Check if this is an image item from user data (more reliable than icon)
             QVariantList userData = item->data(0, Qt::UserRole).toList();
-            logMessage("DEBUG", QString("[AUTO SELECT]   UserData size: %1").arg(userData.size()));
+            LOG_AT(LOG_DEBUG, QString("[AUTO SELECT]   UserData size: %1").arg(userData.size()));
             
             if (userData.size() >= 2 && userData[0].toString() == "image") {
                 QString filePath = userData[1].toString();
                 QString fileName = QFileInfo(filePath).fileName();
                 
-                logMessage("DEBUG", QString("[AUTO SELECT]   Is image item, file: %1").arg(fileName));
-                logMessage("DEBUG", QString("[AUTO SELECT]   In completed files: %1").arg(m_fullyCompletedFiles.contains(fileName)));
-                logMessage("DEBUG", QString("[AUTO SELECT]   File exists: %1").arg(QFile::exists(filePath)));
+                LOG_AT(LOG_DEBUG, QString("[AUTO SELECT]   Is image item, file: %1").arg(fileName));
+                LOG_AT(LOG_DEBUG, QString("[AUTO SELECT]   In completed files: %1").arg(m_fullyCompletedFiles.contains(fileName)));
+                LOG_AT(LOG_DEBUG, QString("[AUTO SELECT]   File exists: %1").arg(QFile::exists(filePath)));
                 
                 // Check if this file is completed or if it's available locally
                 if (m_fullyCompletedFiles.contains(fileName) || QFile::exists(filePath)) {
-                    logMessage("DEBUG", QString("[AUTO SELECT] ? Found completed image item: %1 (file: %2)").arg(item->text(0)).arg(fileName));
+                    LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] ? Found completed image item: %1 (file: %2)").arg(item->text(0)).arg(fileName));
                     return item;
                 }
             }
@@ -7028,11 +6240,11 @@ void DicomViewer::autoSelectFirstCompletedImage()
             // Fallback: Check icon (original logic for cases where user data isn't set)
             QIcon itemIcon = item->icon(0);
             if (!itemIcon.isNull()) {
-                logMessage("DEBUG", QString("[AUTO SELECT] Found potential image item by icon: %1").arg(item->text(0)));
+                LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] Found potential image item by icon: %1").arg(item->text(0)));
                 return item;
             }
             
-            logMessage("DEBUG", QString("[AUTO SELECT]   No match for: %1").arg(item->text(0)));
+            LOG_AT(LOG_DEBUG, QString("[AUTO SELECT]   No match for: %1").arg(item->text(0)));
         }
         
         // Recursively search children
@@ -7048,35 +6260,35 @@ void DicomViewer::autoSelectFirstCompletedImage()
     
     // Search from root level
     for (int i = 0; i < m_dicomTree->topLevelItemCount(); ++i) {
-        logMessage("DEBUG", QString("[AUTO SELECT] Searching top level item %1: %2").arg(i).arg(m_dicomTree->topLevelItem(i)->text(0)));
+        LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] Searching top level item %1: %2").arg(i).arg(m_dicomTree->topLevelItem(i)->text(0)));
         QTreeWidgetItem* firstImage = findFirstImageItem(m_dicomTree->topLevelItem(i));
         if (firstImage) {
-            logMessage("DEBUG", QString("[AUTO SELECT] ? Auto-selecting first completed image: %1").arg(firstImage->text(0)));
+            LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] ? Auto-selecting first completed image: %1").arg(firstImage->text(0)));
             
             // Expand parent items to make the selection visible
             QTreeWidgetItem* parent = firstImage->parent();
             while (parent) {
-                logMessage("DEBUG", QString("[AUTO SELECT]   Expanding parent: %1").arg(parent->text(0)));
+                LOG_AT(LOG_DEBUG, QString("[AUTO SELECT]   Expanding parent: %1").arg(parent->text(0)));
                 parent->setExpanded(true);
                 parent = parent->parent();
             }
             
             // Select the item - this will trigger onTreeItemSelected and load the image
-            logMessage("DEBUG", "[AUTO SELECT] Setting current item and scrolling to it");
+            LOG_AT(LOG_DEBUG, "[AUTO SELECT] Setting current item and scrolling to it");
             m_dicomTree->setCurrentItem(firstImage);
             m_dicomTree->scrollToItem(firstImage);
             
             // Mark that we've auto-selected the first image
             m_firstImageAutoSelected = true;
             
-            logMessage("DEBUG", "[AUTO SELECT] ? First image auto-selected and displayed!");
+            LOG_AT(LOG_DEBUG, "[AUTO SELECT] ? First image auto-selected and displayed!");
             return;
         } else {
-            logMessage("DEBUG", QString("[AUTO SELECT] No suitable image found in top level item %1").arg(i));
+            LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] No suitable image found in top level item %1").arg(i));
         }
     }
     
-    logMessage("DEBUG", "[AUTO SELECT] ? No completed images found yet for auto-selection");
+    LOG_AT(LOG_DEBUG, "[AUTO SELECT] ? No completed images found yet for auto-selection");
 }
 
 void DicomViewer::onThumbnailGeneratedWithMetadata(const QString& filePath, const QPixmap& thumbnail, const QString& instanceNumber)
@@ -7132,7 +6344,7 @@ void DicomViewer::onThumbnailGeneratedWithMetadata(const QString& filePath, cons
                 // Don't set display text - instance number is already drawn in the thumbnail overlay
                 // item->setText(instanceNumber);  // Removed to prevent duplicate instance number display
                 
-                logMessage("DEBUG", QString("Updated thumbnail for: %1 with instance number: %2").arg(QFileInfo(filePath).baseName()).arg(instanceNumber));
+                LOG_AT(LOG_DEBUG, QString("Updated thumbnail for: %1 with instance number: %2").arg(QFileInfo(filePath).baseName()).arg(instanceNumber));
             }
             break;
         }
@@ -7141,7 +6353,7 @@ void DicomViewer::onThumbnailGeneratedWithMetadata(const QString& filePath, cons
     ++m_completedThumbnails;
     int completed = m_completedThumbnails;
     int total = m_totalThumbnails;
-    logMessage("DEBUG", QString("Thumbnail progress: %1 of %2").arg(completed).arg(total));
+    LOG_AT(LOG_DEBUG, QString("Thumbnail progress: %1 of %2").arg(completed).arg(total));
     
     // Update status bar with thumbnail generation progress (batch updates to avoid UI spam)
     if (completed % 3 == 0 || completed == total) { // Update every 3rd completion or on final
@@ -7173,19 +6385,19 @@ void DicomViewer::onThumbnailGenerated(const QString& filePath, const QPixmap& t
                 
                 item->setText(instanceNumber);
                 
-                logMessage("DEBUG", QString("Updated thumbnail for: %1 with instance number: %2").arg(QFileInfo(filePath).baseName()).arg(instanceNumber));
+                LOG_AT(LOG_DEBUG, QString("Updated thumbnail for: %1 with instance number: %2").arg(QFileInfo(filePath).baseName()).arg(instanceNumber));
             }
             break;
         }
     }
     
     m_completedThumbnails++;
-    logMessage("DEBUG", QString("Thumbnail progress: %1 of %2").arg(m_completedThumbnails).arg(m_totalThumbnails));
+    LOG_AT(LOG_DEBUG, QString("Thumbnail progress: %1 of %2").arg(m_completedThumbnails).arg(m_totalThumbnails));
 }
 
 void DicomViewer::onAllThumbnailsGenerated()
 {
-    logMessage("DEBUG", "Thumbnail generation completed! Showing thumbnail panel.");
+    LOG_AT(LOG_DEBUG, "Thumbnail generation completed! Showing thumbnail panel.");
     
     // Clean up thread pool tasks (they auto-delete)
     // Mark thumbnails as complete
@@ -7195,7 +6407,7 @@ void DicomViewer::onAllThumbnailsGenerated()
     if (m_thumbnailPanel) {
         m_thumbnailPanel->setVisible(true);
         updateStatusBar("Ready", -1);
-        logMessage("DEBUG", "[THUMBNAIL PANEL] *** PANEL NOW VISIBLE *** - All thumbnails generated");
+        LOG_AT(LOG_DEBUG, "[THUMBNAIL PANEL] *** PANEL NOW VISIBLE *** - All thumbnails generated");
     }
     
     // Apply pending tree selection if any
@@ -7215,7 +6427,7 @@ void DicomViewer::onAllThumbnailsGenerated()
             QListWidgetItem* item = m_thumbnailList->item(i);
             if (item) {
                 m_thumbnailList->setCurrentItem(item);
-                logMessage("DEBUG", QString("Auto-selected first image from DICOMDIR (no previous selection): %1").arg(item->data(Qt::UserRole).toString()));
+                LOG_AT(LOG_DEBUG, QString("Auto-selected first image from DICOMDIR (no previous selection): %1").arg(item->data(Qt::UserRole).toString()));
                 break;
             }
         }
@@ -7234,28 +6446,28 @@ void DicomViewer::onAllThumbnailsGenerated()
         }
     }
     
-    logMessage("DEBUG", QString("Thumbnail panel is now visible with %1 actual thumbnails out of %2 items").arg(actualThumbnails).arg(m_thumbnailList->count()));
+    LOG_AT(LOG_DEBUG, QString("Thumbnail panel is now visible with %1 actual thumbnails out of %2 items").arg(actualThumbnails).arg(m_thumbnailList->count()));
     
     // If running from DVD and some thumbnails failed, they will be regenerated when copy completes
     if (m_copyInProgress && actualThumbnails < m_thumbnailList->count()) {
-        logMessage("DEBUG", "Some thumbnails missing due to DVD copy in progress - will regenerate after copy completion");
+        LOG_AT(LOG_DEBUG, "Some thumbnails missing due to DVD copy in progress - will regenerate after copy completion");
     }
 }
 
 void DicomViewer::onFileReadyForThumbnail(const QString& fileName)
 {
-    logMessage("DEBUG", QString("[FILE READY] File ready for thumbnail generation: %1").arg(fileName));
+    LOG_AT(LOG_DEBUG, QString("[FILE READY] File ready for thumbnail generation: %1").arg(fileName));
     
     // Construct the full file path using PathNormalizer for consistent path handling
     QString fullPath = PathNormalizer::constructFilePath(m_localDestPath, fileName);
-    logMessage(LOG_DEBUG, QString("PathNormalizer: Constructed file path for ready notification: %1").arg(fullPath));
+    LOG_AT(LOG_DEBUG, QString("PathNormalizer: Constructed file path for ready notification: %1").arg(fullPath));
     if (QFile::exists(fullPath)) {
-        logMessage("DEBUG", QString("[FILE READY] File exists and ready: %1").arg(fullPath));
+        LOG_AT(LOG_DEBUG, QString("[FILE READY] File exists and ready: %1").arg(fullPath));
         
         // IMMEDIATE FIRST IMAGE DISPLAY: Check if this is the very first available image
         if (!isDisplayingAnything()) {
             // This is the first file to become available - display it immediately!
-            logMessage(LOG_DEBUG, QString("[FILE READY] *** FIRST AVAILABLE FILE *** - Triggering immediate display: %1").arg(fullPath));
+            LOG_AT(LOG_DEBUG, QString("[FILE READY] *** FIRST AVAILABLE FILE *** - Triggering immediate display: %1").arg(fullPath));
             
             // First image found and displayed immediately
             
@@ -7263,7 +6475,7 @@ void DicomViewer::onFileReadyForThumbnail(const QString& fileName)
             requestDisplay(fullPath);
         } else {
             // Log for timing analysis
-            logMessage(LOG_DEBUG, QString("[FILE READY] First file available but already displaying something"));
+            LOG_AT(LOG_DEBUG, QString("[FILE READY] First file available but already displaying something"));
         }
         
         // NOTE: FirstImageMonitor is backup - immediate display above should handle first image
@@ -7273,7 +6485,7 @@ void DicomViewer::onFileReadyForThumbnail(const QString& fileName)
         // OLD APPROACH - DISABLED: Too many triggers for large DVD copies
         // Check if this is the first available file and no image is displayed yet
         if (!isDisplayingAnything()) {
-            logMessage(LOG_DEBUG, QString("[FILE READY] First available file - requesting immediate display: %1").arg(fullPath));
+            LOG_AT(LOG_DEBUG, QString("[FILE READY] First available file - requesting immediate display: %1").arg(fullPath));
             // Request immediate display of first available image
             requestDisplay(fullPath);
         }
@@ -7323,7 +6535,7 @@ void DicomViewer::setThumbnailState(const QString& filePath, ThumbnailState stat
     ThumbnailState oldState = m_thumbnailStates.value(filePath, ThumbnailState::NotGenerated);
     if (oldState != state) {
         m_thumbnailStates[filePath] = state;
-        logMessage("DEBUG", QString("[THUMBNAIL STATE] %1: %2 -> %3")
+        LOG_AT(LOG_DEBUG, QString("[THUMBNAIL STATE] %1: %2 -> %3")
                  .arg(filePath).arg(static_cast<int>(oldState)).arg(static_cast<int>(state)));
     }
 }
@@ -7335,7 +6547,7 @@ bool DicomViewer::areAllThumbnailsReady() const
     // Check if all thumbnail states are Ready
     for (auto it = m_thumbnailStates.begin(); it != m_thumbnailStates.end(); ++it) {
         if (it.value() != ThumbnailState::Ready) {
-            logMessage("DEBUG", QString("[THUMBNAIL CHECK] Not ready: %1 State: %2")
+            LOG_AT(LOG_DEBUG, QString("[THUMBNAIL CHECK] Not ready: %1 State: %2")
                      .arg(it.key()).arg(static_cast<int>(it.value())));
             return false;
         }
@@ -7343,11 +6555,11 @@ bool DicomViewer::areAllThumbnailsReady() const
     
     // If we have no thumbnails tracked yet, they're not ready
     if (m_thumbnailStates.isEmpty()) {
-        logMessage("DEBUG", "[THUMBNAIL CHECK] No thumbnails tracked yet");
+        LOG_AT(LOG_DEBUG, "[THUMBNAIL CHECK] No thumbnails tracked yet");
         return false;
     }
     
-    logMessage("DEBUG", QString("[THUMBNAIL CHECK] All %1 thumbnails are Ready").arg(m_thumbnailStates.size()));
+    LOG_AT(LOG_DEBUG, QString("[THUMBNAIL CHECK] All %1 thumbnails are Ready").arg(m_thumbnailStates.size()));
     return true;
 }
 
@@ -7381,7 +6593,7 @@ bool DicomViewer::areAllFilesComplete() const
     }
     
     bool allComplete = (existingFiles >= totalFiles) && (totalFiles > 0);
-    logMessage("DEBUG", QString("[FILE COMPLETION] %1 of %2 files exist (All complete: %3)")
+    LOG_AT(LOG_DEBUG, QString("[FILE COMPLETION] %1 of %2 files exist (All complete: %3)")
              .arg(existingFiles).arg(totalFiles).arg(allComplete ? "YES" : "NO"));
     
     return allComplete;
@@ -7395,25 +6607,25 @@ bool DicomViewer::beginSelection(const QString& filePath)
     
     // Check for duplicate selection
     if (m_lastSelectedFilePath == filePath) {
-        logMessage(LOG_DEBUG, QString("[DUPLICATE] Same file selected again - ignoring %1").arg(filePath));
+        LOG_AT(LOG_DEBUG, QString("[DUPLICATE] Same file selected again - ignoring %1").arg(filePath));
         return false;
     }
     
     // Simple file existence check
     if (!QFile::exists(filePath)) {
-        logMessage(LOG_DEBUG, QString("[SELECTION GUARD] File does not exist yet - ignoring %1").arg(filePath));
+        LOG_AT(LOG_DEBUG, QString("[SELECTION GUARD] File does not exist yet - ignoring %1").arg(filePath));
         return false;
     }
     
     m_lastSelectedFilePath = filePath;
-    logMessage(LOG_DEBUG, QString("[SELECTION GUARD] Beginning selection for: %1").arg(filePath));
+    LOG_AT(LOG_DEBUG, QString("[SELECTION GUARD] Beginning selection for: %1").arg(filePath));
     return true;
 }
 
 void DicomViewer::endSelection()
 {
     // Simplified selection end - no mutex needed
-    logMessage(LOG_DEBUG, "[SELECTION GUARD] Selection completed");
+    LOG_AT(LOG_DEBUG, "[SELECTION GUARD] Selection completed");
 }
 
 bool DicomViewer::isSelectionInProgress() const
@@ -7426,7 +6638,7 @@ void DicomViewer::autoSelectFirstAvailableImage()
 {
     if (!m_dicomTree) return;
     
-    logMessage("DEBUG", "[AUTO SELECT] Searching for first available image...");
+    LOG_AT(LOG_DEBUG, "[AUTO SELECT] Searching for first available image...");
     
     // Find first Available file
     QTreeWidgetItemIterator it(m_dicomTree);
@@ -7440,7 +6652,7 @@ void DicomViewer::autoSelectFirstAvailableImage()
                 
                 // Check if file exists instead of using state system
                 if (QFile::exists(filePath)) {
-                    logMessage("DEBUG", QString("[AUTO SELECT] Selecting first available image: %1").arg(filePath));
+                    LOG_AT(LOG_DEBUG, QString("[AUTO SELECT] Selecting first available image: %1").arg(filePath));
                     
                     // Use Qt's selection mechanism instead of direct function call
                     m_dicomTree->setCurrentItem(item);
@@ -7453,7 +6665,7 @@ void DicomViewer::autoSelectFirstAvailableImage()
         ++it;
     }
     
-    logMessage("DEBUG", "[AUTO SELECT] No available images found for auto-selection");
+    LOG_AT(LOG_DEBUG, "[AUTO SELECT] No available images found for auto-selection");
 }
 
 void DicomViewer::synchronizeThumbnailSelection(const QString& filePath)
@@ -7468,7 +6680,7 @@ void DicomViewer::synchronizeThumbnailSelection(const QString& filePath)
         QListWidgetItem* item = m_thumbnailList->item(i);
         if (item && item->data(Qt::UserRole).toString() == filePath) {
             m_thumbnailList->setCurrentItem(item);
-            logMessage("DEBUG", QString("[THUMBNAIL SYNC] Selected thumbnail for: %1").arg(filePath));
+            LOG_AT(LOG_DEBUG, QString("[THUMBNAIL SYNC] Selected thumbnail for: %1").arg(filePath));
             found = true;
             break;
         }
@@ -7482,7 +6694,7 @@ void DicomViewer::synchronizeThumbnailSelection(const QString& filePath)
             QString thumbnailPath = item->data(Qt::UserRole).toString();
             if (item && (PathNormalizer::normalize(thumbnailPath) == normalizedPath)) {
                 m_thumbnailList->setCurrentItem(item);
-                logMessage("DEBUG", QString("[THUMBNAIL SYNC] Selected thumbnail via normalized match: %1 -> %2").arg(filePath).arg(thumbnailPath));
+                LOG_AT(LOG_DEBUG, QString("[THUMBNAIL SYNC] Selected thumbnail via normalized match: %1 -> %2").arg(filePath).arg(thumbnailPath));
                 found = true;
                 break;
             }
@@ -7490,7 +6702,7 @@ void DicomViewer::synchronizeThumbnailSelection(const QString& filePath)
     }
     
     if (!found) {
-        logMessage("DEBUG", QString("[THUMBNAIL SYNC] No thumbnail found for: %1").arg(filePath));
+        LOG_AT(LOG_DEBUG, QString("[THUMBNAIL SYNC] No thumbnail found for: %1").arg(filePath));
     }
 }
 
@@ -7498,24 +6710,24 @@ void DicomViewer::synchronizeThumbnailSelection(const QString& filePath)
 
 void DicomViewer::initializeDisplayMonitor()
 {
-    logMessage(LOG_DEBUG, "[DISPLAY MONITOR] Initializing event-based display monitor system...");
+    LOG_AT(LOG_DEBUG, "[DISPLAY MONITOR] Initializing event-based display monitor system...");
     
     // No timer needed - using event-based approach via updateTreeIconForFile()
     // First image selection happens automatically when tree icons are updated
     
-    logMessage(LOG_DEBUG, "[DISPLAY MONITOR] Event-based display monitor initialized");
+    LOG_AT(LOG_DEBUG, "[DISPLAY MONITOR] Event-based display monitor initialized");
 }
 
 void DicomViewer::startDisplayMonitor()
 {
     // Simplified approach - no complex display monitor needed
-    logMessage(LOG_DEBUG, "[DISPLAY MONITOR] Simplified display monitor - no timer needed");
+    LOG_AT(LOG_DEBUG, "[DISPLAY MONITOR] Simplified display monitor - no timer needed");
 }
 
 void DicomViewer::stopDisplayMonitor()
 {
     // Simplified approach - no complex display monitor needed
-    logMessage(LOG_DEBUG, "[DISPLAY MONITOR] Simplified display monitor - no timer to stop");
+    LOG_AT(LOG_DEBUG, "[DISPLAY MONITOR] Simplified display monitor - no timer to stop");
 }
 
 void DicomViewer::requestDisplay(const QString& filePath)
@@ -7603,7 +6815,7 @@ void DicomViewer::updateTreeIconForFile(QTreeWidgetItem* item)
         static bool firstImageSelected = false;
         if (!firstImageSelected && !isDisplayingAnything()) {
             firstImageSelected = true;
-            logMessage("DEBUG", QString("[FIRST IMAGE EVENT] Auto-selecting first available image: %1").arg(QFileInfo(filePath).fileName()));
+            LOG_AT(LOG_DEBUG, QString("[FIRST IMAGE EVENT] Auto-selecting first available image: %1").arg(QFileInfo(filePath).fileName()));
             
             // Use Qt's selection mechanism to respect user interaction guards
             m_dicomTree->setCurrentItem(item);
@@ -7614,6 +6826,32 @@ void DicomViewer::updateTreeIconForFile(QTreeWidgetItem* item)
     }
 }
 
+void DicomViewer::probeFrameCountsAsync(const QStringList& filePaths)
+{
+    if (!m_dicomReader) return;
+    
+    // The destructor waits for the pool, so the viewer and cache outlive every probe
+    DicomThumbnailCache* cache = m_dicomReader->thumbnailCache();
+    for (const QString& filePath : filePaths) {
+        m_thumbnailPool.start([this, cache, filePath]() {
+            int frameCount = DicomReader::probeFrameCount(filePath, cache);
+            QMetaObject::invokeMethod(this, [this, filePath, frameCount]() {
+                onFrameCountProbed(filePath, frameCount);
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+void DicomViewer::onFrameCountProbed(const QString& filePath, int frameCount)
+{
+    if (!m_dicomReader || !m_dicomReader->setFrameCountForFile(filePath, frameCount)) {
+        return;
+    }
+    
+    // Text, icon, tooltip and type of the one tree item showing this file follow the new count
+    m_dicomReader->updateTreeItems(QStringList() << filePath);
+}
+
 void DicomViewer::updateAllTreeIcons()
 {
     if (!m_dicomTree) return;
@@ -7621,10 +6859,11 @@ void DicomViewer::updateAllTreeIcons()
     QTreeWidgetItem* currentItem = m_dicomTree->currentItem();
     m_dicomTree->blockSignals(true);
     
-    QTreeWidgetItemIterator it(m_dicomTree);
-    while (*it) {
-        updateTreeIconForFile(*it);
-        ++it;
+    // Only file items carry an icon that depends on the file
+    if (m_dicomReader) {
+        for (QTreeWidgetItem* item : m_dicomReader->fileTreeItems()) {
+            updateTreeIconForFile(item);
+        }
     }
     
     m_dicomTree->blockSignals(false);
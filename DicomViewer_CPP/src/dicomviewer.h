@@ -1,39 +1,7 @@
 ﻿#pragma once
 
-// Undefine Windows macros that conflict with our enum
-#ifdef _WIN32
-    #ifdef ERROR
-        #undef ERROR
-    #endif
-    #ifdef DEBUG  
-        #undef DEBUG
-    #endif
-    #ifdef INFO
-        #undef INFO
-    #endif
-    #ifdef WARN
-        #undef WARN
-    #endif
-#endif
-
-// Log Level Enumeration for filtering
-enum LogLevel {
-    LOG_DEBUG = 0,
-    LOG_INFO = 1,
-    LOG_WARN = 2,
-    LOG_ERROR = 3
-};
-
-// Default log level - can be overridden by CMake
-#ifdef FORCE_DEBUG_LOGS
-    #define DEFAULT_LOG_LEVEL LOG_DEBUG
-#else
-    #ifdef NDEBUG
-        #define DEFAULT_LOG_LEVEL LOG_INFO
-    #else
-        #define DEFAULT_LOG_LEVEL LOG_DEBUG
-    #endif
-#endif
+// LogLevel, DEFAULT_LOG_LEVEL and LOG_AT
+#include "AsyncLogger.h"
 
 // Forward declarations
 class DicomReader;
@@ -62,6 +30,7 @@ class QListWidget;
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QFrame>
 #include <QtWidgets/QTextEdit>
+#include <QtWidgets/QTreeView>
 #include <QtWidgets/QListWidget>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QStackedWidget>
@@ -99,6 +68,12 @@ class QListWidget;
 #include "dicomreader.h"
 #include "progressiveframeloader.h"
 #include "DicomFrameProcessor.h"
+#include "DicomDatasetHandle.h"
+#include "DicomPixelFrame.h"
+#include "DicomFrameStore.h"
+#include "DicomThumbnailCache.h"
+#include "DicomTagModel.h"
+#include "WindowLevelEngine.h"
 #include "DicomPlaybackController_Simple.h"
 #include "DicomInputHandler_Simple.h"
 
@@ -204,14 +179,21 @@ public:
     void setHorizontalFlipEnabled(bool enabled);
     void setVerticalFlipEnabled(bool enabled);
     void setInvertEnabled(bool enabled);
+    // Window center/width are in modality units (stored value * slope + intercept)
     void setWindowLevel(double windowCenter, double windowWidth);
     void setWindowLevelEnabled(bool enabled);
     void setBitsStored(int bitsStored);
+    void setRescale(double slope, double intercept);
     void resetAllTransformations();
     
-    // Main pipeline execution
+    // Main pipeline execution. W/L, flips and invert run as one fused pass into a
+    // reusable buffer; the returned image shares it, so don't hold on to it
+    // across calls (convert to QPixmap or copy() instead).
     QImage processImage(const QImage& sourceImage) const;
     
+    // Full-bit-depth execution: W/L straight from stored values, no 8-bit source
+    QImage processFrame(const DicomPixelFrame& frame) const;
+    
     // Individual pipeline stages (decompression handled by DCMTK/GDCM/libjpeg)
     QImage horizontalFlipStage(const QImage& input) const;
     QImage verticalFlipStage(const QImage& input) const;
@@ -229,6 +211,10 @@ public:
     bool hasAnyTransformations() const;
     
 private:
+    // LUT parameters for native stored values, and for frames DCMTK already mapped to 8 bits
+    WindowLevelEngine::Parameters frameWindowParameters(const DicomPixelFrame& frame) const;
+    WindowLevelEngine::Parameters grayscale8WindowParameters() const;
+    
     bool m_hFlipEnabled;
     bool m_vFlipEnabled;
     bool m_invertEnabled;
@@ -236,6 +222,14 @@ private:
     double m_windowCenter;
     double m_windowWidth;
     int m_bitsStored;
+    double m_rescaleSlope;
+    double m_rescaleIntercept;
+    
+    // Cached W/L lookup table; rebuilt only when window or rescale changes
+    mutable WindowLevelEngine m_windowLevelEngine;
+    
+    // Output of the fused pass, reused while its size stays the same
+    mutable QImage m_outputBuffer;
 };
 
 class DicomViewer : public QMainWindow
@@ -251,6 +245,9 @@ public:
     
     // Public method to load DICOMDIR from external code
     void loadDicomdirFile(const QString& dicomdirPath) { loadDicomDir(dicomdirPath); }
+    
+    // Memory budget for decoded frames of the open image
+    void setFrameCacheBudgetMB(int budgetMB) { m_frameStore->setBudgetMB(budgetMB); }
 
 protected:
     void resizeEvent(QResizeEvent *event) override;
@@ -304,7 +301,7 @@ private slots:
     
     // Progressive loading slots
     void onFrameReady(int frameNumber);
-    void onAllFramesLoaded(int totalFrames);
+    void onInitialWindowLoaded(int totalFrames);
     void onProgressiveTimerTimeout(); // For FPS-controlled progressive display
     void onFirstFrameInfo(const QString& patientName, const QString& patientId, int totalFrames);
     void onLoadingError(const QString& errorMessage);
@@ -351,7 +348,8 @@ private slots:
     
     // Race condition prevention slots
     void onFileReadyForThumbnail(const QString& fileName);
-    void onThumbnailTaskCompleted(const QString& filePath, const QPixmap& thumbnail, const QString& instanceNumber);
+    void onThumbnailTaskCompleted(const QString& filePath, const QImage& thumbnail, const QString& instanceNumber, int frameCount);
+    void flushCompletedThumbnails();
 
     // Logging methods (public for global access)
     void initializeLogging();
@@ -379,7 +377,7 @@ private:
     void generateThumbnail(const QString& filePath, QListWidgetItem* item);
     void generateThumbnailsInBackground();
     QPixmap createLoadingThumbnail();
-    QPixmap createReportThumbnail(const QString& filePath);
+    static QImage createReportThumbnail(const QString& filePath);
     QPixmap createFrameTypeIcon(int frameCount);
     QListWidgetItem* createPatientSeparator(const QString& patientName);
     void installEventFilters();
@@ -397,6 +395,7 @@ private:
     void toggleDicomInfo();
     void createDicomInfoPanel();
     void populateDicomInfo(const QString& filePath);
+    void showDicomInfo(const QString& filePath, const std::shared_ptr<DicomDatasetHandle>& dataset);
     
     // Status bar methods
     void createStatusBar();
@@ -404,15 +403,18 @@ private:
     
     // Progressive loading methods
     void displayCachedFrame(int frameIndex);
+    void reportPlayhead(int frameIndex);
     void clearFrameCache();
+    void showFramePending(int frameIndex);
+    bool isFrameAvailable(int frameIndex) const;
     void setTransformationActionsEnabled(bool enabled);
     
     // Framework helper methods (simplified)
     
     // DICOM image loading methods
     void loadDicomImage(const QString& filePath);
-    QPixmap convertDicomFrameToPixmap(const QString& filePath, int frameIndex = 0);
-    void setupMultiframePlayback(const QString& filePath);
+    static QImage convertDicomFrameToImage(const QString& filePath, int frameIndex = 0);
+    void setupMultiframePlayback(const std::shared_ptr<DicomDatasetHandle>& datasetHandle);
     
     // Image processing methods - Pipeline Architecture
     void processThroughPipeline();
@@ -474,7 +476,7 @@ private:
     QTreeWidgetItem* findLastSelectableChild(QTreeWidgetItem* parent);
     
     // DICOM metadata methods
-    void extractDicomMetadata(const QString& filePath);
+    void extractDicomMetadata(const std::shared_ptr<DicomDatasetHandle>& datasetHandle);
     QString cleanDicomText(const QString& text);
     
     // Member variables for UI components
@@ -501,9 +503,22 @@ private:
     QAtomicInt m_completedThumbnails;
     QAtomicInt m_totalThumbnails;
     QAtomicInt m_activeThumbnailTasks;
+    QThreadPool m_thumbnailPool;             // Low-priority pool, separate from the frame decode pool
+    
+    // Thumbnails finished by worker tasks, converted to pixmaps on the GUI thread once per event-loop pass
+    struct CompletedThumbnail
+    {
+        QString filePath;
+        QImage image;
+        QString instanceNumber;
+        int frameCount;
+    };
+    QVector<CompletedThumbnail> m_completedThumbnailQueue;
+    bool m_thumbnailFlushScheduled;
+    quint64 m_reportRequestId;               // Latest displayReport() call; older results are dropped
+    DicomThumbnailCache m_thumbnailCache;    // Thumbnails and header values kept across sessions
     
     // Race condition prevention members
-    QMutex m_dcmtkAccessMutex;           // Protect all DCMTK operations
     QAtomicInt m_thumbnailGenerationActive;  // 0=idle, 1=active
 
     QQueue<QString> m_pendingSelections;     // Queue user clicks during generation
@@ -534,14 +549,13 @@ private:
     QLabel* m_overlayBottomLeft;
     QLabel* m_overlayBottomRight;
     
-    // DICOM info panel
+    // DICOM info panel (tag tree over the shared dataset, rows created on demand)
     bool m_dicomInfoVisible;
     QWidget* m_dicomInfoWidget;
-    QTextEdit* m_dicomInfoTextEdit;
-    
-    // DICOM info caching
-    QString m_cachedDicomInfoFilePath;
-    QString m_cachedDicomInfoHtml;
+    QTreeView* m_dicomInfoView;
+    QLabel* m_dicomInfoMessage;      // Shown instead of the view when there is nothing to list
+    DicomTagModel* m_dicomTagModel;
+    quint64 m_dicomInfoRequestId;    // Latest populateDicomInfo() call; older parses are dropped
     
     // Professional framework components (simplified)
     DicomPlaybackController* m_playbackController;
@@ -555,14 +569,14 @@ private:
     bool m_playbackPausedForFrame;  // Track if playback was paused waiting for a frame
     QTimer* m_playbackTimer;
     QString m_currentImagePath;
+    std::shared_ptr<DicomDatasetHandle> m_currentDataset;  // Parsed once per opened image
     
     // Progressive loading variables
     ProgressiveFrameLoader* m_progressiveLoader;
-    DicomFrameProcessor* m_frameProcessor;
     bool m_isLoadingProgressively;
-    bool m_allFramesCached;
-    QMap<int, QPixmap> m_frameCache;
-    QMap<int, QByteArray> m_originalPixelCache;
+    bool m_initialWindowLoaded;                        // First decode window done; later frames follow the playhead
+    std::shared_ptr<DicomFrameStore> m_frameStore;     // Decoded frames under a memory budget
+    DicomPixelFrame m_currentPixelFrame;               // Native data of the displayed frame
     
     // Progressive display timing control
     QTimer* m_progressiveTimer;
@@ -664,6 +678,8 @@ private:
     QString getItemPath(QTreeWidgetItem* item) const;
     void updateTreeIconForFile(QTreeWidgetItem* item);
     void updateAllTreeIcons();
+    void probeFrameCountsAsync(const QStringList& filePaths);
+    void onFrameCountProbed(const QString& filePath, int frameCount);
     void checkFirstAvailableImage();
     QIcon getIconForFile(const QString& filePath) const;
     void applyWindowingToTransformedData(const QByteArray& data, double center, double width);
@@ -688,16 +704,8 @@ private:
     void autoSelectFirstCompletedImage();  // Auto-select first completed image for better UX
     
     // RDSR (Radiation Dose Structured Report) methods
+    // Parsing and HTML rendering live in DicomSRDocument / DicomSRHtmlRenderer and run on a worker
     void displayReport(const QString& filePath);
-    QString formatSRReport(const QString& filePath);
-    bool isRadiationDoseSR(const QString& filePath);
-    QString formatRadiationDoseReport(const QString& filePath);
-    QString formatRDSRHeader(const QString& filePath);
-    QString formatRDSRProcedureInfo(const QString& filePath);
-    QString formatAccumulatedDoseData(const QString& filePath);
-    QString formatIrradiationEvents(const QString& filePath);
-    QString formatDateTime(const QString& dtString);
-    QString formatMeasurement(const QString& name, const QString& value, const QString& unit = QString(), int indent = 0);
     QString getCodeSequenceValue(const QString& filePath, const QString& tagPath);
     QString extractDoseValue(const QString& filePath, const QString& conceptName);
     QString extractEventData(const QString& filePath, int eventIndex);
@@ -705,10 +713,8 @@ private:
     QString formatFilterInfo(const QString& filterData, int indent = 2);
     
 private:
-    // Logging members
-    mutable QString m_logFilePath;
-    mutable QMutex m_logMutex;
-    mutable LogLevel m_minLogLevel;  // Minimum log level to actually write
+    // Logging members (writes go through AsyncLogger)
+    QString m_logFilePath;
     
     // Source drive (from command line parameter)
     QString m_providedSourceDrive;
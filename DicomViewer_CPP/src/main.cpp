@@ -1,4 +1,5 @@
 ﻿#include "dicomviewer.h"
+#include "PerfTrace.h"
 #include <QtWidgets/QApplication>
 #include <QLoggingCategory>
 #include <QDebug>
@@ -73,6 +74,7 @@ int main(int argc, char *argv[])
     // Parse command line arguments for source drive and dicomdir
     QString sourceDrive;
     QString dicomdirPath;
+    int frameCacheMB = 0;
     QStringList args = app.arguments();
     
     for (int i = 0; i < args.size(); ++i) {
@@ -99,10 +101,24 @@ int main(int argc, char *argv[])
             dicomdirPath = args[i + 1];
             std::cout << "DICOMDIR path specified: " << dicomdirPath.toStdString() << std::endl;
         }
+        else if (arg.startsWith("--frame-cache-mb=")) {
+            frameCacheMB = arg.mid(17).toInt(); // Remove "--frame-cache-mb=" prefix
+        }
+        else if (arg == "--perf-stats") {
+            // Stage latency histograms, written to the log on exit
+            PerfTrace::enable();
+        }
+        else if (arg.startsWith("--trace=")) {
+            // Histograms plus a Chrome trace / Perfetto JSON file of every span
+            PerfTrace::enable(arg.mid(8)); // Remove "--trace=" prefix
+        }
     }
     
     // Create and show the main window
     DicomViewer viewer(nullptr, sourceDrive);
+    if (frameCacheMB > 0) {
+        viewer.setFrameCacheBudgetMB(frameCacheMB);
+    }
     
     viewer.show();
     
@@ -1,19 +1,23 @@
 ﻿#include "progressiveframeloader.h"
+#include "AsyncLogger.h"
+#include "PerfTrace.h"
 #include <QtCore/QDebug>
 #include <QtCore/QMutexLocker>
 #include <QtGui/QImage>
 #include <QtCore/QThread>
-#include <chrono>
+#include <climits>
 
-ProgressiveFrameLoader::ProgressiveFrameLoader(const QString& filePath, QObject* parent)
+ProgressiveFrameLoader::ProgressiveFrameLoader(std::shared_ptr<DicomDatasetHandle> dataset,
+                                               std::shared_ptr<DicomFrameStore> frameStore, QObject* parent)
     : QThread(parent)
-    , m_filePath(filePath)
+    , m_dataset(std::move(dataset))
+    , m_frameStore(std::move(frameStore))
+    , m_filePath(m_dataset ? m_dataset->filePath() : QString())
     , m_stopped(false)
     , m_frameProcessor(nullptr)
-#ifdef HAVE_DCMTK
-    , m_dcmFile(nullptr)
-    , m_dataset(nullptr)
-#endif
+    , m_windowFilled(false)
+    , m_windowSized(false)
+    , m_decodedCount(0)
 {
 }
 
@@ -21,18 +25,17 @@ ProgressiveFrameLoader::~ProgressiveFrameLoader()
 {
     stop();
     wait(); // Wait for thread to finish
+    m_decodePool.waitForDone(); // Workers use m_frameProcessor
     
     delete m_frameProcessor;
-    
-#ifdef HAVE_DCMTK
-    delete m_dcmFile;
-#endif
 }
 
 void ProgressiveFrameLoader::stop()
 {
     QMutexLocker locker(&m_mutex);
     m_stopped = true;
+    m_workAvailable.wakeAll();
+    m_windowComplete.wakeAll();
 }
 
 bool ProgressiveFrameLoader::isStopped() const
@@ -41,28 +44,119 @@ bool ProgressiveFrameLoader::isStopped() const
     return m_stopped;
 }
 
+void ProgressiveFrameLoader::setPlayhead(int frameIndex)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_scheduler.setPlayhead(frameIndex)) {
+        LOG_AT(LOG_DEBUG, QString("ProgressiveFrameLoader: playhead jumped to frame %1").arg(frameIndex));
+    }
+    // The window moved (or its split changed) - idle workers pick up the new frames
+    m_workAvailable.wakeAll();
+}
+
+void ProgressiveFrameLoader::sizeWindowLocked(const DecodedFrame& decoded)
+{
+    // Caller holds m_mutex. Fit the window to the store budget, with room to spare
+    // so the store's own eviction does not fight the window.
+    StoredFrame cost;
+    cost.pixels = decoded.pixels;
+    cost.image = decoded.image;
+    const qint64 frameBytes = cost.sizeInBytes();
+    if (frameBytes <= 0) {
+        // Views of a mapped file cost the store nothing
+        return;
+    }
+    const qint64 budgetBytes = static_cast<qint64>(m_frameStore->budgetMB()) * 1024 * 1024;
+    const qint64 windowFrames = qMax<qint64>(1, budgetBytes * 3 / 4 / frameBytes);
+    m_scheduler.setWindowFrames(static_cast<int>(qMin<qint64>(windowFrames, INT_MAX)));
+}
+
+void ProgressiveFrameLoader::decodeWorker()
+{
+    const auto isStored = [this](int frame) { return m_frameStore->contains(frame); };
+    
+    while (true) {
+        int frameIndex = -1;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_stopped && (frameIndex = m_scheduler.takeNext(isStored)) < 0) {
+                if (!m_windowFilled && m_scheduler.inFlightCount() == 0) {
+                    // Every frame of the first window is decoded (or undecodable)
+                    m_windowFilled = true;
+                    m_windowComplete.wakeAll();
+                }
+                m_workAvailable.wait(&m_mutex);
+            }
+            if (m_stopped) {
+                return;
+            }
+        }
+        
+        DecodedFrame decoded;
+        try {
+            // Keep native samples for full-bit-depth W/L; 8-bit decode only when there are none
+            decoded.pixels = m_frameProcessor->decodePixelFrame(frameIndex);
+            if (decoded.pixels.isNull()) {
+                decoded.image = m_frameProcessor->decodeFrame(frameIndex);
+            }
+        } catch (...) {
+            decoded = DecodedFrame();
+        }
+        
+        const bool ok = !decoded.pixels.isNull() || !decoded.image.isNull();
+        bool wanted = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            // A jump while this frame was decoding may have left it outside the window;
+            // storing it then would only evict frames that are wanted
+            wanted = ok && !m_stopped && m_scheduler.isWanted(frameIndex);
+            if (wanted && !m_windowSized) {
+                m_windowSized = true;
+                sizeWindowLocked(decoded);
+            }
+        }
+        
+        // Hand the frame to the shared, budgeted store (no data in the signal).
+        // It stays claimed until then, so no other worker decodes it meanwhile.
+        if (wanted) {
+            m_frameStore->insert(frameIndex, decoded.pixels, decoded.image);
+            emit frameReady(frameIndex);
+        }
+        
+        int decodedCount = 0;
+        int windowFrames = 0;
+        bool initialLoad = false;
+        {
+            QMutexLocker locker(&m_mutex);
+            m_scheduler.finish(frameIndex, ok);
+            if (wanted && !m_decodedOnce[frameIndex]) {
+                m_decodedOnce[frameIndex] = true;
+                ++m_decodedCount;
+            }
+            decodedCount = m_decodedCount;
+            windowFrames = m_scheduler.windowFrames();
+            initialLoad = wanted && !m_windowFilled;
+        }
+        if (initialLoad) {
+            emit loadingProgress(qMin(decodedCount, windowFrames), windowFrames);
+        }
+    }
+}
+
 void ProgressiveFrameLoader::run()
 {
-    auto runStart = std::chrono::high_resolution_clock::now();
-    auto runTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(runStart.time_since_epoch()).count();
+    PerfSpan span("ProgressiveFrameLoader::run", PerfStage::None);
     
     try {
-        // Initialize DicomFrameProcessor with GDCM support
-        auto processorStart = std::chrono::high_resolution_clock::now();
-        auto processorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(processorStart.time_since_epoch()).count();
-        
+        // Initialize DicomFrameProcessor with GDCM support. It only decodes:
+        // workers decide what goes into the store, after the isWanted() check.
         m_frameProcessor = new DicomFrameProcessor();
-        if (!m_frameProcessor->loadDicomFile(m_filePath)) {
-            auto errorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+        if (!m_dataset || !m_frameStore || !m_frameProcessor->loadDicomFile(m_dataset)) {
             emit errorOccurred("DicomFrameProcessor failed to load DICOM file");
             return;
         }
         
-        auto processorEnd = std::chrono::high_resolution_clock::now();
-        auto processorDuration = std::chrono::duration_cast<std::chrono::milliseconds>(processorEnd - processorStart).count();
-        auto processorEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(processorEnd.time_since_epoch()).count();
-        
-        // Load DICOM metadata first (for backward compatibility)
+        // Read overlay metadata from the shared dataset
         if (!loadDicomMetadata()) {
             emit errorOccurred("Failed to load DICOM metadata");
             return;
@@ -71,65 +165,39 @@ void ProgressiveFrameLoader::run()
         // Emit first frame info for overlay setup
         emit firstFrameInfo(m_metadata.patientName, m_metadata.patientId, m_metadata.totalFrames);
         
-        // Process frames one by one
-        for (int frameIndex = 0; frameIndex < m_metadata.totalFrames; frameIndex++) {
-            
-            // Check if we should stop
-            if (isStopped()) {
-                return;
-            }
-            
-            // Process this frame
-            auto frameStart = std::chrono::high_resolution_clock::now();
-            auto frameTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(frameStart.time_since_epoch()).count();
-            
-            QPixmap framePixmap = processFrame(frameIndex);
-            
-            auto frameEnd = std::chrono::high_resolution_clock::now();
-            auto frameDuration = std::chrono::duration_cast<std::chrono::milliseconds>(frameEnd - frameStart).count();
-            auto frameEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(frameEnd.time_since_epoch()).count();
-            
-            if (framePixmap.isNull()) {
-                continue;
-            } else {
-            }
-            
-            // Skip expensive DCMTK extraction - GDCM already provides the frame data
-            // For progressive loading speed, we'll get original data from GDCM when needed
-            QByteArray originalData; // Empty for now - will be populated on-demand
-            
-            // Cache frame data in thread-safe storage (eliminates 350ms signal transfer)
-            auto cacheStart = std::chrono::high_resolution_clock::now();
-            auto cacheTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(cacheStart.time_since_epoch()).count();
-            
-            cacheFrame(frameIndex, framePixmap, originalData);
-            
-            // Emit lightweight signal (frame index only - no data transfer)
-            emit frameReady(frameIndex);
-            
-            auto cacheEnd = std::chrono::high_resolution_clock::now();
-            auto cacheDuration = std::chrono::duration_cast<std::chrono::milliseconds>(cacheEnd - cacheStart).count();
-            auto cacheEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(cacheEnd.time_since_epoch()).count();
-            
-            // Emit progress update
-            emit loadingProgress(frameIndex + 1, m_metadata.totalFrames);
-            
-            // Optimized delay strategy - leverage GDCM batch decompression speed
-            // Since GDCM does batch decompression (0ms per frame after initial batch),
-            // we can process frames much faster during progressive loading
-            if (m_metadata.totalFrames > 200) {
-                msleep(1); // 1ms delay only for very large datasets (1000 FPS max)
-            } else if (m_metadata.totalFrames > 50) {
-                // No delay for medium datasets - GDCM batch mode handles this efficiently
-                QThread::yieldCurrentThread(); // Just yield to be cooperative
-            } else {
-                // No delay for smaller datasets - let GDCM performance shine
+        // The window starts as the whole run and shrinks to the budget once a
+        // frame's cost is known; decoding runs on all cores when frames are independent
+        const int totalFrames = qMax(1, m_metadata.totalFrames);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_scheduler.reset(totalFrames);
+            m_windowFilled = false;
+            m_windowSized = false;
+            m_decodedOnce.assign(totalFrames, false);
+            m_decodedCount = 0;
+        }
+        
+        int workerCount = 1;
+        if (m_frameProcessor->canDecodeConcurrently()) {
+            workerCount = qBound(1, QThread::idealThreadCount(), totalFrames);
+        }
+        m_decodePool.setMaxThreadCount(workerCount);
+        for (int i = 0; i < workerCount; ++i) {
+            m_decodePool.start([this]() { decodeWorker(); });
+        }
+        
+        // Workers store and announce frames themselves; wait for the first window.
+        // They keep following the playhead afterwards, until stop().
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_stopped && !m_windowFilled) {
+                m_windowComplete.wait(&m_mutex);
             }
         }
         
-        // All frames processed successfully
+        // First window processed successfully
         if (!isStopped()) {
-            emit allFramesLoaded(m_metadata.totalFrames);
+            emit initialWindowLoaded(m_metadata.totalFrames);
         }
         
     } catch (const std::exception& e) {
@@ -142,26 +210,24 @@ void ProgressiveFrameLoader::run()
 bool ProgressiveFrameLoader::loadDicomMetadata()
 {
 #ifdef HAVE_DCMTK
+    if (!m_dataset) {
+        return false;
+    }
+    
     try {
-        // Create and load DICOM file
-        m_dcmFile = new DcmFileFormat();
-        OFCondition status = m_dcmFile->loadFile(m_filePath.toLocal8Bit().constData());
-        
-        if (status.bad()) {
-            return false;
-        }
-        
-        m_dataset = m_dcmFile->getDataset();
-        if (!m_dataset) {
+        // The dataset was parsed once by the viewer - just read tags from it
+        QMutexLocker datasetLocker(m_dataset->mutex());
+        DcmDataset* dataset = m_dataset->dataset();
+        if (!dataset) {
             return false;
         }
         
         // Extract basic metadata
         OFString patientName, patientId, studyDesc, seriesDesc;
-        m_dataset->findAndGetOFString(DCM_PatientName, patientName);
-        m_dataset->findAndGetOFString(DCM_PatientID, patientId);
-        m_dataset->findAndGetOFString(DCM_StudyDescription, studyDesc);
-        m_dataset->findAndGetOFString(DCM_SeriesDescription, seriesDesc);
+        dataset->findAndGetOFString(DCM_PatientName, patientName);
+        dataset->findAndGetOFString(DCM_PatientID, patientId);
+        dataset->findAndGetOFString(DCM_StudyDescription, studyDesc);
+        dataset->findAndGetOFString(DCM_SeriesDescription, seriesDesc);
         
         m_metadata.patientName = QString::fromStdString(patientName.c_str());
         m_metadata.patientId = QString::fromStdString(patientId.c_str());
@@ -170,25 +236,25 @@ bool ProgressiveFrameLoader::loadDicomMetadata()
         
         // Get image dimensions
         Uint16 rows, columns;
-        if (m_dataset->findAndGetUint16(DCM_Rows, rows).good()) {
+        if (dataset->findAndGetUint16(DCM_Rows, rows).good()) {
             m_metadata.imageHeight = rows;
         }
-        if (m_dataset->findAndGetUint16(DCM_Columns, columns).good()) {
+        if (dataset->findAndGetUint16(DCM_Columns, columns).good()) {
             m_metadata.imageWidth = columns;
         }
         
         // Get window/level values
         OFString windowCenter, windowWidth;
-        if (m_dataset->findAndGetOFString(DCM_WindowCenter, windowCenter).good()) {
+        if (dataset->findAndGetOFString(DCM_WindowCenter, windowCenter).good()) {
             m_metadata.windowCenter = QString::fromStdString(windowCenter.c_str()).toDouble();
         }
-        if (m_dataset->findAndGetOFString(DCM_WindowWidth, windowWidth).good()) {
+        if (dataset->findAndGetOFString(DCM_WindowWidth, windowWidth).good()) {
             m_metadata.windowWidth = QString::fromStdString(windowWidth.c_str()).toDouble();
         }
         
         // Get number of frames
         OFString numberOfFrames;
-        if (m_dataset->findAndGetOFString(DCM_NumberOfFrames, numberOfFrames).good()) {
+        if (dataset->findAndGetOFString(DCM_NumberOfFrames, numberOfFrames).good()) {
             m_metadata.totalFrames = QString::fromStdString(numberOfFrames.c_str()).toInt();
         } else {
             m_metadata.totalFrames = 1; // Single frame
@@ -207,132 +273,7 @@ bool ProgressiveFrameLoader::loadDicomMetadata()
 #endif
 }
 
-QPixmap ProgressiveFrameLoader::processFrame(int frameIndex)
-{
-    // Use DicomFrameProcessor for GDCM-accelerated processing
-    if (!m_frameProcessor) {
-        auto errorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        return QPixmap();
-    }
-    
-    try {
-        // Use DicomFrameProcessor to get the frame with GDCM acceleration
-        auto frameProcessStart = std::chrono::high_resolution_clock::now();
-        auto frameProcessTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(frameProcessStart.time_since_epoch()).count();
-        
-        QImage frameImage = m_frameProcessor->getFrameAsQImage(frameIndex);
-        
-        auto frameProcessEnd = std::chrono::high_resolution_clock::now();
-        auto frameProcessDuration = std::chrono::duration_cast<std::chrono::milliseconds>(frameProcessEnd - frameProcessStart).count();
-        auto frameProcessEndTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(frameProcessEnd.time_since_epoch()).count();
-        
-        if (frameImage.isNull()) {
-            return QPixmap();
-        }
-        
-        // Convert to RGB format for better compatibility
-        auto conversionStart = std::chrono::high_resolution_clock::now();
-        QImage rgbImage = frameImage.convertToFormat(QImage::Format_RGB888);
-        QPixmap pixmap = QPixmap::fromImage(rgbImage);
-        auto conversionEnd = std::chrono::high_resolution_clock::now();
-        auto conversionDuration = std::chrono::duration_cast<std::chrono::milliseconds>(conversionEnd - conversionStart).count();
-        auto conversionTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(conversionEnd.time_since_epoch()).count();
-        
-        return pixmap;
-        
-    } catch (const std::exception& e) {
-        auto errorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        return QPixmap();
-    } catch (...) {
-        auto errorTimestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-        return QPixmap();
-    }
-}
-
-QByteArray ProgressiveFrameLoader::extractOriginalPixelData(int frameIndex)
-{
-#ifdef HAVE_DCMTK
-    try {
-        // Create DicomImage to get raw pixel data
-        DicomImage* dicomImage = new DicomImage(m_filePath.toLocal8Bit().constData(), CIF_AcrNemaCompatibility);
-        
-        if (!dicomImage || dicomImage->getStatus() != EIS_Normal) {
-            delete dicomImage;
-            return QByteArray();
-        }
-        
-        // For multiframe images, select the specific frame
-        if (m_metadata.totalFrames > 1) {
-            // Use the constructor with frame selection instead of createScaledImage
-            delete dicomImage;
-            dicomImage = new DicomImage(m_filePath.toLocal8Bit().constData(), CIF_AcrNemaCompatibility, frameIndex);
-            
-            if (!dicomImage || dicomImage->getStatus() != EIS_Normal) {
-                delete dicomImage;
-                return QByteArray();
-            }
-        }
-        
-        // Get original pixel data (16-bit or whatever the original depth is)
-        const void* rawPixelData = dicomImage->getOutputData(16 /* preserve original depth */);
-        if (!rawPixelData) {
-            delete dicomImage;
-            return QByteArray();
-        }
-        
-        // Calculate size and copy data
-        size_t dataSize = m_metadata.imageWidth * m_metadata.imageHeight * sizeof(Uint16);
-        QByteArray originalData(static_cast<const char*>(rawPixelData), dataSize);
-        
-        delete dicomImage;
-        return originalData;
-        
-    } catch (const std::exception& e) {
-        return QByteArray();
-    } catch (...) {
-        return QByteArray();
-    }
-#else
-    Q_UNUSED(frameIndex)
-    return QByteArray();
-#endif
-}
-
-// Thread-safe frame caching methods (eliminates 350ms signal transfer delay)
-
-void ProgressiveFrameLoader::cacheFrame(int frameIndex, const QPixmap& pixmap, const QByteArray& originalData)
-{
-    QWriteLocker locker(&m_frameCacheLock);
-    FrameData frameData;
-    frameData.pixmap = pixmap;
-    frameData.originalData = originalData;
-    frameData.isReady = true;
-    m_frameCache[frameIndex] = frameData;
-}
-
-QPixmap ProgressiveFrameLoader::getFramePixmap(int frameIndex) const
-{
-    QReadLocker locker(&m_frameCacheLock);
-    auto it = m_frameCache.find(frameIndex);
-    if (it != m_frameCache.end() && it->isReady) {
-        return it->pixmap;
-    }
-    return QPixmap(); // Return null pixmap if not ready
-}
-
-QByteArray ProgressiveFrameLoader::getFrameOriginalData(int frameIndex) const
-{
-    QReadLocker locker(&m_frameCacheLock);
-    auto it = m_frameCache.find(frameIndex);
-    if (it != m_frameCache.end() && it->isReady) {
-        return it->originalData;
-    }
-    return QByteArray(); // Return empty array if not ready
-}
-
 bool ProgressiveFrameLoader::isFrameReady(int frameIndex) const
 {
-    QReadLocker locker(&m_frameCacheLock);
-    auto it = m_frameCache.find(frameIndex);
-    return (it != m_frameCache.end() && it->isReady);
+    return m_frameStore && m_frameStore->contains(frameIndex);
 }
@@ -2,12 +2,19 @@
 
 #include <QtCore/QThread>
 #include <QtCore/QMutex>
-#include <QtGui/QPixmap>
+#include <QtGui/QImage>
 #include <QtCore/QString>
 #include <QtCore/QTimer>
 #include <QtCore/QMap>
-#include <QtCore/QReadWriteLock>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+#include <QtCore/QHash>
 #include "DicomFrameProcessor.h"
+#include "DicomDatasetHandle.h"
+#include "DicomFrameStore.h"
+#include "FramePrefetchScheduler.h"
+#include <memory>
+#include <vector>
 
 #ifdef HAVE_DCMTK
 #include "dcmtk/dcmdata/dcfilefo.h"
@@ -20,18 +27,28 @@ class ProgressiveFrameLoader : public QThread
     Q_OBJECT
 
 public:
-    explicit ProgressiveFrameLoader(const QString& filePath, QObject* parent = nullptr);
+    // The dataset is shared with the viewer so the file is not parsed again here;
+    // decoded frames go into the viewer's frame store
+    ProgressiveFrameLoader(std::shared_ptr<DicomDatasetHandle> dataset,
+                           std::shared_ptr<DicomFrameStore> frameStore, QObject* parent = nullptr);
     ~ProgressiveFrameLoader();
     
     void stop();
     bool isStopped() const;
+    
+    // Frame the viewer is showing or was asked for. The decode window follows it:
+    // frames around it are decoded first, and work for a window left behind by
+    // a jump is dropped.
+    void setPlayhead(int frameIndex);
 
 signals:
     // Emitted when a single frame is ready (lightweight - no data transfer)
     void frameReady(int frameNumber);
     
-    // Emitted when all frames have been loaded
-    void allFramesLoaded(int totalFrames);
+    // Emitted once the first decode window is complete. When the whole run fits
+    // in the frame store budget that is every frame; otherwise the rest is
+    // decoded as the playhead moves. frameReady keeps coming after this.
+    void initialWindowLoaded(int totalFrames);
     
     // Emitted with first frame info for overlay setup
     void firstFrameInfo(QString patientName, QString patientId, int totalFrames);
@@ -43,9 +60,7 @@ signals:
     void loadingProgress(int currentFrame, int totalFrames);
 
 public:
-    // Thread-safe access to cached frames (eliminates signal data transfer)
-    QPixmap getFramePixmap(int frameIndex) const;
-    QByteArray getFrameOriginalData(int frameIndex) const;
+    // True once the frame is in the frame store (it may be evicted again later)
     bool isFrameReady(int frameIndex) const;
 
 protected:
@@ -64,32 +79,36 @@ private:
         unsigned long imageHeight = 0;
     };
     
-    // Frame cache structure for thread-safe access
-    struct FrameData {
-        QPixmap pixmap;
-        QByteArray originalData;
-        bool isReady = false;
+    // Worker output. Native frames only carry pixels; image is the 8-bit
+    // decode for frames without native access.
+    struct DecodedFrame {
+        QImage image;
+        DicomPixelFrame pixels;
     };
     
     // Private methods
     bool loadDicomMetadata();
-    QPixmap processFrame(int frameIndex);
-    QByteArray extractOriginalPixelData(int frameIndex);
-    void cacheFrame(int frameIndex, const QPixmap& pixmap, const QByteArray& originalData);
+    void decodeWorker();
+    void sizeWindowLocked(const DecodedFrame& decoded);
     
     // Member variables
+    std::shared_ptr<DicomDatasetHandle> m_dataset;
+    std::shared_ptr<DicomFrameStore> m_frameStore;
     QString m_filePath;
     mutable QMutex m_mutex;
     bool m_stopped;
     DicomMetadata m_metadata;
     DicomFrameProcessor* m_frameProcessor;  // Use DicomFrameProcessor for GDCM support
     
-    // Thread-safe frame cache (eliminates 350ms signal transfer delay)
-    mutable QReadWriteLock m_frameCacheLock;
-    QMap<int, FrameData> m_frameCache;
-    
-#ifdef HAVE_DCMTK
-    DcmFileFormat* m_dcmFile;
-    DcmDataset* m_dataset;
-#endif
+    // Decode pool - workers take the most urgent frame of the scheduler's window
+    // and hand it to the store as soon as it is decoded. They keep following the
+    // playhead until stop(). Guarded by m_mutex.
+    QThreadPool m_decodePool;
+    FramePrefetchScheduler m_scheduler;
+    QWaitCondition m_workAvailable;             // Playhead moved or stop()
+    QWaitCondition m_windowComplete;            // First window decoded or stop()
+    bool m_windowFilled;
+    bool m_windowSized;                         // Window fitted to the budget from a decoded frame
+    std::vector<bool> m_decodedOnce;
+    int m_decodedCount;
 };
@@ -1,17 +1,18 @@
 #include "thumbnailTask.h"
 #include "dicomviewer.h"
 #include "DicomFrameProcessor.h"
+#include "DicomDatasetHandle.h"
 
 #include <QtCore/QFileInfo>
 #include <QtCore/QFile>
-#include <QtCore/QMutexLocker>
-#include <QtWidgets/QTreeWidgetItem>
 #include <QtGui/QPainter>
 #include <QtGui/QFont>
 #include <QtGui/QFontMetrics>
 
-ThumbnailTask::ThumbnailTask(const QString& filePath, DicomViewer* viewer, QObject* parent)
-    : QObject(parent), QRunnable(), m_filePath(filePath), m_viewer(viewer)
+ThumbnailTask::ThumbnailTask(const QString& filePath, const QString& itemType, bool fileReady,
+                             DicomViewer* viewer, QObject* parent)
+    : QObject(parent), QRunnable(), m_filePath(filePath), m_itemType(itemType)
+    , m_fileReady(fileReady), m_viewer(viewer)
 {
     setAutoDelete(true); // Task will be automatically deleted when finished
 }
@@ -23,7 +24,7 @@ void ThumbnailTask::run()
         QFileInfo fileInfo(m_filePath);
         if (!fileInfo.exists()) {
             logMessage("WARN", QString("Skipping thumbnail generation for missing file: %1").arg(m_filePath));
-            emit taskCompleted(m_filePath, QPixmap(), "1");
+            emit taskCompleted(m_filePath, QImage(), "1", 0);
             return;
         }
         
@@ -31,118 +32,91 @@ void ThumbnailTask::run()
         QFile testFile(m_filePath);
         if (!testFile.open(QIODevice::ReadOnly)) {
             logMessage("WARN", QString("Skipping thumbnail generation for inaccessible file: %1").arg(m_filePath));
-            emit taskCompleted(m_filePath, QPixmap(), "1");
+            emit taskCompleted(m_filePath, QImage(), "1", 0);
             return;
         }
         testFile.close();
         
-        // Check file readiness before processing
-        {
-            if (m_viewer->m_copyInProgress && !QFile::exists(m_filePath)) {
-                logMessage("DEBUG", QString("Skipping file not ready: %1").arg(fileInfo.fileName()));
-                emit taskCompleted(m_filePath, QPixmap(), "1");
-                return;
-            }
-        }
-        
-        // For DVD autorun scenario: Check if file is still being copied
-        QString filename = fileInfo.fileName();
-        bool fileIsCompleted = m_viewer->m_fullyCompletedFiles.contains(filename);
-        
-        if (m_viewer->m_copyInProgress && !fileIsCompleted) {
-            logMessage("DEBUG", QString("Skipping thumbnail generation for file still being copied: %1").arg(filename));
-            emit taskCompleted(m_filePath, QPixmap(), "1");
+        // For DVD autorun scenario: Check if file is still being copied (state captured at submission)
+        if (!m_fileReady) {
+            LOG_AT(LOG_DEBUG, QString("Skipping thumbnail generation for file still being copied: %1").arg(fileInfo.fileName()));
+            emit taskCompleted(m_filePath, QImage(), "1", 0);
             return;
         }
         
         // Generate thumbnail using the viewer's logic
-        QPixmap thumbnail;
+        QImage thumbnail;
         QString instanceNumber = "1";
+        int frameCount = 0;     // 0 = not read
         
-        // Determine item type from tree widget
-        QString itemType = "image"; // Default
-        QTreeWidgetItemIterator it(m_viewer->m_dicomTree);
-        while (*it) {
-            QVariantList userData = (*it)->data(0, Qt::UserRole).toList();
-            if (userData.size() >= 2 && userData[1].toString() == m_filePath) {
-                itemType = userData[0].toString();
-                break;
-            }
-            ++it;
-        }
-        
-        if (itemType == "report") {
+        if (m_itemType == "report") {
             // Generate special thumbnail for reports
             try {
-                thumbnail = m_viewer->createReportThumbnail(m_filePath);
+                thumbnail = DicomViewer::createReportThumbnail(m_filePath);
                 instanceNumber = "RPT";
             } catch (...) {
                 logMessage("ERROR", QString("Error creating report thumbnail for: %1").arg(m_filePath));
-                emit taskCompleted(m_filePath, QPixmap(), "1");
+                emit taskCompleted(m_filePath, QImage(), "1", 0);
                 return;
             }
-        } else if (m_viewer->m_dicomReader) {
-            // Protect all DCMTK operations with mutex
-            QMutexLocker dcmtkLocker(&m_viewer->m_dcmtkAccessMutex);
-            
-            // Generate DICOM thumbnail using viewer's existing logic
-            QPixmap originalPixmap;
+        } else {
+            // Each task parses and decodes on its own - no dataset or lock shared with other tasks or the viewer
+            QImage originalImage;
             try {
-                originalPixmap = m_viewer->convertDicomFrameToPixmap(m_filePath, 0);
+                // Decode frame 0 only as large as the thumbnail needs; the same parse gives the metadata
+                DicomFrameProcessor processor;
+                if (processor.loadDicomFile(DicomDatasetHandle::openPrivate(m_filePath),
+                                            DicomFrameProcessor::LoadScope::FirstFrame)) {
+                    frameCount = static_cast<int>(processor.getNumberOfFrames());
+                    
+                    // Get actual Instance Number from DICOM tag (0020,0013)
+                    QString dicomInstanceNumber = processor.getDicomTagValue("0020,0013");
+                    if (!dicomInstanceNumber.isEmpty()) {
+                        instanceNumber = dicomInstanceNumber;
+                    }
+                    
+                    originalImage = processor.decodeFrameForSize(0, ImageAreaWidth, ImageAreaHeight);
+                }
+                
+                if (originalImage.isNull()) {
+                    originalImage = DicomViewer::convertDicomFrameToImage(m_filePath, 0);
+                }
             } catch (...) {
-                logMessage("ERROR", QString("Error converting DICOM frame to pixmap for: %1").arg(m_filePath));
-                emit taskCompleted(m_filePath, QPixmap(), "1");
+                logMessage("ERROR", QString("Error converting DICOM frame to image for: %1").arg(m_filePath));
+                emit taskCompleted(m_filePath, QImage(), "1", 0);
                 return;
             }
             
-            if (!originalPixmap.isNull()) {
+            if (!originalImage.isNull()) {
                 // Create thumbnail using viewer's existing thumbnail creation logic
-                thumbnail = createDicomThumbnail(originalPixmap, m_filePath, instanceNumber);
+                thumbnail = createDicomThumbnail(originalImage, qMax(frameCount, 1), instanceNumber);
             }
         }
         
         // Emit completion signal
-        emit taskCompleted(m_filePath, thumbnail, instanceNumber);
+        emit taskCompleted(m_filePath, thumbnail, instanceNumber, frameCount);
         
     } catch (const std::exception& e) {
         logMessage("ERROR", QString("Error generating thumbnail for %1: %2").arg(m_filePath).arg(e.what()));
-        emit taskCompleted(m_filePath, QPixmap(), "1");
+        emit taskCompleted(m_filePath, QImage(), "1", 0);
     }
 }
 
-QPixmap ThumbnailTask::createDicomThumbnail(const QPixmap& originalPixmap, const QString& filePath, QString& instanceNumber) 
+QImage ThumbnailTask::createDicomThumbnail(const QImage& originalImage, int frameCount, const QString& instanceNumber) 
 {
     // Scale image to fit the new smaller thumbnail size
-    QPixmap scaledPixmap = originalPixmap.scaled(180, 120, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QImage scaledImage = originalImage.scaled(ImageAreaWidth, ImageAreaHeight, Qt::KeepAspectRatio, Qt::SmoothTransformation);
     
-    QPixmap finalThumbnail(190, 150);
+    QImage finalThumbnail(190, 150, QImage::Format_ARGB32_Premultiplied);
     finalThumbnail.fill(QColor(42, 42, 42));
     
     QPainter painter(&finalThumbnail);
     painter.setRenderHint(QPainter::Antialiasing);
     
     // Center and draw the scaled image
-    QRect imageRect((finalThumbnail.width() - scaledPixmap.width()) / 2, 15,
-                   scaledPixmap.width(), scaledPixmap.height());
-    painter.drawPixmap(imageRect, scaledPixmap);
-    
-    // Extract instance number and frame count from DICOM metadata
-    int frameCount = 1;
-    
-    try {
-        DicomFrameProcessor tempProcessor;
-        if (tempProcessor.loadDicomFile(filePath)) {
-            frameCount = static_cast<int>(tempProcessor.getNumberOfFrames());
-            
-            // Get actual Instance Number from DICOM tag (0020,0013)
-            QString dicomInstanceNumber = tempProcessor.getDicomTagValue("0020,0013");
-            if (!dicomInstanceNumber.isEmpty()) {
-                instanceNumber = dicomInstanceNumber;
-            }
-        }
-    } catch (...) {
-        logMessage("WARN", QString("Error reading DICOM metadata for thumbnail, using defaults: %1").arg(filePath));
-    }
+    QRect imageRect((finalThumbnail.width() - scaledImage.width()) / 2, 15,
+                   scaledImage.width(), scaledImage.height());
+    painter.drawImage(imageRect, scaledImage);
     
     // Create top overlay bar with background
     painter.fillRect(0, 0, finalThumbnail.width(), 20, QColor(0, 0, 0, 180));
@@ -163,20 +137,20 @@ QPixmap ThumbnailTask::createDicomThumbnail(const QPixmap& originalPixmap, const
         ? "DicomViewer_CPP/resources/icons/AcquisitionHeader.png"  // Multi-frame
         : "DicomViewer_CPP/resources/icons/Camera.png";           // Single frame
     
-    QPixmap iconPixmap(iconPath);
-    if (iconPixmap.isNull()) {
+    QImage iconImage(iconPath);
+    if (iconImage.isNull()) {
         // Try absolute path if relative doesn't work
         QString absoluteIconPath = (frameCount > 1) 
             ? "d:/Repos/EikonDicomViewer/DicomViewer_CPP/resources/icons/AcquisitionHeader.png"
             : "d:/Repos/EikonDicomViewer/DicomViewer_CPP/resources/icons/Camera.png";
-        iconPixmap.load(absoluteIconPath);
+        iconImage.load(absoluteIconPath);
     }
     
-    if (!iconPixmap.isNull()) {
+    if (!iconImage.isNull()) {
         // Scale icon to proper size (16x16 for top overlay)
-        QPixmap scaledIcon = iconPixmap.scaled(16, 16, Qt::KeepAspectRatio, Qt::SmoothTransformation);
-        painter.drawPixmap(finalThumbnail.width() - 20, 2, scaledIcon);
-        logMessage("DEBUG", QString("Icon loaded successfully: %1").arg(iconPath));
+        QImage scaledIcon = iconImage.scaled(16, 16, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        painter.drawImage(finalThumbnail.width() - 20, 2, scaledIcon);
+        LOG_AT(LOG_DEBUG, QString("Icon loaded successfully: %1").arg(iconPath));
     } else {
         // Fallback: draw a simple text icon
         painter.setPen(QColor(100, 149, 237));
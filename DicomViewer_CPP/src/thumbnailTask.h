@@ -3,26 +3,42 @@
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
 #include <QtCore/QString>
-#include <QtGui/QPixmap>
+#include <QtGui/QImage>
 
 // Forward declaration
 class DicomViewer;
 
+/**
+ * @brief Builds one thumbnail on a thread-pool thread
+ *
+ * Everything the task needs from the viewer's widgets (item type, copy
+ * state) is captured on the GUI thread when the task is created. Decoding
+ * uses only objects owned by the task, so any number of tasks run in
+ * parallel without a shared lock.
+ */
 class ThumbnailTask : public QObject, public QRunnable
 {
     Q_OBJECT
 
 public:
-    ThumbnailTask(const QString& filePath, DicomViewer* viewer, QObject* parent = nullptr);
+    ThumbnailTask(const QString& filePath, const QString& itemType, bool fileReady,
+                  DicomViewer* viewer, QObject* parent = nullptr);
     void run() override;
 
 signals:
-    void taskCompleted(const QString& filePath, const QPixmap& thumbnail, const QString& instanceNumber);
+    // Thumbnails are QImages: QPixmap may only be used on the GUI thread
+    void taskCompleted(const QString& filePath, const QImage& thumbnail, const QString& instanceNumber, int frameCount);
 
 private:
-    QPixmap createDicomThumbnail(const QPixmap& originalPixmap, const QString& filePath, QString& instanceNumber);
+    // Area the image is fitted into inside the 190x150 thumbnail
+    static constexpr int ImageAreaWidth = 180;
+    static constexpr int ImageAreaHeight = 120;
+
+    QImage createDicomThumbnail(const QImage& originalImage, int frameCount, const QString& instanceNumber);
     void logMessage(const QString& level, const QString& message);
 
     QString m_filePath;
-    DicomViewer* m_viewer;
+    QString m_itemType;     // "image" or "report", from the tree item
+    bool m_fileReady;       // False while the DVD copy has not finished this file
+    DicomViewer* m_viewer;  // Used for logging only
 };
\ No newline at end of file